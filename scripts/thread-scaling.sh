@@ -0,0 +1,94 @@
+#!/usr/bin/env bash
+# -*- coding: utf-8 -*-
+
+# Thread scaling report of the MIP solver.
+# Solves each of the given instances with 1, 2, 4, ... threads, up to the
+# number of cores of the machine, and reports the wall clock time, the speedup
+# and the parallel efficiency w.r.t. the single thread run.
+#
+# Usage: ./scripts/thread-scaling.sh [-t TIMELIMIT] [-s SEED] INSTANCE...
+#        Additional solver params can be passed through the CPTP_DEFINES
+#        environment variable, eg CPTP_DEFINES="-DGSEC_CUTS=1"
+
+cd "$(dirname "$0")" || exit 1
+cd .. || exit 1
+
+echoerr() { echo "$@" 1>&2; }
+
+cptp_debug="./build/Debug/src/cptp"
+cptp_release="./build/Release/src/cptp"
+
+cptp="$cptp_debug"
+
+if [ -f "$cptp_release" ]; then
+    cptp="$cptp_release"
+fi
+
+if [ ! -f "$cptp" ]; then
+    echoerr "cptp executable does not exist. Make sure to build the project first"
+    exit 1
+fi
+
+timelimit=600
+seed=1
+
+while getopts "t:s:" opt; do
+    case "$opt" in
+    t) timelimit="$OPTARG" ;;
+    s) seed="$OPTARG" ;;
+    *) exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+if [ "$#" -eq 0 ]; then
+    echoerr "Usage: $0 [-t TIMELIMIT] [-s SEED] INSTANCE..."
+    exit 1
+fi
+
+num_cores="$(nproc)"
+threads=()
+for ((k = 1; k < num_cores; k *= 2)); do
+    threads+=("$k")
+done
+threads+=("$num_cores")
+
+report_dir="$(mktemp -d)"
+trap 'rm -rf "$report_dir"' EXIT
+
+printf "%-40s %8s %12s %8s %8s %14s %14s\n" "instance" "threads" "time" \
+    "speedup" "eff" "primal" "dual"
+
+for instance in "$@"; do
+    base_time=""
+    for k in "${threads[@]}"; do
+        report="$report_dir/report-$k.json"
+        # shellcheck disable=SC2086
+        "$cptp" -i "$instance" -t "$timelimit" -s "$seed" \
+            -DNUM_THREADS="$k" $CPTP_DEFINES -w "$report" >/dev/null 2>&1
+
+        if [ ! -f "$report" ]; then
+            echoerr "$instance: solver failed with $k threads"
+            continue
+        fi
+
+        read -r took primal dual < <(python3 -c '
+import json, sys
+r = json.load(open(sys.argv[1]))
+print(r["timingInfo"]["took"], r["bounds"]["primal"], r["bounds"]["dual"])
+' "$report")
+
+        if [ -z "$base_time" ]; then
+            base_time="$took"
+        fi
+
+        python3 -c '
+import sys
+name, k, took, base, primal, dual = sys.argv[1:]
+speedup = float(base) / max(float(took), 1e-9)
+print("%-40s %8s %12.3f %8.2f %8.2f %14s %14s" % (
+    name[-40:], k, float(took), speedup, speedup / int(k), primal, dual))
+' "$(basename "$instance")" "$k" "$took" "$base_time" "$primal" "$dual"
+        rm -f "$report"
+    done
+done
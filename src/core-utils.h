@@ -34,11 +34,18 @@ bool solver_params_get_bool(SolverTypedParams *params, char *key);
 int32_t solver_params_get_int32(SolverTypedParams *params, char *key);
 double solver_params_get_double(SolverTypedParams *params, char *key);
 
-static inline int64_t hm_nentries(int32_t n) { return ((n * n) - n) / 2; }
+// NOTE(dparo):
+//      The products are carried out in 64 bit arithmetic: n * n overflows an
+//      int32_t as soon as n > 46340.
+static inline int64_t hm_nentries(int32_t n) {
+    return (((int64_t)n * (int64_t)n) - n) / 2;
+}
 
 // Number of entries in a full matrix of size `N x N`
 // Eg N**2 - num_entries(diagonal)
-static inline int64_t fm_nentries(int32_t n) { return (n * n) - n; }
+static inline int64_t fm_nentries(int32_t n) {
+    return ((int64_t)n * (int64_t)n) - n;
+}
 
 static inline int64_t sxpos(int32_t n, int32_t i, int32_t j) {
     assert(i != j);
@@ -46,7 +53,8 @@ static inline int64_t sxpos(int32_t n, int32_t i, int32_t j) {
     int32_t l = MIN(i, j);
     int32_t u = MAX(i, j);
 
-    int64_t result = l * n + u - ((l + 1) * (l + 2)) / 2;
+    int64_t result =
+        (int64_t)l * n + u - (((int64_t)l + 1) * ((int64_t)l + 2)) / 2;
     return result;
 }
 
@@ -92,18 +92,47 @@ Solution solution_create(const Instance *instance) {
     Solution solution = {0};
     solution.primal_bound = 0;
     solution.dual_bound = -INFINITY;
+    solution.det_ticks = -1.0;
     solution.tour = tour_create(instance);
     return solution;
 }
 
+static void solution_destroy_tours(Solution *solution) {
+    for (ptrdiff_t i = 0; i < arrlen(solution->tours); i++) {
+        tour_destroy(&solution->tours[i]);
+    }
+    arrfree(solution->tours);
+    arrfree(solution->tours_cost);
+}
+
+static void solution_destroy_relaxation(Solution *solution) {
+    arrfree(solution->relaxation.round_bounds);
+    arrfree(solution->relaxation.node_values);
+    arrfree(solution->relaxation.edge_values);
+}
+
+/// Destroys the collected `tours` of the solution, keeping their storage
+void solution_clear_tours(Solution *solution) {
+    for (ptrdiff_t i = 0; i < arrlen(solution->tours); i++) {
+        tour_destroy(&solution->tours[i]);
+    }
+    arrsetlen(solution->tours, 0);
+    arrsetlen(solution->tours_cost, 0);
+}
+
 void solution_clear(Solution *solution) {
     solution->dual_bound = INFINITY;
     solution->primal_bound = 0;
+    solution->det_ticks = -1.0;
     tour_clear(&solution->tour);
+    solution_destroy_tours(solution);
+    solution_destroy_relaxation(solution);
 }
 
 void solution_destroy(Solution *solution) {
     tour_destroy(&solution->tour);
+    solution_destroy_tours(solution);
+    solution_destroy_relaxation(solution);
     memset(solution, 0, sizeof(*solution));
 }
 
@@ -117,6 +146,15 @@ Tour tour_copy(Tour const *other) {
     return result;
 }
 
+/// Copies `src` into the already allocated `dest`, for the same instance
+void tour_copy_into(Tour *dest, const Tour *src) {
+    assert(dest->num_customers == src->num_customers);
+    const int32_t n = src->num_customers + 1;
+    memcpy(dest->succ, src->succ, n * sizeof(*dest->succ));
+    memcpy(dest->comp, src->comp, n * sizeof(*dest->comp));
+    dest->num_comps = src->num_comps;
+}
+
 Tour tour_move(Tour *other) {
     Tour result = {0};
     memcpy(&result, other, sizeof(result));
@@ -124,6 +162,66 @@ Tour tour_move(Tour *other) {
     return result;
 }
 
+/// Returns true if the two tours visit the same nodes using the same edges,
+/// regardless of the direction in which the edges are traversed.
+bool tour_same_route(const Tour *a, const Tour *b) {
+    assert(a->num_customers == b->num_customers);
+    const int32_t n = a->num_customers + 1;
+
+    for (int32_t i = 0; i < n; i++) {
+        bool a_visits_i = a->comp[i] >= 0;
+        bool b_visits_i = b->comp[i] >= 0;
+        if (a_visits_i != b_visits_i) {
+            return false;
+        }
+        if (a_visits_i) {
+            int32_t j = a->succ[i];
+            if (b->succ[i] != j && b->succ[j] != i) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// Keeps in the `tours` of the solution (sorted by increasing cost) the `k`
+/// best distinct negative cost tours seen so far.
+void solution_collect_tour(Solution *solution, int32_t k, const Tour *tour,
+                           double cost) {
+    if (k <= 0 || !is_valid_reduced_cost(cost)) {
+        return;
+    }
+
+    ptrdiff_t len = arrlen(solution->tours);
+    if (len >= k && !(cost < solution->tours_cost[len - 1])) {
+        return;
+    }
+    for (ptrdiff_t i = 0; i < len; i++) {
+        if (tour_same_route(&solution->tours[i], tour)) {
+            return;
+        }
+    }
+
+    if (len >= k) {
+        // Evict the worst tour
+        tour_destroy(&solution->tours[len - 1]);
+        arrsetlen(solution->tours, len - 1);
+        arrsetlen(solution->tours_cost, len - 1);
+        --len;
+    }
+
+    // Insertion sort by increasing cost
+    arrput(solution->tours, tour_copy(tour));
+    arrput(solution->tours_cost, cost);
+    for (ptrdiff_t i = len; i > 0; i--) {
+        if (solution->tours_cost[i - 1] <= solution->tours_cost[i]) {
+            break;
+        }
+        SWAP(Tour, solution->tours[i - 1], solution->tours[i]);
+        SWAP(double, solution->tours_cost[i - 1], solution->tours_cost[i]);
+    }
+}
+
 typedef Solver (*SolverCreateFn)(const Instance *instance,
                                  SolverTypedParams *tparams, double timelimit,
                                  int32_t randomseed);
@@ -133,6 +231,9 @@ static const struct SolverLookup {
     SolverCreateFn create_fn;
 } SOLVERS_REGISTRY[] = {
     {&STUB_SOLVER_DESCRIPTOR, &stub_solver_create},
+    {&ILS_SOLVER_DESCRIPTOR, &ils_solver_create},
+    {&DP_SOLVER_DESCRIPTOR, &dp_solver_create},
+    {&HGS_SOLVER_DESCRIPTOR, &hgs_solver_create},
 #if COMPILED_WITH_CPLEX
     {&MIP_SOLVER_DESCRIPTOR, &mip_solver_create},
 #endif
@@ -433,66 +534,90 @@ static void cptp_sighandler(int signum) {
     }
 }
 
-SolveStatus cptp_solve(const Instance *instance, const char *solver_name,
-                       const SolverParams *params, Solution *solution,
-                       double timelimit, int32_t randomseed) {
+/// Runs the solver with the SIGTERM/SIGINT handlers installed.
+static SolveStatus run_solver(Solver *solver, const Instance *instance,
+                              Solution *solution) {
     SolveStatus status = SOLVE_STATUS_NULL;
+
+    solver->sigterm_occured = false;
+    solver->sigterm_occured_int = 0;
+
+    // Setup signals
+    sighandler_ctx_solver_ptr = solver;
+    sighandler_t prev_sigterm_handler = signal(SIGTERM, cptp_sighandler);
+    sighandler_t prev_sigint_handler = signal(SIGINT, cptp_sighandler);
+    {
+        int64_t begin_time = os_get_usecs();
+        status = solver->solve(solver, instance, solution, begin_time);
+    }
+    // Resets the signals
+    signal(SIGTERM, prev_sigterm_handler);
+    signal(SIGINT, prev_sigint_handler);
+    sighandler_ctx_solver_ptr = NULL;
+
+    if (solver->sigterm_occured) {
+        status |= SOLVE_STATUS_ABORTION_SIGTERM;
+    }
+
+    return status;
+}
+
+/// Looks up the solver, seeds the RNG and resolves the params. Common
+/// prologue of cptp_solve() and cptp_session_create().
+static const SolverLookup *prepare_solver(const char *solver_name,
+                                          const SolverParams *params,
+                                          double timelimit,
+                                          int32_t *randomseed,
+                                          SolverTypedParams *tparams) {
     const SolverLookup *lookup = lookup_solver(solver_name);
 
     if (lookup == NULL) {
         log_fatal("%s :: `%s` is not a know solver", __func__, solver_name);
-        goto fail;
+        return NULL;
     } else {
         log_info("%s :: Found descriptor for solver `%s`", __func__,
                  solver_name);
     }
 
-    if (randomseed == 0) {
-        randomseed = (int32_t)(time(NULL) % INT32_MAX);
+    if (*randomseed == 0) {
+        *randomseed = (int32_t)(time(NULL) % INT32_MAX);
     }
 
-    printf("%s :: Setting seed = %d\n", __func__, randomseed);
-    srand(randomseed);
+    printf("%s :: Setting seed = %d\n", __func__, *randomseed);
+    srand(*randomseed);
 
     printf("%s :: Setting timelimit = %f\n", __func__, timelimit);
 
     if (!verify_solver_params(lookup->descriptor, params)) {
         fprintf(stderr, "ERROR: %s :: Failed to verify params\n", __func__);
-        goto fail;
+        return NULL;
     }
 
-    SolverTypedParams tparams = {0};
-
-    if (!resolve_params(params, lookup->descriptor, &tparams)) {
+    if (!resolve_params(params, lookup->descriptor, tparams)) {
         fprintf(stderr, "ERROR: %s :: Failed to resolve parameters\n",
                 __func__);
+        return NULL;
+    }
+
+    return lookup;
+}
+
+SolveStatus cptp_solve(const Instance *instance, const char *solver_name,
+                       const SolverParams *params, Solution *solution,
+                       double timelimit, int32_t randomseed) {
+    SolveStatus status = SOLVE_STATUS_NULL;
+    SolverTypedParams tparams = {0};
+
+    const SolverLookup *lookup =
+        prepare_solver(solver_name, params, timelimit, &randomseed, &tparams);
+    if (!lookup) {
         goto fail;
     }
 
     Solver solver =
         lookup->create_fn(instance, &tparams, timelimit, randomseed);
 
-    {
-        solver.sigterm_occured = false;
-        solver.sigterm_occured_int = 0;
-
-        // Setup signals
-        sighandler_ctx_solver_ptr = &solver;
-        sighandler_t prev_sigterm_handler = signal(SIGTERM, cptp_sighandler);
-        sighandler_t prev_sigint_handler = signal(SIGINT, cptp_sighandler);
-        {
-            int64_t begin_time = os_get_usecs();
-            status = solver.solve(&solver, instance, solution, begin_time);
-        }
-        // Resets the signals
-        signal(SIGTERM, prev_sigterm_handler);
-        signal(SIGINT, prev_sigint_handler);
-        sighandler_ctx_solver_ptr = NULL;
-    }
-
-    if (solver.sigterm_occured) {
-        status |= SOLVE_STATUS_ABORTION_SIGTERM;
-    }
+    status = run_solver(&solver, instance, solution);
 
     solver.destroy(&solver);
     log_solve_status(status, solver_name);
@@ -505,6 +630,184 @@ fail:
     return status;
 }
 
+struct CptpSession {
+    const SolverLookup *lookup;
+    SolverTypedParams tparams;
+    /// Private copy of the instance. Only its profits change over time
+    Instance instance;
+    Solver solver;
+    double timelimit;
+    int32_t randomseed;
+    /// The solver must be recreated before the next solve, since it does not
+    /// support profit updates (see Solver::update_profits)
+    bool stale;
+    /// Edge fixings currently applied, in the order they were pushed. (stb_ds
+    /// array)
+    EdgeFix *edge_fixings;
+};
+
+static bool session_apply_edge_fixings(CptpSession *session) {
+    if (!session->solver.set_edge_fixings) {
+        log_fatal("%s :: Solver `%s` does not support edge fixings", __func__,
+                  session->lookup->descriptor->name);
+        return false;
+    }
+
+    return session->solver.set_edge_fixings(
+        &session->solver, &session->instance, session->edge_fixings,
+        (int32_t)arrlen(session->edge_fixings));
+}
+
+static bool session_create_solver(CptpSession *session) {
+    session->solver =
+        session->lookup->create_fn(&session->instance, &session->tparams,
+                                   session->timelimit, session->randomseed);
+    session->solver.persistent = true;
+    session->stale = false;
+    if (!session->solver.solve) {
+        return false;
+    }
+
+    return arrlen(session->edge_fixings) == 0 ||
+           session_apply_edge_fixings(session);
+}
+
+CptpSession *cptp_session_create(const Instance *instance,
+                                 const char *solver_name,
+                                 const SolverParams *params, double timelimit,
+                                 int32_t randomseed) {
+    CptpSession *session = calloc(1, sizeof(*session));
+    if (!session) {
+        return NULL;
+    }
+
+    session->lookup = prepare_solver(solver_name, params, timelimit,
+                                     &randomseed, &session->tparams);
+    if (!session->lookup) {
+        goto fail;
+    }
+
+    session->instance = instance_copy(instance, true, true);
+    session->timelimit = timelimit;
+    session->randomseed = randomseed;
+
+    if (!session_create_solver(session)) {
+        log_fatal("%s :: Failed to create solver `%s`", __func__, solver_name);
+        goto fail;
+    }
+
+    return session;
+
+fail:
+    cptp_session_destroy(session);
+    return NULL;
+}
+
+bool cptp_session_update_profits(CptpSession *session, const double *profits) {
+    const int32_t n = session->instance.num_customers + 1;
+    memcpy(session->instance.profits, profits,
+           n * sizeof(*session->instance.profits));
+
+    if (session->stale || !session->solver.update_profits) {
+        session->stale = true;
+        return true;
+    }
+
+    if (!session->solver.update_profits(&session->solver,
+                                        &session->instance)) {
+        log_warn("%s :: Failed to update the profits. Recreating the solver",
+                 __func__);
+        session->stale = true;
+    }
+
+    return true;
+}
+
+/// Fixes the edge (i, j) on top of the current fixings. The fixings are
+/// undone in reverse order by cptp_session_pop_edge_fixing(), as the branching
+/// decisions of a depth first branch and price tree.
+bool cptp_session_push_edge_fixing(CptpSession *session, int32_t i, int32_t j,
+                                   EdgeFixing fixing) {
+    const int32_t n = session->instance.num_customers + 1;
+    if (i < 0 || i >= n || j < 0 || j >= n || i == j ||
+        fixing == EDGE_FIXING_NONE) {
+        log_fatal("%s :: Invalid edge fixing (%d, %d) = %d", __func__, i, j,
+                  fixing);
+        return false;
+    }
+
+    EdgeFix fix = {i, j, fixing};
+    arrput(session->edge_fixings, fix);
+
+    if (session->stale) {
+        // NOTE(dparo): Applied once the solver is recreated
+        return true;
+    }
+
+    if (!session_apply_edge_fixings(session)) {
+        arrsetlen(session->edge_fixings, arrlen(session->edge_fixings) - 1);
+        return false;
+    }
+    return true;
+}
+
+/// Undoes the last fixing pushed with cptp_session_push_edge_fixing()
+bool cptp_session_pop_edge_fixing(CptpSession *session) {
+    if (arrlen(session->edge_fixings) == 0) {
+        log_fatal("%s :: No edge fixing to undo", __func__);
+        return false;
+    }
+
+    arrsetlen(session->edge_fixings, arrlen(session->edge_fixings) - 1);
+
+    if (session->stale) {
+        return true;
+    }
+
+    if (!session_apply_edge_fixings(session)) {
+        log_warn("%s :: Failed to undo the edge fixing. Recreating the solver",
+                 __func__);
+        session->stale = true;
+    }
+    return true;
+}
+
+SolveStatus cptp_session_solve(CptpSession *session, Solution *solution) {
+    if (session->stale) {
+        session->solver.destroy(&session->solver);
+        if (!session_create_solver(session)) {
+            log_fatal("%s :: Failed to recreate the solver", __func__);
+            solution_clear(solution);
+            return SOLVE_STATUS_ERR;
+        }
+    }
+
+    SolveStatus status =
+        run_solver(&session->solver, &session->instance, solution);
+
+    log_solve_status(status, session->lookup->descriptor->name);
+    postprocess_solver_solution(&session->instance, status, solution);
+    return status;
+}
+
+const Instance *cptp_session_instance(const CptpSession *session) {
+    return &session->instance;
+}
+
+void cptp_session_destroy(CptpSession *session) {
+    if (!session) {
+        return;
+    }
+
+    if (session->solver.destroy) {
+        session->solver.destroy(&session->solver);
+    }
+    instance_destroy(&session->instance);
+    solver_typed_params_destroy(&session->tparams);
+    arrfree(session->edge_fixings);
+    free(session);
+}
+
 static inline TypedParam *solver_params_get_key(SolverTypedParams *params,
                                                 char *key) {
     SolverTypedParamsEntry *entry = shgetp_null(params->entries, key);
@@ -582,8 +885,8 @@ Instance instance_copy(const Instance *instance, bool allocate,
         result.demands = malloc(n * sizeof(*result.demands));
         result.positions = malloc(n * sizeof(*result.positions));
 
-        result.name = strdup(instance->name);
-        result.comment = strdup(instance->comment);
+        result.name = instance->name ? strdup(instance->name) : NULL;
+        result.comment = instance->comment ? strdup(instance->comment) : NULL;
     }
 
     if (deep_copy) {
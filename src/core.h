@@ -63,10 +63,53 @@ typedef struct Tour {
     int32_t *comp;
 } Tour;
 
+typedef struct EdgeValue {
+    int32_t i, j;
+    double value;
+} EdgeValue;
+
+/// Branching decision of a branch and price master on the edge (i, j). See
+/// cptp_session_push_edge_fixing().
+typedef enum EdgeFixing {
+    EDGE_FIXING_NONE = 0,
+    /// The edge cannot be part of the tour
+    EDGE_FIXING_FORBIDDEN = 1,
+    /// The edge must be part of the tour
+    EDGE_FIXING_FORCED = 2,
+} EdgeFixing;
+
+typedef struct EdgeFix {
+    int32_t i, j;
+    EdgeFixing fixing;
+} EdgeFix;
+
 typedef struct Solution {
     double primal_bound;
     double dual_bound;
     Tour tour;
+
+    /// Additional distinct tours returned by the solver, sorted by
+    /// increasing cost, together with their costs. For example the negative
+    /// reduced cost tours collected by the MIP solver in pricer mode (see the
+    /// `PRICER_NUM_TOURS` param). (stb_ds arrays)
+    Tour *tours;
+    double *tours_cost;
+
+    /// Outcome of a relaxation only solve (eg the `LP_BOUND_MODE` of the MIP
+    /// solver): the bound reached after each cutting plane round, and the
+    /// final fractional point as node (Y) values and nonzero edge (X) values.
+    /// (stb_ds arrays)
+    struct {
+        double *round_bounds;
+        double *node_values;
+        EdgeValue *edge_values;
+    } relaxation;
+
+    /// Deterministic work spent by the solve, in CPLEX ticks (see the
+    /// `DET_TIMELIMIT` param of the MIP solver). Unlike the wall clock time it
+    /// does not depend on the load of the machine. Negative when the solver
+    /// does not measure it.
+    double det_ticks;
 } Solution;
 
 typedef struct SolverData SolverData;
@@ -108,20 +151,40 @@ typedef enum SolveStatus {
     SOLVE_STATUS_PRIMAL_SOLUTION_AVAIL = (1 << 2),
     SOLVE_STATUS_ABORTION_RES_EXHAUSTED = (1 << 3),
     SOLVE_STATUS_ABORTION_SIGTERM = (1 << 4),
+    /// Only a relaxation was solved: the dual bound is valid, but the problem
+    /// is not closed (see Solution::relaxation)
+    SOLVE_STATUS_RELAXATION_ONLY = (1 << 5),
 } SolveStatus;
 
 typedef struct Solver {
     SolverData *data;
     volatile bool sigterm_occured;
     volatile int sigterm_occured_int;
+    /// Set when the solver is owned by a CptpSession, and therefore is
+    /// going to be solved multiple times. (See cptp_session_create())
+    bool persistent;
 
     // TODO: set_params
     bool (*set_params)(struct Solver *self, const SolverParams *params);
     SolveStatus (*solve)(struct Solver *self, const Instance *instance,
                          Solution *solution, int64_t begin_time);
+    /// Optional. Notifies the solver that the profits of the instance changed
+    /// since the last solve, the rest of the instance being the same. Solvers
+    /// not implementing it are recreated from scratch.
+    bool (*update_profits)(struct Solver *self, const Instance *instance);
+    /// Optional. Replaces the edge fixings applied to the model with the
+    /// `num_fixings` ones listed in `fixings` (an empty list removes them
+    /// all), the instance being the same.
+    bool (*set_edge_fixings)(struct Solver *self, const Instance *instance,
+                             const EdgeFix *fixings, int32_t num_fixings);
     void (*destroy)(struct Solver *self);
 } Solver;
 
+/// A solver kept alive across multiple solves of the same instance, where
+/// only the profits change between one solve and the next one (eg the pricing
+/// problem of a column generation scheme).
+typedef struct CptpSession CptpSession;
+
 void instance_set_name(Instance *instance, const char *name);
 void instance_destroy(Instance *instance);
 
@@ -130,11 +193,16 @@ void tour_destroy(Tour *tour);
 void tour_clear(Tour *tour);
 bool tour_is_valid(Tour *tour);
 Tour tour_copy(Tour const *other);
+void tour_copy_into(Tour *dest, const Tour *src);
 Tour tour_move(Tour *other);
+bool tour_same_route(const Tour *a, const Tour *b);
 
 Solution solution_create(const Instance *instance);
 void solution_destroy(Solution *solution);
 void solution_clear(Solution *solution);
+void solution_clear_tours(Solution *solution);
+void solution_collect_tour(Solution *solution, int32_t k, const Tour *tour,
+                           double cost);
 
 void solver_typed_params_destroy(SolverTypedParams *params);
 bool resolve_params(const SolverParams *params, const SolverDescriptor *desc,
@@ -148,6 +216,18 @@ SolveStatus cptp_solve(const Instance *instance, const char *solver_name,
 
 void cptp_print_list_of_solvers_and_params(void);
 
+CptpSession *cptp_session_create(const Instance *instance,
+                                 const char *solver_name,
+                                 const SolverParams *params, double timelimit,
+                                 int32_t randomseed);
+bool cptp_session_update_profits(CptpSession *session, const double *profits);
+bool cptp_session_push_edge_fixing(CptpSession *session, int32_t i, int32_t j,
+                                   EdgeFixing fixing);
+bool cptp_session_pop_edge_fixing(CptpSession *session);
+SolveStatus cptp_session_solve(CptpSession *session, Solution *solution);
+const Instance *cptp_session_instance(const CptpSession *session);
+void cptp_session_destroy(CptpSession *session);
+
 static inline double get_reduced_cost_upper_bound(void) {
     return 0.0 - COST_TOLERANCE;
 }
@@ -0,0 +1,1326 @@
+/*
+ * Copyright (c) 2022 Davide Paro
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "local-search.h"
+#include "core-utils.h"
+
+typedef struct {
+    int32_t node;
+    double score;
+} ScoredNode;
+
+static int cmp_scored_node_desc(const void *a, const void *b) {
+    const ScoredNode *sa = a;
+    const ScoredNode *sb = b;
+    if (sa->score > sb->score) {
+        return -1;
+    } else if (sa->score < sb->score) {
+        return 1;
+    }
+    return sa->node - sb->node;
+}
+
+/// Travel cost change of inserting `h` in between the consecutive `a` and
+/// `b`. When the tour visits the depot only, `a == b == 0`.
+static inline double insertion_cost(const Instance *instance, int32_t a,
+                                    int32_t h, int32_t b) {
+    double c_ab = a == b ? 0.0 : cptp_dist(instance, a, b);
+    return cptp_dist(instance, a, h) + cptp_dist(instance, h, b) - c_ab;
+}
+
+static inline bool is_visited(const Tour *tour, int32_t i) {
+    return tour->comp[i] == 0;
+}
+
+/// Cheapest position for inserting `h`. Returns the best predecessor `a`.
+static int32_t cheapest_insertion(const Instance *instance, const Tour *tour,
+                                  int32_t h, double *cost) {
+    const int32_t n = instance->num_customers + 1;
+    int32_t best_a = -1;
+    *cost = INFINITY;
+    for (int32_t a = 0; a < n; a++) {
+        if (!is_visited(tour, a)) {
+            continue;
+        }
+        double c = insertion_cost(instance, a, h, tour->succ[a]);
+        if (c < *cost) {
+            *cost = c;
+            best_a = a;
+        }
+    }
+    return best_a;
+}
+
+static inline void insert_after(Tour *tour, int32_t a, int32_t h) {
+    tour->comp[h] = 0;
+    tour->succ[h] = tour->succ[a];
+    tour->succ[a] = h;
+}
+
+void ls_build_tour_from_scores(const Instance *instance, Tour *tour,
+                               const double *score, double threshold) {
+    const int32_t n = instance->num_customers + 1;
+    const double Q = instance->vehicle_cap;
+
+    tour_clear(tour);
+    tour->num_comps = 1;
+    tour->comp[0] = 0;
+    tour->succ[0] = 0;
+
+    ScoredNode *nodes = malloc(n * sizeof(*nodes));
+    if (!nodes) {
+        return;
+    }
+
+    int32_t num_nodes = 0;
+    for (int32_t i = 1; i < n; i++) {
+        if (score[i] >= threshold) {
+            nodes[num_nodes].node = i;
+            nodes[num_nodes].score = score[i];
+            ++num_nodes;
+        }
+    }
+
+    qsort(nodes, num_nodes, sizeof(*nodes), cmp_scored_node_desc);
+
+    double sum_demands = instance->demands[0];
+    for (int32_t k = 0; k < num_nodes; k++) {
+        int32_t h = nodes[k].node;
+        if (sum_demands + instance->demands[h] > Q) {
+            continue;
+        }
+        double cost;
+        int32_t a = cheapest_insertion(instance, tour, h, &cost);
+        assert(a >= 0);
+        insert_after(tour, a, h);
+        sum_demands += instance->demands[h];
+    }
+
+    free(nodes);
+}
+
+/// Reverses the path from `succ(a)` to `b`, such that `a` is followed by `b`
+/// and `succ(a)` by the old `succ(b)`.
+static void twoopt_move(Tour *tour, int32_t a, int32_t b) {
+    int32_t succ_a = tour->succ[a];
+    int32_t succ_b = tour->succ[b];
+
+    int32_t prev = succ_a;
+    int32_t current = tour->succ[succ_a];
+    while (current != succ_b) {
+        int32_t next = tour->succ[current];
+        tour->succ[current] = prev;
+        prev = current;
+        current = next;
+    }
+
+    tour->succ[a] = b;
+    tour->succ[succ_a] = succ_b;
+}
+
+double ls_twoopt(const Instance *instance, Tour *tour) {
+    const int32_t n = instance->num_customers + 1;
+    double total_delta = 0.0;
+
+    while (true) {
+        double best_delta = -COST_TOLERANCE;
+        int32_t best_a = -1;
+        int32_t best_b = -1;
+
+        for (int32_t a = 0; a < n; a++) {
+            if (!is_visited(tour, a)) {
+                continue;
+            }
+            int32_t succ_a = tour->succ[a];
+            for (int32_t b = 0; b < n; b++) {
+                int32_t succ_b = tour->succ[b];
+                if (a == b || !is_visited(tour, b) || succ_a == b ||
+                    succ_b == a) {
+                    continue;
+                }
+
+                double delta = cptp_dist(instance, a, b) +
+                               cptp_dist(instance, succ_a, succ_b) -
+                               cptp_dist(instance, a, succ_a) -
+                               cptp_dist(instance, b, succ_b);
+                if (delta < best_delta) {
+                    best_delta = delta;
+                    best_a = a;
+                    best_b = b;
+                }
+            }
+        }
+
+        if (best_a < 0) {
+            break;
+        }
+
+        twoopt_move(tour, best_a, best_b);
+        total_delta += best_delta;
+    }
+
+    return total_delta;
+}
+
+/// Candidate lists of the `k` nearest nodes, among the given `nodes`, of
+/// each node in `nodes`. The lists of the other nodes are left untouched.
+static bool neighbor_lists_build(LsNeighborLists *nl, const Instance *instance,
+                                 int32_t k, const int32_t *nodes,
+                                 int32_t num_nodes) {
+    const int32_t n = instance->num_customers + 1;
+    nl->k = MAX(0, MIN(k, num_nodes - 1));
+    nl->nodes = malloc((size_t)n * MAX(1, nl->k) * sizeof(*nl->nodes));
+    double *dist = malloc(MAX(1, nl->k) * sizeof(*dist));
+
+    if (!nl->nodes || !dist) {
+        free(dist);
+        ls_neighbor_lists_destroy(nl);
+        return false;
+    }
+
+    // NOTE(dparo):
+    //      Bounded insertion sort: only the k nearest nodes are kept, which
+    //      makes the construction O(n^2) in practice for small k.
+    for (int32_t u = 0; u < num_nodes; u++) {
+        const int32_t i = nodes ? nodes[u] : u;
+        int32_t *list = &nl->nodes[(size_t)i * nl->k];
+        int32_t cnt = 0;
+        for (int32_t v = 0; v < num_nodes; v++) {
+            const int32_t j = nodes ? nodes[v] : v;
+            if (i == j) {
+                continue;
+            }
+            double d = cptp_dist(instance, i, j);
+            if (cnt == nl->k && (cnt == 0 || d >= dist[cnt - 1])) {
+                continue;
+            }
+            int32_t r = cnt < nl->k ? cnt++ : cnt - 1;
+            while (r > 0 && dist[r - 1] > d) {
+                dist[r] = dist[r - 1];
+                list[r] = list[r - 1];
+                --r;
+            }
+            dist[r] = d;
+            list[r] = j;
+        }
+    }
+
+    free(dist);
+    return true;
+}
+
+bool ls_neighbor_lists_create(LsNeighborLists *nl, const Instance *instance,
+                              int32_t k) {
+    return neighbor_lists_build(nl, instance, k, NULL,
+                                instance->num_customers + 1);
+}
+
+void ls_neighbor_lists_destroy(LsNeighborLists *nl) {
+    free(nl->nodes);
+    nl->nodes = NULL;
+    nl->k = 0;
+}
+
+/// Array representation of a tour: the visited nodes are stored in visiting
+/// order in `order`, and `pos` maps each node to its position (-1 when not
+/// visited). Successor, predecessor and between queries are O(1).
+typedef struct {
+    int32_t m;
+    int32_t *order;
+    int32_t *pos;
+} ArrayTour;
+
+static inline int32_t at_succ(const ArrayTour *t, int32_t v) {
+    int32_t i = t->pos[v] + 1;
+    return t->order[i == t->m ? 0 : i];
+}
+
+static inline int32_t at_pred(const ArrayTour *t, int32_t v) {
+    int32_t i = t->pos[v];
+    return t->order[i == 0 ? t->m - 1 : i - 1];
+}
+
+/// Whether `c` lies on the path going from `a` to `b`
+static inline bool at_between(const ArrayTour *t, int32_t a, int32_t b,
+                              int32_t c) {
+    int32_t pa = t->pos[a];
+    int32_t ab = t->pos[b] - pa;
+    int32_t ac = t->pos[c] - pa;
+    return (ac < 0 ? ac + t->m : ac) <= (ab < 0 ? ab + t->m : ab);
+}
+
+/// Reverses the path from `a` to `b`
+static void at_reverse(ArrayTour *t, int32_t a, int32_t b) {
+    int32_t i = t->pos[a];
+    int32_t j = t->pos[b];
+    int32_t len = j - i;
+    len = (len < 0 ? len + t->m : len) + 1;
+
+    for (int32_t s = 0; s < len / 2; s++) {
+        int32_t u = t->order[i];
+        int32_t v = t->order[j];
+        t->order[i] = v;
+        t->pos[v] = i;
+        t->order[j] = u;
+        t->pos[u] = j;
+        i = i + 1 == t->m ? 0 : i + 1;
+        j = j == 0 ? t->m - 1 : j - 1;
+    }
+}
+
+/// Replaces the edges (a, succ(a)) and (b, succ(b)) with (a, b) and
+/// (succ(a), succ(b)). Reversing either of the two paths yields the same
+/// tour (up to its orientation): the shorter one is reversed.
+static void at_twoopt(ArrayTour *t, int32_t a, int32_t b) {
+    int32_t succ_a = at_succ(t, a);
+    int32_t succ_b = at_succ(t, b);
+    int32_t len = t->pos[b] - t->pos[succ_a];
+    len = (len < 0 ? len + t->m : len) + 1;
+
+    if (2 * len <= t->m) {
+        at_reverse(t, succ_a, b);
+    } else {
+        at_reverse(t, succ_b, a);
+    }
+}
+
+/// Replaces the edges {x1, y1} and {x2, y2} with {x1, x2} and {y1, y2},
+/// regardless of the current orientation of the tour. Both edges must be
+/// traversed in the same direction, as in (x1 -> y1, x2 -> y2).
+static void at_twoopt_edges(ArrayTour *t, int32_t x1, int32_t y1, int32_t x2,
+                            int32_t y2) {
+    if (x1 == x2 || x1 == y2 || y1 == x2 || y1 == y2) {
+        // Adjacent edges: the move would leave the tour unchanged
+        return;
+    }
+    if (at_succ(t, x1) == y1) {
+        assert(at_succ(t, x2) == y2);
+        at_twoopt(t, x1, x2);
+    } else {
+        assert(at_succ(t, y1) == x1 && at_succ(t, y2) == x2);
+        at_twoopt(t, y1, y2);
+    }
+}
+
+/// Moves the path `s1 -> s2` in between the consecutive `c -> d`, such that
+/// `c` ends up adjacent to `u` and `d` to `w`, with `{u, w} = {s1, s2}`.
+/// The move is carried out as a sequence of (at most three) 2-opt moves.
+static void at_oropt(ArrayTour *t, int32_t s1, int32_t s2, int32_t c,
+                     int32_t d, int32_t u) {
+    int32_t p = at_pred(t, s1);
+    int32_t nx = at_succ(t, s2);
+
+    if (d == p) {
+        // NOTE(dparo):
+        //      Same move, seen from the opposite orientation. This keeps
+        //      the first 2-opt move below from involving adjacent edges.
+        int32_t tmp = p;
+        p = nx;
+        nx = tmp;
+        tmp = s1;
+        s1 = s2;
+        s2 = tmp;
+        tmp = c;
+        c = d;
+        d = tmp;
+        u = u == s1 ? s2 : s1;
+    }
+
+    // p -> c -> ... -> nx -> s2 -> ... -> s1 -> d
+    at_twoopt_edges(t, p, s1, c, d);
+    // p -> nx -> ... -> c -> s2 -> ... -> s1 -> d
+    at_twoopt_edges(t, p, c, nx, s2);
+    if (u == s1 && s1 != s2) {
+        // p -> nx -> ... -> c -> s1 -> ... -> s2 -> d
+        at_twoopt_edges(t, c, s2, s1, d);
+    }
+}
+
+#define LS_OROPT_MAX_SEGMENT_LEN 3
+
+// NOTE(dparo):
+//      The Lin-Kernighan moves are applied to the ArrayTour, like the 2-opt
+//      and Or-opt moves, and not to a doubly-linked list / array hybrid
+//      (e.g. the two-level doubly-linked list of LKH). The hybrid reverses
+//      a path in O(sqrt(m)) instead of O(m), but every succ / pred /
+//      between query pays for an extra indirection and orientation check.
+//      It only pays off on tours of many thousands of nodes. The routes of
+//      this problem visit the subset of the customers allowed by the
+//      vehicle capacity, and at_twoopt() always reverses the shorter side
+//      of the tour.
+
+/// Maximum number of levels of the Lin-Kernighan moves. A move of `l` levels
+/// exchanges `l + 1` edges: up to 5-opt sequential moves.
+#define LS_LK_MAX_DEPTH 4
+
+/// Candidates tried at each level of the Lin-Kernighan moves, as long as no
+/// improvement is found
+static const int32_t LS_LK_BREADTH[LS_LK_MAX_DEPTH] = {5, 3, 1, 1};
+#define LS_LK_MAX_BREADTH 5
+
+/// 2-opt move of a Lin-Kernighan move: adds {t2, t3} and removes {t3, t4}
+typedef struct {
+    int32_t t2;
+    int32_t t3;
+    int32_t t4;
+} LkStep;
+
+typedef struct {
+    const Instance *instance;
+    const LsNeighborLists *nl;
+    /// Candidate lists among the visited nodes only (see nl_search_begin())
+    LsNeighborLists local_nl;
+    ArrayTour t;
+    /// FIFO of the nodes whose don't look bit is off
+    int32_t *queue;
+    int32_t queue_head;
+    int32_t queue_size;
+    bool *queued;
+    int64_t num_evals;
+    /// State of the Lin-Kernighan move under construction (see lk_step())
+    struct {
+        int32_t t1;
+        int32_t t2;
+        int32_t num_steps;
+        int32_t best_num_steps;
+        double best_gain;
+        LkStep steps[LS_LK_MAX_DEPTH];
+    } lk;
+} NlSearch;
+
+static inline void nl_search_push(NlSearch *s, int32_t v) {
+    const int32_t n = s->instance->num_customers + 1;
+    if (!s->queued[v]) {
+        int32_t i = s->queue_head + s->queue_size;
+        s->queue[i >= n ? i - n : i] = v;
+        ++s->queue_size;
+        s->queued[v] = true;
+    }
+}
+
+static inline int32_t nl_search_pop(NlSearch *s) {
+    const int32_t n = s->instance->num_customers + 1;
+    int32_t v = s->queue[s->queue_head];
+    s->queue_head = s->queue_head + 1 == n ? 0 : s->queue_head + 1;
+    --s->queue_size;
+    s->queued[v] = false;
+    return v;
+}
+
+/// First improving 2-opt move removing one of the two edges incident to `a`
+static double nl_search_twoopt(NlSearch *s, int32_t a) {
+    const Instance *instance = s->instance;
+    const int32_t k = s->nl->k;
+    const int32_t *neighbors = &s->nl->nodes[(size_t)a * k];
+    ArrayTour *t = &s->t;
+
+    for (int32_t dir = 0; dir < 2; dir++) {
+        int32_t a_n = dir == 0 ? at_succ(t, a) : at_pred(t, a);
+        double c_aan = cptp_dist(instance, a, a_n);
+
+        for (int32_t r = 0; r < k; r++) {
+            int32_t c = neighbors[r];
+            if (t->pos[c] < 0) {
+                continue;
+            }
+            double c_ac = cptp_dist(instance, a, c);
+            if (c_aan - c_ac <= COST_TOLERANCE) {
+                // The candidate lists are sorted: no further gain is possible
+                break;
+            }
+            int32_t c_n = dir == 0 ? at_succ(t, c) : at_pred(t, c);
+            if (c == a_n || c_n == a) {
+                continue;
+            }
+
+            ++s->num_evals;
+            double delta = c_ac + cptp_dist(instance, a_n, c_n) - c_aan -
+                           cptp_dist(instance, c, c_n);
+            if (delta < -COST_TOLERANCE) {
+                at_twoopt_edges(t, a, a_n, c, c_n);
+                nl_search_push(s, a);
+                nl_search_push(s, a_n);
+                nl_search_push(s, c);
+                nl_search_push(s, c_n);
+                return delta;
+            }
+        }
+    }
+
+    return 0.0;
+}
+
+/// First improving Or-opt move relocating a segment having `a` as one of its
+/// ends next to one of the candidate neighbors of `a`
+static double nl_search_oropt(NlSearch *s, int32_t a) {
+    const Instance *instance = s->instance;
+    const int32_t k = s->nl->k;
+    const int32_t *neighbors = &s->nl->nodes[(size_t)a * k];
+    ArrayTour *t = &s->t;
+
+    for (int32_t len = 1; len <= LS_OROPT_MAX_SEGMENT_LEN; len++) {
+        if (t->m < len + 3) {
+            break;
+        }
+        for (int32_t dir = 0; dir < (len == 1 ? 1 : 2); dir++) {
+            // Segment s1 -> ... -> s2, having `a` as its first (dir == 0)
+            // or last (dir == 1) node, and `o` as its other end
+            int32_t o = a;
+            for (int32_t l = 1; l < len; l++) {
+                o = dir == 0 ? at_succ(t, o) : at_pred(t, o);
+            }
+            const int32_t s1 = dir == 0 ? a : o;
+            const int32_t s2 = dir == 0 ? o : a;
+            const int32_t p = at_pred(t, s1);
+            const int32_t nx = at_succ(t, s2);
+
+            const double removal_gain = cptp_dist(instance, p, s1) +
+                                        cptp_dist(instance, s2, nx) -
+                                        cptp_dist(instance, p, nx);
+
+            for (int32_t r = 0; r < k; r++) {
+                int32_t c = neighbors[r];
+                if (t->pos[c] < 0) {
+                    continue;
+                }
+                double c_ac = cptp_dist(instance, a, c);
+                if (removal_gain - c_ac <= COST_TOLERANCE) {
+                    break;
+                }
+                if (at_between(t, s1, s2, c)) {
+                    continue;
+                }
+
+                // Either the edge (c, succ(c)) or the edge (pred(c), c)
+                for (int32_t side = 0; side < 2; side++) {
+                    int32_t e1 = side == 0 ? c : at_pred(t, c);
+                    int32_t e2 = side == 0 ? at_succ(t, c) : c;
+                    int32_t other = side == 0 ? e2 : e1;
+                    if (e1 == p || e2 == nx) {
+                        // The edge is incident to the segment
+                        continue;
+                    }
+
+                    ++s->num_evals;
+                    double delta = c_ac + cptp_dist(instance, o, other) -
+                                   cptp_dist(instance, e1, e2) - removal_gain;
+                    if (delta < -COST_TOLERANCE) {
+                        at_oropt(t, s1, s2, e1, e2, side == 0 ? a : o);
+                        nl_search_push(s, p);
+                        nl_search_push(s, nx);
+                        nl_search_push(s, s1);
+                        nl_search_push(s, s2);
+                        nl_search_push(s, e1);
+                        nl_search_push(s, e2);
+                        return delta;
+                    }
+                }
+            }
+        }
+    }
+
+    return 0.0;
+}
+
+/// Loads the visited nodes of `tour` into the array representation of the
+/// search, and queues all of them. Returns false when the tour is already
+/// optimal (3 nodes or less), or on failed memory allocations.
+static bool nl_search_begin(NlSearch *s, const Instance *instance,
+                            const LsNeighborLists *nl, const Tour *tour) {
+    const int32_t n = instance->num_customers + 1;
+
+    s->instance = instance;
+    s->nl = nl;
+    s->t.order = malloc(n * sizeof(*s->t.order));
+    s->t.pos = malloc(n * sizeof(*s->t.pos));
+    s->queue = malloc(n * sizeof(*s->queue));
+    s->queued = calloc(n, sizeof(*s->queued));
+
+    if (!s->t.order || !s->t.pos || !s->queue || !s->queued) {
+        return false;
+    }
+
+    int32_t first = -1;
+    for (int32_t i = 0; i < n; i++) {
+        s->t.pos[i] = -1;
+        if (first < 0 && is_visited(tour, i)) {
+            first = i;
+        }
+    }
+    if (first < 0) {
+        return false;
+    }
+
+    int32_t v = first;
+    do {
+        s->t.pos[v] = s->t.m;
+        s->t.order[s->t.m++] = v;
+        v = tour->succ[v];
+    } while (v != first);
+
+    if (s->t.m < 4) {
+        // Any tour over 3 nodes (or less) is already optimal
+        return false;
+    }
+
+    // NOTE(dparo):
+    //      The unvisited candidates are skipped. When the tour visits a small
+    //      fraction of the nodes, most of the candidates would be wasted:
+    //      use dedicated candidate lists built among the visited nodes only.
+    if (2 * s->t.m < n) {
+        if (!neighbor_lists_build(&s->local_nl, instance, nl->k, s->t.order,
+                                  s->t.m)) {
+            return false;
+        }
+        s->nl = &s->local_nl;
+        s->num_evals += (int64_t)s->t.m * s->t.m;
+    }
+
+    for (int32_t i = 0; i < s->t.m; i++) {
+        nl_search_push(s, s->t.order[i]);
+    }
+    return true;
+}
+
+/// Stores back the array representation into `tour` (when `tour` is not
+/// NULL), and releases the search.
+static void nl_search_end(NlSearch *s, Tour *tour, int64_t *num_evals) {
+    if (tour) {
+        for (int32_t i = 0; i < s->t.m; i++) {
+            tour->succ[s->t.order[i]] = at_succ(&s->t, s->t.order[i]);
+        }
+    }
+    if (num_evals) {
+        *num_evals += s->num_evals;
+    }
+    free(s->t.order);
+    free(s->t.pos);
+    free(s->queue);
+    free(s->queued);
+    ls_neighbor_lists_destroy(&s->local_nl);
+}
+
+double ls_twoopt_oropt(const Instance *instance, const LsNeighborLists *nl,
+                       Tour *tour, int64_t *num_evals) {
+    double total_delta = 0.0;
+    NlSearch s = {0};
+
+    if (!nl_search_begin(&s, instance, nl, tour)) {
+        nl_search_end(&s, NULL, num_evals);
+        return 0.0;
+    }
+
+    while (s.queue_size > 0) {
+        int32_t a = nl_search_pop(&s);
+        double delta = nl_search_twoopt(&s, a);
+        if (delta == 0.0) {
+            delta = nl_search_oropt(&s, a);
+        }
+        if (delta < 0.0) {
+            nl_search_push(&s, a);
+            total_delta += delta;
+        }
+    }
+
+    nl_search_end(&s, tour, num_evals);
+    return total_delta;
+}
+
+static bool lk_is_added(const NlSearch *s, int32_t level, int32_t a,
+                        int32_t b) {
+    for (int32_t l = 0; l < level; l++) {
+        const LkStep *st = &s->lk.steps[l];
+        if ((st->t2 == a && st->t3 == b) || (st->t2 == b && st->t3 == a)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool lk_is_removed(const NlSearch *s, int32_t level, int32_t a,
+                          int32_t b) {
+    if ((s->lk.t1 == a && s->lk.t2 == b) || (s->lk.t1 == b && s->lk.t2 == a)) {
+        return true;
+    }
+    for (int32_t l = 0; l < level; l++) {
+        const LkStep *st = &s->lk.steps[l];
+        if ((st->t3 == a && st->t4 == b) || (st->t3 == b && st->t4 == a)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Undoes the 2-opt move of `step`, which removed {t1, t2} and {t3, t4}
+static inline void lk_undo(NlSearch *s, const LkStep *step) {
+    at_twoopt_edges(&s->t, s->lk.t1, step->t4, step->t2, step->t3);
+}
+
+/// One level of a Lin-Kernighan move. The tour is the Hamiltonian path
+/// from the variable end `t2` to the fixed end `t1`, closed by the edge
+/// {t1, t2}, and `gain` is the length of the removed edges minus the length
+/// of the added ones, the closing edge excluded. The path is extended with a
+/// 2-opt move: add {t2, t3}, remove {t3, t4}, `t4` being the new variable
+/// end. The best closed tour found is recorded in `s->lk`, and the moves
+/// leading to it are left applied.
+static void lk_step(NlSearch *s, int32_t level, double gain) {
+    const Instance *instance = s->instance;
+    const int32_t k = s->nl->k;
+    ArrayTour *t = &s->t;
+    const int32_t t1 = s->lk.t1;
+    const int32_t t2 = level == 0 ? s->lk.t2 : s->lk.steps[level - 1].t4;
+    const int32_t *neighbors = &s->nl->nodes[(size_t)t2 * k];
+    const bool forward = at_succ(t, t1) == t2;
+
+    // The `breadth` candidates of largest `c(t3, t4) - c(t2, t3)`
+    const int32_t breadth = LS_LK_BREADTH[level];
+    int32_t num_cands = 0;
+    int32_t cand_t3[LS_LK_MAX_BREADTH];
+    int32_t cand_t4[LS_LK_MAX_BREADTH];
+    double cand_score[LS_LK_MAX_BREADTH];
+
+    for (int32_t r = 0; r < k; r++) {
+        int32_t t3 = neighbors[r];
+        if (t->pos[t3] < 0) {
+            continue;
+        }
+        double c_23 = cptp_dist(instance, t2, t3);
+        if (gain - c_23 <= COST_TOLERANCE) {
+            // The candidate lists are sorted: no further gain is possible
+            break;
+        }
+        int32_t t4 = forward ? at_pred(t, t3) : at_succ(t, t3);
+        if (t3 == t1 || t4 == t2 || t4 == t1 ||
+            lk_is_removed(s, level, t2, t3) || lk_is_added(s, level, t3, t4)) {
+            continue;
+        }
+
+        ++s->num_evals;
+        double score = cptp_dist(instance, t3, t4) - c_23;
+        if (num_cands == breadth && score <= cand_score[num_cands - 1]) {
+            continue;
+        }
+        int32_t q = num_cands < breadth ? num_cands++ : num_cands - 1;
+        while (q > 0 && cand_score[q - 1] < score) {
+            cand_t3[q] = cand_t3[q - 1];
+            cand_t4[q] = cand_t4[q - 1];
+            cand_score[q] = cand_score[q - 1];
+            --q;
+        }
+        cand_t3[q] = t3;
+        cand_t4[q] = t4;
+        cand_score[q] = score;
+    }
+
+    for (int32_t c = 0; c < num_cands; c++) {
+        LkStep *step = &s->lk.steps[level];
+        step->t2 = t2;
+        step->t3 = cand_t3[c];
+        step->t4 = cand_t4[c];
+        at_twoopt_edges(t, t1, t2, step->t4, step->t3);
+        s->lk.num_steps = level + 1;
+
+        double g = gain + cand_score[c];
+        double closed_gain = g - cptp_dist(instance, step->t4, t1);
+        if (closed_gain > s->lk.best_gain) {
+            s->lk.best_gain = closed_gain;
+            s->lk.best_num_steps = level + 1;
+        }
+
+        if (level + 1 < LS_LK_MAX_DEPTH) {
+            lk_step(s, level + 1, g);
+        }
+        if (s->lk.best_num_steps > 0) {
+            return;
+        }
+
+        lk_undo(s, step);
+        s->lk.num_steps = level;
+    }
+}
+
+/// Best Lin-Kernighan move (found by the first improving chain) having `a`
+/// as its fixed end, and removing one of the two edges incident to `a`
+static double nl_search_lk(NlSearch *s, int32_t a) {
+    for (int32_t dir = 0; dir < 2; dir++) {
+        s->lk.t1 = a;
+        s->lk.t2 = dir == 0 ? at_succ(&s->t, a) : at_pred(&s->t, a);
+        s->lk.num_steps = 0;
+        s->lk.best_num_steps = 0;
+        s->lk.best_gain = COST_TOLERANCE;
+
+        lk_step(s, 0, cptp_dist(s->instance, a, s->lk.t2));
+
+        if (s->lk.best_num_steps > 0) {
+            // Undo the moves past the best closed tour
+            while (s->lk.num_steps > s->lk.best_num_steps) {
+                lk_undo(s, &s->lk.steps[--s->lk.num_steps]);
+            }
+            nl_search_push(s, a);
+            for (int32_t l = 0; l < s->lk.num_steps; l++) {
+                nl_search_push(s, s->lk.steps[l].t2);
+                nl_search_push(s, s->lk.steps[l].t3);
+                nl_search_push(s, s->lk.steps[l].t4);
+            }
+            return -s->lk.best_gain;
+        }
+    }
+
+    return 0.0;
+}
+
+double ls_lin_kernighan(const Instance *instance, const LsNeighborLists *nl,
+                        Tour *tour, int64_t *num_evals) {
+    double total_delta = 0.0;
+    NlSearch s = {0};
+
+    if (!nl_search_begin(&s, instance, nl, tour)) {
+        nl_search_end(&s, NULL, num_evals);
+        return 0.0;
+    }
+
+    while (s.queue_size > 0) {
+        int32_t a = nl_search_pop(&s);
+        double delta = nl_search_lk(&s, a);
+        if (delta == 0.0) {
+            delta = nl_search_oropt(&s, a);
+        }
+        if (delta < 0.0) {
+            nl_search_push(&s, a);
+            total_delta += delta;
+        }
+    }
+
+    nl_search_end(&s, tour, num_evals);
+    return total_delta;
+}
+
+double ls_add_drop(const Instance *instance, Tour *tour,
+                   int32_t min_num_visited) {
+    const int32_t n = instance->num_customers + 1;
+    const double Q = instance->vehicle_cap;
+    double total_delta = 0.0;
+
+    int32_t *pred = malloc(n * sizeof(*pred));
+    if (!pred) {
+        return 0.0;
+    }
+
+    int32_t num_visited = 0;
+    double sum_demands = 0.0;
+    for (int32_t i = 0; i < n; i++) {
+        if (is_visited(tour, i)) {
+            ++num_visited;
+            sum_demands += instance->demands[i];
+        }
+    }
+
+    while (true) {
+        for (int32_t i = 0; i < n; i++) {
+            if (is_visited(tour, i)) {
+                pred[tour->succ[i]] = i;
+            }
+        }
+
+        // NOTE(dparo):
+        //      While the tour is too short, the best insertion is applied
+        //      even if it does not improve the tour cost.
+        const bool must_add = num_visited < min_num_visited;
+        const bool can_drop = num_visited - 1 >= MAX(min_num_visited, 2);
+
+        double best_delta = INFINITY;
+        int32_t best_h = -1;
+        int32_t best_a = -1;
+
+        for (int32_t h = 1; h < n; h++) {
+            if (is_visited(tour, h)) {
+                if (!can_drop) {
+                    continue;
+                }
+                int32_t a = pred[h];
+                int32_t b = tour->succ[h];
+                double delta = instance->profits[h] -
+                               insertion_cost(instance, a, h, b);
+                if (delta < best_delta) {
+                    best_delta = delta;
+                    best_h = h;
+                    best_a = -1;
+                }
+            } else if (sum_demands + instance->demands[h] <= Q) {
+                double cost;
+                int32_t a = cheapest_insertion(instance, tour, h, &cost);
+                double delta = cost - instance->profits[h];
+                if (delta < best_delta) {
+                    best_delta = delta;
+                    best_h = h;
+                    best_a = a;
+                }
+            }
+        }
+
+        if (best_h < 0 || (!must_add && best_delta >= -COST_TOLERANCE)) {
+            break;
+        }
+
+        if (best_a >= 0) {
+            insert_after(tour, best_a, best_h);
+            sum_demands += instance->demands[best_h];
+            ++num_visited;
+        } else {
+            tour->succ[pred[best_h]] = tour->succ[best_h];
+            tour->succ[best_h] = INT32_DEAD_VAL;
+            tour->comp[best_h] = INT32_DEAD_VAL;
+            sum_demands -= instance->demands[best_h];
+            --num_visited;
+        }
+        total_delta += best_delta;
+    }
+
+    free(pred);
+    return total_delta;
+}
+
+/// Number of cheapest insertion positions cached for each unvisited
+/// customer. A swap removes the two edges incident to the dropped customer:
+/// caching three positions guarantees that the cheapest insertion among the
+/// remaining edges is always known.
+#define SEL_NUM_CACHED_POSITIONS 3
+
+/// State of ls_add_drop_swap(). The cheapest insertions of each unvisited
+/// customer `j`, the travel cost increase `ins_cost[.]` of inserting it right
+/// after `ins_pred[.]` sorted by increasing cost, are cached and refreshed
+/// incrementally after each move.
+typedef struct {
+    const Instance *instance;
+    Tour *tour;
+    int32_t *pred;
+    double *ins_cost;
+    int32_t *ins_pred;
+    int64_t num_evals;
+} SelSearch;
+
+static inline double *sel_ins_cost(SelSearch *s, int32_t j) {
+    return &s->ins_cost[(size_t)j * SEL_NUM_CACHED_POSITIONS];
+}
+
+static inline int32_t *sel_ins_pred(SelSearch *s, int32_t j) {
+    return &s->ins_pred[(size_t)j * SEL_NUM_CACHED_POSITIONS];
+}
+
+static void sel_push(SelSearch *s, int32_t j, int32_t a, double c) {
+    double *cost = sel_ins_cost(s, j);
+    int32_t *pred = sel_ins_pred(s, j);
+    int32_t r = SEL_NUM_CACHED_POSITIONS - 1;
+    if (!(c < cost[r])) {
+        return;
+    }
+    while (r > 0 && c < cost[r - 1]) {
+        cost[r] = cost[r - 1];
+        pred[r] = pred[r - 1];
+        --r;
+    }
+    cost[r] = c;
+    pred[r] = a;
+}
+
+static inline void sel_try_edge(SelSearch *s, int32_t j, int32_t a,
+                                int32_t b) {
+    ++s->num_evals;
+    sel_push(s, j, a, insertion_cost(s->instance, a, j, b));
+}
+
+static void sel_rescan(SelSearch *s, int32_t j) {
+    for (int32_t r = 0; r < SEL_NUM_CACHED_POSITIONS; r++) {
+        sel_ins_cost(s, j)[r] = INFINITY;
+        sel_ins_pred(s, j)[r] = -1;
+    }
+
+    int32_t a = 0;
+    do {
+        int32_t b = s->tour->succ[a];
+        sel_try_edge(s, j, a, b);
+        a = b;
+    } while (a != 0);
+}
+
+/// Whether one of the cached insertions of `j` uses an edge leaving `a`
+static inline bool sel_uses_edge(SelSearch *s, int32_t j, int32_t a) {
+    for (int32_t r = 0; r < SEL_NUM_CACHED_POSITIONS; r++) {
+        if (sel_ins_pred(s, j)[r] == a) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void sel_insert(SelSearch *s, int32_t a, int32_t h) {
+    const int32_t n = s->instance->num_customers + 1;
+    Tour *tour = s->tour;
+
+    insert_after(tour, a, h);
+    const int32_t b = tour->succ[h];
+    s->pred[h] = a;
+    s->pred[b] = h;
+
+    // The edge (a, b) is replaced by (a, h) and (h, b)
+    for (int32_t j = 1; j < n; j++) {
+        if (is_visited(tour, j)) {
+            continue;
+        }
+        if (sel_uses_edge(s, j, a)) {
+            sel_rescan(s, j);
+        } else {
+            sel_try_edge(s, j, a, h);
+            sel_try_edge(s, j, h, b);
+        }
+    }
+}
+
+static void sel_remove(SelSearch *s, int32_t h) {
+    const int32_t n = s->instance->num_customers + 1;
+    Tour *tour = s->tour;
+    const int32_t a = s->pred[h];
+    const int32_t b = tour->succ[h];
+
+    tour->succ[a] = b;
+    s->pred[b] = a;
+    tour->succ[h] = INT32_DEAD_VAL;
+    tour->comp[h] = INT32_DEAD_VAL;
+
+    // The edges (a, h) and (h, b) are replaced by (a, b)
+    for (int32_t j = 1; j < n; j++) {
+        if (is_visited(tour, j)) {
+            continue;
+        }
+        if (j == h || sel_uses_edge(s, j, a) || sel_uses_edge(s, j, h)) {
+            sel_rescan(s, j);
+        } else {
+            sel_try_edge(s, j, a, b);
+        }
+    }
+}
+
+typedef enum {
+    SEL_MOVE_NONE,
+    SEL_MOVE_ADD,
+    SEL_MOVE_DROP,
+    SEL_MOVE_SWAP,
+} SelMoveKind;
+
+double ls_add_drop_swap(const Instance *instance, const LsNeighborLists *nl,
+                        Tour *tour, int32_t min_num_visited,
+                        int64_t *num_evals) {
+    const int32_t n = instance->num_customers + 1;
+    const double Q = instance->vehicle_cap;
+    double total_delta = 0.0;
+
+    assert(is_visited(tour, 0));
+
+    SelSearch s = {0};
+    s.instance = instance;
+    s.tour = tour;
+    s.pred = malloc(n * sizeof(*s.pred));
+    s.ins_cost =
+        malloc((size_t)n * SEL_NUM_CACHED_POSITIONS * sizeof(*s.ins_cost));
+    s.ins_pred =
+        malloc((size_t)n * SEL_NUM_CACHED_POSITIONS * sizeof(*s.ins_pred));
+
+    if (!s.pred || !s.ins_cost || !s.ins_pred) {
+        goto terminate;
+    }
+
+    int32_t num_visited = 0;
+    double sum_demands = 0.0;
+    for (int32_t i = 0; i < n; i++) {
+        if (is_visited(tour, i)) {
+            s.pred[tour->succ[i]] = i;
+            ++num_visited;
+            sum_demands += instance->demands[i];
+        }
+    }
+    for (int32_t j = 1; j < n; j++) {
+        if (!is_visited(tour, j)) {
+            sel_rescan(&s, j);
+        }
+    }
+
+    while (true) {
+        const double slack = Q - sum_demands;
+
+        // NOTE(dparo):
+        //      While the tour is too short, the best insertion is applied
+        //      even if it does not improve the tour cost.
+        const bool must_add = num_visited < min_num_visited;
+        const bool can_drop = num_visited - 1 >= MAX(min_num_visited, 2);
+
+        SelMoveKind best_kind = SEL_MOVE_NONE;
+        double best_delta = INFINITY;
+        int32_t best_i = -1;
+        int32_t best_j = -1;
+        int32_t best_a = -1;
+
+        for (int32_t j = 1; j < n; j++) {
+            if (is_visited(tour, j) || instance->demands[j] > slack) {
+                continue;
+            }
+            double delta = sel_ins_cost(&s, j)[0] - instance->profits[j];
+            if (isfinite(delta) && delta < best_delta) {
+                best_kind = SEL_MOVE_ADD;
+                best_delta = delta;
+                best_j = j;
+                best_a = sel_ins_pred(&s, j)[0];
+            }
+        }
+
+        for (int32_t i = 1; i < n && !must_add; i++) {
+            if (!is_visited(tour, i)) {
+                continue;
+            }
+
+            const int32_t p_i = s.pred[i];
+            const int32_t s_i = tour->succ[i];
+            const double drop_delta =
+                instance->profits[i] - insertion_cost(instance, p_i, i, s_i);
+            ++s.num_evals;
+            if (!isfinite(drop_delta)) {
+                continue;
+            }
+
+            if (can_drop && drop_delta < best_delta) {
+                best_kind = SEL_MOVE_DROP;
+                best_delta = drop_delta;
+                best_i = i;
+            }
+
+            const int32_t *neighbors = &nl->nodes[(size_t)i * nl->k];
+            for (int32_t r = 0; r < nl->k; r++) {
+                const int32_t j = neighbors[r];
+                if (j == 0 || is_visited(tour, j) ||
+                    instance->demands[j] - instance->demands[i] > slack ||
+                    !isfinite(instance->profits[j])) {
+                    continue;
+                }
+
+                // Replace: `j` takes the place of `i`
+                int32_t a = p_i;
+                double c = insertion_cost(instance, p_i, j, s_i);
+                ++s.num_evals;
+
+                // Swap: `j` at its cheapest position once `i` is removed
+                for (int32_t q = 0; q < SEL_NUM_CACHED_POSITIONS; q++) {
+                    int32_t a_q = sel_ins_pred(&s, j)[q];
+                    if (a_q != p_i && a_q != i) {
+                        if (a_q >= 0 && sel_ins_cost(&s, j)[q] < c) {
+                            c = sel_ins_cost(&s, j)[q];
+                            a = a_q;
+                        }
+                        break;
+                    }
+                }
+
+                double delta = drop_delta + c - instance->profits[j];
+                if (delta < best_delta) {
+                    best_kind = SEL_MOVE_SWAP;
+                    best_delta = delta;
+                    best_i = i;
+                    best_j = j;
+                    best_a = a;
+                }
+            }
+        }
+
+        if (best_kind == SEL_MOVE_NONE ||
+            (!must_add && best_delta >= -COST_TOLERANCE)) {
+            break;
+        }
+
+        if (best_kind == SEL_MOVE_DROP || best_kind == SEL_MOVE_SWAP) {
+            sel_remove(&s, best_i);
+            sum_demands -= instance->demands[best_i];
+            --num_visited;
+        }
+        if (best_kind == SEL_MOVE_ADD || best_kind == SEL_MOVE_SWAP) {
+            sel_insert(&s, best_a, best_j);
+            sum_demands += instance->demands[best_j];
+            ++num_visited;
+        }
+        total_delta += best_delta;
+    }
+
+terminate:
+    if (num_evals) {
+        *num_evals += s.num_evals;
+    }
+    free(s.pred);
+    free(s.ins_cost);
+    free(s.ins_pred);
+    return total_delta;
+}
+
+double ls_optimize(const Instance *instance, Tour *tour,
+                   int32_t min_num_visited) {
+    double total_delta = ls_add_drop(instance, tour, min_num_visited);
+
+    while (true) {
+        double delta = ls_twoopt(instance, tour);
+        total_delta += delta;
+        if (delta >= -COST_TOLERANCE) {
+            // Nothing changed: add/drop is already at a local optimum
+            break;
+        }
+        total_delta += ls_add_drop(instance, tour, min_num_visited);
+    }
+
+    return total_delta;
+}
+
+double ls_optimize_nl(const Instance *instance, const LsNeighborLists *nl,
+                      Tour *tour, int32_t min_num_visited, int64_t *num_evals) {
+    double total_delta = ls_twoopt_oropt(instance, nl, tour, num_evals);
+
+    while (true) {
+        double delta = ls_add_drop_swap(instance, nl, tour, min_num_visited,
+                                        num_evals);
+        total_delta += delta;
+        if (delta >= -COST_TOLERANCE) {
+            // The routing is already at a local optimum
+            break;
+        }
+        total_delta += ls_twoopt_oropt(instance, nl, tour, num_evals);
+    }
+
+    return total_delta;
+}
+
+void ls_perturb(const Instance *instance, Tour *tour, int32_t strength,
+                int32_t min_num_visited, uint64_t *rng_state) {
+    const int32_t n = instance->num_customers + 1;
+    const double Q = instance->vehicle_cap;
+
+    int32_t *candidates = malloc(n * sizeof(*candidates));
+    if (!candidates) {
+        return;
+    }
+
+    int32_t num_visited = 0;
+    double sum_demands = 0.0;
+    for (int32_t i = 0; i < n; i++) {
+        if (is_visited(tour, i)) {
+            ++num_visited;
+            sum_demands += instance->demands[i];
+        }
+    }
+
+    for (int32_t s = 0; s < strength; s++) {
+        if (num_visited - 1 < MAX(min_num_visited, 2)) {
+            break;
+        }
+
+        int32_t cnt = 0;
+        for (int32_t i = 1; i < n; i++) {
+            if (is_visited(tour, i)) {
+                candidates[cnt++] = i;
+            }
+        }
+
+        int32_t h = candidates[ls_rand(rng_state) % (uint64_t)cnt];
+        int32_t a = h;
+        while (tour->succ[a] != h) {
+            a = tour->succ[a];
+        }
+
+        tour->succ[a] = tour->succ[h];
+        tour->succ[h] = INT32_DEAD_VAL;
+        tour->comp[h] = INT32_DEAD_VAL;
+        sum_demands -= instance->demands[h];
+        --num_visited;
+    }
+
+    for (int32_t s = 0; s < strength; s++) {
+        int32_t cnt = 0;
+        for (int32_t i = 1; i < n; i++) {
+            if (!is_visited(tour, i) && isfinite(instance->profits[i]) &&
+                sum_demands + instance->demands[i] <= Q) {
+                candidates[cnt++] = i;
+            }
+        }
+        if (cnt == 0) {
+            break;
+        }
+
+        int32_t h = candidates[ls_rand(rng_state) % (uint64_t)cnt];
+        double cost;
+        int32_t a = cheapest_insertion(instance, tour, h, &cost);
+        assert(a >= 0);
+        insert_after(tour, a, h);
+        sum_demands += instance->demands[h];
+        ++num_visited;
+    }
+
+    free(candidates);
+}
+
+void ls_perturb_segments(const Instance *instance, Tour *tour,
+                         int32_t num_segments, uint64_t *rng_state) {
+    const int32_t n = instance->num_customers + 1;
+
+    int32_t num_visited = 0;
+    for (int32_t i = 0; i < n; i++) {
+        num_visited += is_visited(tour, i);
+    }
+
+    // Reversing a segment of a triangle yields the same cycle
+    if (num_visited < 4) {
+        return;
+    }
+
+    for (int32_t s = 0; s < num_segments; s++) {
+        // Reverse the path u -> ... -> c, of len in [2, num_visited - 2],
+        // found after `a`
+        int32_t a = 0;
+        int32_t steps = (int32_t)(ls_rand(rng_state) % (uint64_t)num_visited);
+        while (steps-- > 0) {
+            a = tour->succ[a];
+        }
+        int32_t len =
+            2 + (int32_t)(ls_rand(rng_state) % (uint64_t)(num_visited - 3));
+
+        const int32_t u = tour->succ[a];
+        int32_t c = u;
+        for (int32_t k = 1; k < len; k++) {
+            c = tour->succ[c];
+        }
+
+        int32_t prev = tour->succ[c];
+        int32_t x = u;
+        while (true) {
+            int32_t next = tour->succ[x];
+            tour->succ[x] = prev;
+            prev = x;
+            if (x == c) {
+                break;
+            }
+            x = next;
+        }
+        tour->succ[a] = c;
+    }
+}
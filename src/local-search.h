@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2022 Davide Paro
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#if __cplusplus
+extern "C" {
+#endif
+
+#include "core.h"
+
+// NOTE(dparo):
+//      CPLEX independent local search moves for CPTP tours.
+//      All the routines work on a single component tour (the depot is always
+//      visited), keep it capacity feasible, and return the change of the tour
+//      cost (see tour_eval()), which is never positive.
+//      `min_num_visited` is the minimum number of visited nodes, depot
+//      included, the tour is allowed to shrink to. The MIP formulation, for
+//      example, does not accept tours visiting less than 3 nodes.
+
+/// Builds into `tour` a route visiting the depot and the customers `i`
+/// having `score[i] >= threshold`. The customers are inserted by decreasing
+/// score, each at its cheapest position. Customers exceeding the residual
+/// capacity are skipped.
+void ls_build_tour_from_scores(const Instance *instance, Tour *tour,
+                               const double *score, double threshold);
+
+/// Length of the candidate lists of the iterated local searches
+#define LS_ILS_NUM_NEIGHBORS (25)
+
+/// Upper bound on the automatically picked perturbation strength of the
+/// iterated local searches (see ls_perturb())
+#define LS_ILS_MAX_PERTURBATION (8)
+
+/// Best improvement 2-opt. The set of visited customers does not change.
+double ls_twoopt(const Instance *instance, Tour *tour);
+
+/// Best improvement insertion (add) of unvisited customers, at their cheapest
+/// position, and removal (drop) of visited customers.
+double ls_add_drop(const Instance *instance, Tour *tour,
+                   int32_t min_num_visited);
+
+/// Candidate lists for the neighbor list based moves: the `k` nearest nodes
+/// of each node `i`, by increasing distance, are
+/// `nodes[i * k]`, ..., `nodes[i * k + k - 1]`.
+typedef struct LsNeighborLists {
+    int32_t k;
+    int32_t *nodes;
+} LsNeighborLists;
+
+bool ls_neighbor_lists_create(LsNeighborLists *nl, const Instance *instance,
+                              int32_t k);
+void ls_neighbor_lists_destroy(LsNeighborLists *nl);
+
+/// First improvement 2-opt and Or-opt (segments of up to 3 nodes, possibly
+/// reversed), restricted to the candidate lists `nl` and driven by don't
+/// look bits. The set of visited customers does not change. When
+/// `num_evals` is not NULL, it is incremented by the number of evaluated
+/// moves.
+double ls_twoopt_oropt(const Instance *instance, const LsNeighborLists *nl,
+                       Tour *tour, int64_t *num_evals);
+
+/// Lin-Kernighan style variable depth search, restricted to the candidate
+/// lists `nl` and driven by don't look bits. Each move is a chain of up to 4
+/// sequential 2-opt moves (up to 5-opt sequential moves), with backtracking
+/// on the first two levels. Nodes where no such move improves the tour
+/// fall back to the Or-opt moves of ls_twoopt_oropt(). The set of visited
+/// customers does not change. When `num_evals` is not NULL, it is
+/// incremented by the number of evaluated moves.
+double ls_lin_kernighan(const Instance *instance, const LsNeighborLists *nl,
+                        Tour *tour, int64_t *num_evals);
+
+/// Best improvement customer selection local search, with incremental
+/// delta evaluation: insertion (add) of unvisited customers at their
+/// cheapest position, removal (drop) of visited customers, and swap of a
+/// visited customer `i` with one of its unvisited candidate neighbors `j`
+/// (from `nl`), `j` being inserted either at its cheapest position or in
+/// place of `i` (replace). The capacity slack is kept up to date, such that
+/// the tour stays capacity feasible. Tours visiting less than
+/// `min_num_visited` nodes are first grown by the cheapest insertions, even
+/// when they worsen the cost. When `num_evals` is not NULL, it is incremented
+/// by the number of evaluated moves.
+double ls_add_drop_swap(const Instance *instance, const LsNeighborLists *nl,
+                        Tour *tour, int32_t min_num_visited,
+                        int64_t *num_evals);
+
+/// Alternates ls_twoopt() and ls_add_drop() up until a local optimum for
+/// both neighborhoods is reached.
+double ls_optimize(const Instance *instance, Tour *tour,
+                   int32_t min_num_visited);
+
+/// Alternates ls_twoopt_oropt() and ls_add_drop_swap() up until a local
+/// optimum for both neighborhoods is reached. `num_evals` is as in
+/// ls_twoopt_oropt().
+double ls_optimize_nl(const Instance *instance, const LsNeighborLists *nl,
+                      Tour *tour, int32_t min_num_visited, int64_t *num_evals);
+
+/// xorshift64* generator: cheap, and private to the caller (thread safe).
+/// `state` must be non zero.
+static inline uint64_t ls_rand(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * UINT64_C(0x2545F4914F6CDD1D);
+}
+
+/// Random perturbation for iterated local search: drops up to `strength`
+/// random visited customers, then inserts up to `strength` random unvisited
+/// ones (capacity permitting) at their cheapest position. Customers having an
+/// infinite negative profit are never inserted. `rng_state` is the caller
+/// owned state of the random generator, and must be non zero.
+void ls_perturb(const Instance *instance, Tour *tour, int32_t strength,
+                int32_t min_num_visited, uint64_t *rng_state);
+
+/// Random perturbation of the routing: reverses `num_segments` random
+/// segments of the tour (random 2-opt moves). The set of visited customers
+/// does not change. `rng_state` is as in ls_perturb().
+void ls_perturb_segments(const Instance *instance, Tour *tour,
+                         int32_t num_segments, uint64_t *rng_state);
+
+#if __cplusplus
+}
+#endif
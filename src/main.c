@@ -136,9 +136,83 @@ static void writeout_results(FILE *fh, AppCtx *ctx, bool success,
     print_timerepr(stdout, &solve_time_repr);
     printf("\n");
 
+    if (solution->det_ticks >= 0.0) {
+        printf("%-16s %.17g\n", "DET TICKS:", solution->det_ticks);
+    }
+
     printf("%-16s %s\n", "SUCCESS", success ? "TRUE" : "FALSE");
 }
 
+static cJSON *make_tour_info_json(Instance *instance, Tour *tour, bool *s) {
+    cJSON *tour_info_obj = cJSON_CreateObject();
+    if (!tour_info_obj) {
+        *s = false;
+        return NULL;
+    }
+
+    double cost = tour_eval(instance, tour);
+    double profit = tour_profit(instance, tour);
+    double demand = tour_demand(instance, tour);
+
+    *s &= cJSON_AddItemToObject(tour_info_obj, "cost",
+                                cJSON_CreateNumber(cost));
+    *s &= cJSON_AddItemToObject(tour_info_obj, "profit",
+                                cJSON_CreateNumber(profit));
+    *s &= cJSON_AddItemToObject(tour_info_obj, "demand",
+                                cJSON_CreateNumber(demand));
+
+    cJSON *route_array = cJSON_CreateArray();
+    int32_t curr_vertex = 0;
+    int32_t next_vertex = curr_vertex;
+    do {
+        next_vertex = *tsucc(tour, curr_vertex);
+        cJSON_AddItemToArray(route_array, cJSON_CreateNumber(curr_vertex));
+
+        curr_vertex = next_vertex;
+    } while (curr_vertex != 0);
+    *s &= cJSON_AddItemToObject(tour_info_obj, "route", route_array);
+
+    return tour_info_obj;
+}
+
+static cJSON *make_relaxation_json(Solution *solution, bool *s) {
+    cJSON *relaxation_obj = cJSON_CreateObject();
+    if (!relaxation_obj) {
+        *s = false;
+        return NULL;
+    }
+
+    cJSON *bounds_array = cJSON_CreateArray();
+    for (ptrdiff_t r = 0; r < arrlen(solution->relaxation.round_bounds); r++) {
+        cJSON_AddItemToArray(
+            bounds_array,
+            cJSON_CreateNumber(solution->relaxation.round_bounds[r]));
+    }
+    *s &= cJSON_AddItemToObject(relaxation_obj, "roundBounds", bounds_array);
+
+    cJSON *nodes_array = cJSON_CreateArray();
+    for (ptrdiff_t i = 0; i < arrlen(solution->relaxation.node_values); i++) {
+        cJSON_AddItemToArray(
+            nodes_array,
+            cJSON_CreateNumber(solution->relaxation.node_values[i]));
+    }
+    *s &= cJSON_AddItemToObject(relaxation_obj, "nodeValues", nodes_array);
+
+    cJSON *edges_array = cJSON_CreateArray();
+    for (ptrdiff_t k = 0; k < arrlen(solution->relaxation.edge_values); k++) {
+        const EdgeValue *e = &solution->relaxation.edge_values[k];
+        cJSON *edge_obj = cJSON_CreateObject();
+        *s &= cJSON_AddItemToObject(edge_obj, "i", cJSON_CreateNumber(e->i));
+        *s &= cJSON_AddItemToObject(edge_obj, "j", cJSON_CreateNumber(e->j));
+        *s &= cJSON_AddItemToObject(edge_obj, "value",
+                                    cJSON_CreateNumber(e->value));
+        cJSON_AddItemToArray(edges_array, edge_obj);
+    }
+    *s &= cJSON_AddItemToObject(relaxation_obj, "edgeValues", edges_array);
+
+    return relaxation_obj;
+}
+
 static void writeout_json_report(AppCtx *ctx, Instance *instance,
                                  Solution *solution, SolveStatus status,
                                  Timing timing) {
@@ -218,6 +292,10 @@ static void writeout_json_report(AppCtx *ctx, Instance *instance,
 
         s &= cJSON_AddItemToObject(status_obj, "sigTermAbortion",
                                    cJSON_CreateBool(sigterm_abortion));
+
+        s &= cJSON_AddItemToObject(
+            status_obj, "relaxationOnly",
+            cJSON_CreateBool(BOOL(status & SOLVE_STATUS_RELAXATION_ONLY)));
     }
 
     cJSON *timing_obj = cJSON_CreateObject();
@@ -237,6 +315,12 @@ static void writeout_json_report(AppCtx *ctx, Instance *instance,
         s &= cJSON_AddItemToObject(timing_obj, "tookRepr",
                                    cJSON_CreateString(timerepr_str));
 
+        if (solution->det_ticks >= 0.0) {
+            s &= cJSON_AddItemToObject(
+                timing_obj, "detTicks",
+                cJSON_CreateNumber(solution->det_ticks));
+        }
+
         char *time = ctime(&timing.started);
         // Remove newline introduced from ctime
         time[strlen(time) - 1] = 0;
@@ -266,34 +350,26 @@ static void writeout_json_report(AppCtx *ctx, Instance *instance,
     }
 
     if (primal_sol_avail) {
-        cJSON *tour_info_obj = cJSON_CreateObject();
-        s &= cJSON_AddItemToObject(root, "tourInfo", tour_info_obj);
-        {
-            double cost = tour_eval(instance, &solution->tour);
-            double profit = tour_profit(instance, &solution->tour);
-            double demand = tour_demand(instance, &solution->tour);
-
-            s &= cJSON_AddItemToObject(tour_info_obj, "cost",
-                                       cJSON_CreateNumber(cost));
-            s &= cJSON_AddItemToObject(tour_info_obj, "profit",
-                                       cJSON_CreateNumber(profit));
-            s &= cJSON_AddItemToObject(tour_info_obj, "demand",
-                                       cJSON_CreateNumber(demand));
-
-            cJSON *route_array = cJSON_CreateArray();
-            int32_t curr_vertex = 0;
-            int32_t next_vertex = curr_vertex;
-            do {
-                next_vertex = *tsucc(&solution->tour, curr_vertex);
-                cJSON_AddItemToArray(route_array,
-                                     cJSON_CreateNumber(curr_vertex));
-
-                curr_vertex = next_vertex;
-            } while (curr_vertex != 0);
-            s &= cJSON_AddItemToObject(tour_info_obj, "route", route_array);
+        s &= cJSON_AddItemToObject(
+            root, "tourInfo",
+            make_tour_info_json(instance, &solution->tour, &s));
+    }
+
+    if (arrlen(solution->tours) > 0) {
+        cJSON *tours_array = cJSON_CreateArray();
+        s &= cJSON_AddItemToObject(root, "collectedTours", tours_array);
+        for (ptrdiff_t i = 0; i < arrlen(solution->tours); i++) {
+            cJSON_AddItemToArray(
+                tours_array,
+                make_tour_info_json(instance, &solution->tours[i], &s));
         }
     }
 
+    if (arrlen(solution->relaxation.round_bounds) > 0) {
+        s &= cJSON_AddItemToObject(root, "relaxation",
+                                   make_relaxation_json(solution, &s));
+    }
+
     cJSON *constants_obj = cJSON_CreateObject();
     s &= cJSON_AddItemToObject(root, "constants", constants_obj);
     {
@@ -323,3 +323,18 @@ char *os_dirname(const char *path, Path *p) {
 #error "TODO os_dirname for WINDOWS platform"
 #endif
 }
+
+int32_t os_get_num_cores(void) {
+#if defined(__linux__) || defined(__FreeBSD__) || defined(__OpenBSD__) ||      \
+    defined(__NetBSD__) || defined(__DragonFly__) || defined(__APPLE__)
+    long numcores = sysconf(_SC_NPROCESSORS_ONLN);
+    return numcores > 0 ? (int32_t)numcores : 1;
+#elif defined _WIN64
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int32_t)info.dwNumberOfProcessors
+                                         : 1;
+#else
+#error "Unsupported platform"
+#endif
+}
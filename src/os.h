@@ -75,6 +75,9 @@ bool os_mkdir(char *path, bool exist_ok);
 char *os_basename(const char *path, Path *p);
 char *os_dirname(const char *path, Path *p);
 
+/// Number of online logical cores (at least 1)
+int32_t os_get_num_cores(void);
+
 #if __cplusplus
 }
 #endif
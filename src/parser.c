@@ -610,7 +610,7 @@ static bool parse_vrplib_edge_weight_section(VrplibParser *p,
 
     for (int32_t i = 0; i < n; i++) {
         for (int32_t j = i + 1; j < n; j++) {
-            int32_t idx = sxpos(n, i, j);
+            int64_t idx = sxpos(n, i, j);
 
             for (int32_t lexid = 0; lexid < 3; lexid++) {
                 char *lexeme = get_token_lexeme(p);
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2022 Davide Paro
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "presolve.h"
+#include <stdlib.h>
+#include <string.h>
+#include "core-utils.h"
+#include "local-search.h"
+
+typedef struct {
+    int32_t node;
+    double ratio;
+} KnapsackItem;
+
+static int cmp_knapsack_item_desc(const void *a, const void *b) {
+    const KnapsackItem *ia = a;
+    const KnapsackItem *ib = b;
+    if (ia->ratio > ib->ratio) {
+        return -1;
+    } else if (ia->ratio < ib->ratio) {
+        return 1;
+    }
+    return ia->node - ib->node;
+}
+
+/// Shortest path distances from the depot (Dijkstra over the complete graph).
+/// When the distances satisfy the triangle inequality `sp[i]` is simply the
+/// distance between the depot and `i`.
+static bool depot_shortest_paths(const Instance *instance, double *sp) {
+    const int32_t n = instance->num_customers + 1;
+    bool *done = calloc(n, sizeof(*done));
+    if (!done) {
+        return false;
+    }
+
+    sp[0] = 0.0;
+    done[0] = true;
+    for (int32_t i = 1; i < n; i++) {
+        sp[i] = cptp_dist(instance, 0, i);
+    }
+
+    for (int32_t it = 1; it < n; it++) {
+        int32_t u = -1;
+        for (int32_t i = 1; i < n; i++) {
+            if (!done[i] && (u < 0 || sp[i] < sp[u])) {
+                u = i;
+            }
+        }
+        done[u] = true;
+        for (int32_t v = 1; v < n; v++) {
+            if (!done[v]) {
+                sp[v] = MIN(sp[v], sp[u] + cptp_dist(instance, u, v));
+            }
+        }
+    }
+
+    free(done);
+    return true;
+}
+
+/// Upper bound on the profit collected from the customers other than `i`, by
+/// a tour visiting `i`: fractional knapsack of the positive profits within
+/// the residual capacity. `items` is sorted by decreasing profit per unit of
+/// demand.
+static double knapsack_profit_bound(const Instance *instance,
+                                    const KnapsackItem *items,
+                                    int32_t num_items, int32_t i) {
+    double cap = instance->vehicle_cap - instance->demands[0] -
+                 instance->demands[i];
+    double profit = 0.0;
+
+    for (int32_t k = 0; k < num_items && cap > 0.0; k++) {
+        int32_t j = items[k].node;
+        if (j == i) {
+            continue;
+        }
+        double q = instance->demands[j];
+        if (q <= cap) {
+            profit += instance->profits[j];
+            cap -= q;
+        } else {
+            profit += instance->profits[j] * cap / q;
+            cap = 0.0;
+        }
+    }
+
+    return profit;
+}
+
+/// Cost of a local search tour, or INFINITY if it visits less than
+/// `min_num_visited` nodes.
+static double local_search_upper_bound(const Instance *instance,
+                                       int32_t min_num_visited) {
+    const int32_t n = instance->num_customers + 1;
+    double result = INFINITY;
+    Tour tour = tour_create(instance);
+
+    if (tour_is_valid(&tour)) {
+        ls_build_tour_from_scores(instance, &tour, instance->profits,
+                                  -INFINITY);
+        ls_optimize(instance, &tour, min_num_visited);
+
+        int32_t num_visited = 0;
+        for (int32_t i = 0; i < n; i++) {
+            num_visited += tour.comp[i] == 0;
+        }
+        if (num_visited >= min_num_visited) {
+            result = tour_eval(instance, &tour);
+        }
+    }
+
+    tour_destroy(&tour);
+    return result;
+}
+
+static bool build_reduced_instance(const Instance *instance,
+                                   InstancePresolve *presolve, int32_t m) {
+    const int32_t n = instance->num_customers + 1;
+    const int32_t *orig = presolve->orig_index;
+    Instance *reduced = &presolve->reduced;
+
+    reduced->num_customers = m - 1;
+    reduced->num_vehicles = instance->num_vehicles;
+    reduced->vehicle_cap = instance->vehicle_cap;
+    reduced->rounding_strat = instance->rounding_strat;
+    if (instance->name) {
+        instance_set_name(reduced, instance->name);
+    }
+
+    reduced->demands = malloc(m * sizeof(*reduced->demands));
+    reduced->profits = malloc(m * sizeof(*reduced->profits));
+    if (!reduced->demands || !reduced->profits) {
+        return false;
+    }
+
+    for (int32_t k = 0; k < m; k++) {
+        reduced->demands[k] = instance->demands[orig[k]];
+        reduced->profits[k] = instance->profits[orig[k]];
+    }
+
+    if (instance->positions) {
+        reduced->positions = malloc(m * sizeof(*reduced->positions));
+        if (!reduced->positions) {
+            return false;
+        }
+        for (int32_t k = 0; k < m; k++) {
+            reduced->positions[k] = instance->positions[orig[k]];
+        }
+    }
+
+    if (instance->edge_weight) {
+        reduced->edge_weight =
+            malloc(hm_nentries(m) * sizeof(*reduced->edge_weight));
+        if (!reduced->edge_weight) {
+            return false;
+        }
+        for (int32_t a = 0; a < m; a++) {
+            for (int32_t b = a + 1; b < m; b++) {
+                reduced->edge_weight[sxpos(m, a, b)] =
+                    instance->edge_weight[sxpos(n, orig[a], orig[b])];
+            }
+        }
+    }
+
+    return true;
+}
+
+bool instance_presolve(const Instance *instance, double upper_bound,
+                       int32_t min_num_visited, InstancePresolve *presolve) {
+    bool result = true;
+    const int32_t n = instance->num_customers + 1;
+    const double Q = instance->vehicle_cap;
+    const double *q = instance->demands;
+    const double *p = instance->profits;
+
+    memset(presolve, 0, sizeof(*presolve));
+
+    double *sp = malloc(n * sizeof(*sp));
+    double *knap = malloc(n * sizeof(*knap));
+    KnapsackItem *items = malloc(n * sizeof(*items));
+    presolve->orig_index = malloc(n * sizeof(*presolve->orig_index));
+
+    if (!sp || !knap || !items || !presolve->orig_index ||
+        !depot_shortest_paths(instance, sp)) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        result = false;
+        goto terminate;
+    }
+
+    presolve->upper_bound =
+        MIN(upper_bound, local_search_upper_bound(instance, min_num_visited));
+
+    int32_t num_items = 0;
+    for (int32_t j = 1; j < n; j++) {
+        if (p[j] > 0.0) {
+            items[num_items].node = j;
+            items[num_items].ratio = q[j] > 0.0 ? p[j] / q[j] : INFINITY;
+            ++num_items;
+        }
+    }
+    qsort(items, num_items, sizeof(*items), cmp_knapsack_item_desc);
+
+    // NOTE(dparo):
+    //      Any tour visiting `i` travels at least `2 * sp[i]`. A customer is
+    //      removed only if its lower bound is strictly worse than the upper
+    //      bound: the customers of the tour achieving the upper bound are all
+    //      kept, and so are the customers of any optimal tour.
+    int32_t m = 1;
+    presolve->orig_index[0] = 0;
+    for (int32_t i = 1; i < n; i++) {
+        if (q[0] + q[i] > Q) {
+            ++presolve->num_removed_by_capacity;
+            continue;
+        }
+        knap[i] = knapsack_profit_bound(instance, items, num_items, i);
+        double lb = 2.0 * sp[i] - p[0] - p[i] - knap[i];
+        if (lb > presolve->upper_bound + COST_TOLERANCE) {
+            ++presolve->num_removed_by_bound;
+            continue;
+        }
+        presolve->orig_index[m++] = i;
+    }
+
+    if (!build_reduced_instance(instance, presolve, m)) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        result = false;
+        goto terminate;
+    }
+
+    // Implied bounds: customers that cannot be adjacent in an improving tour
+    for (int32_t a = 1; a < m; a++) {
+        const int32_t i = presolve->orig_index[a];
+        for (int32_t b = a + 1; b < m; b++) {
+            const int32_t j = presolve->orig_index[b];
+            bool forbidden = q[0] + q[i] + q[j] > Q;
+            if (!forbidden) {
+                double lb = sp[i] + cptp_dist(instance, i, j) + sp[j] - p[0] -
+                            p[i] - p[j] - knap[i];
+                forbidden = lb > presolve->upper_bound + COST_TOLERANCE;
+            }
+            if (forbidden) {
+                arrput(presolve->forbidden_edges, a);
+                arrput(presolve->forbidden_edges, b);
+            }
+        }
+    }
+
+    log_info("%s :: upper_bound = %f, removed %d customers by capacity and %d "
+             "by bound (%d out of %d left), %td forbidden edges",
+             __func__, presolve->upper_bound,
+             presolve->num_removed_by_capacity, presolve->num_removed_by_bound,
+             m - 1, n - 1, arrlen(presolve->forbidden_edges) / 2);
+
+terminate:
+    free(sp);
+    free(knap);
+    free(items);
+    if (!result) {
+        instance_presolve_destroy(presolve);
+    }
+    return result;
+}
+
+void instance_presolve_destroy(InstancePresolve *presolve) {
+    instance_destroy(&presolve->reduced);
+    free(presolve->orig_index);
+    arrfree(presolve->forbidden_edges);
+    memset(presolve, 0, sizeof(*presolve));
+}
+
+void presolve_map_tour(const InstancePresolve *presolve, const Tour *reduced,
+                       Tour *orig) {
+    const int32_t m = presolve->reduced.num_customers + 1;
+    const int32_t *orig_index = presolve->orig_index;
+
+    tour_clear(orig);
+    orig->num_comps = reduced->num_comps;
+    for (int32_t k = 0; k < m; k++) {
+        if (reduced->comp[k] >= 0) {
+            orig->comp[orig_index[k]] = reduced->comp[k];
+            orig->succ[orig_index[k]] = orig_index[reduced->succ[k]];
+        }
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2022 Davide Paro
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#if __cplusplus
+extern "C" {
+#endif
+
+#include "core.h"
+
+/// Result of the presolve of an instance: a reduced instance, not containing
+/// the customers that cannot be part of any tour cheaper than a known upper
+/// bound, and the map back to the original instance.
+typedef struct {
+    /// Node `k` of the reduced instance is node `orig_index[k]` of the
+    /// original one. The depot is never removed: `orig_index[0] == 0`.
+    Instance reduced;
+    int32_t *orig_index;
+    /// Pairs of (reduced) customers which cannot be adjacent in a tour
+    /// cheaper than `upper_bound`. Edge `k` links `forbidden_edges[2 * k]`
+    /// and `forbidden_edges[2 * k + 1]`. (stb_ds array)
+    int32_t *forbidden_edges;
+    /// Upper bound used for the eliminations: the input one, possibly
+    /// improved by a local search tour.
+    double upper_bound;
+    int32_t num_removed_by_capacity;
+    int32_t num_removed_by_bound;
+} InstancePresolve;
+
+/// Removes from `instance` the customers whose demand does not fit the
+/// vehicle, and the customers whose cost lower bound exceeds `upper_bound`.
+/// The lower bound of a tour visiting customer `i` accounts for the round trip
+/// from the depot along shortest paths, minus the profit of `i` and the best
+/// fractional knapsack of the profits of the other customers.
+/// `min_num_visited` is the minimum number of nodes, depot included, of a
+/// feasible tour, and is used for the local search tour improving
+/// `upper_bound`.
+bool instance_presolve(const Instance *instance, double upper_bound,
+                       int32_t min_num_visited, InstancePresolve *presolve);
+void instance_presolve_destroy(InstancePresolve *presolve);
+
+/// Maps the tour `reduced` of the presolved instance into `orig`, a tour of
+/// the original instance.
+void presolve_map_tour(const InstancePresolve *presolve, const Tour *reduced,
+                       Tour *orig);
+
+#if __cplusplus
+}
+#endif
@@ -33,9 +33,26 @@ static const SolverDescriptor MIP_SOLVER_DESCRIPTOR = {
     {
         {"SCRIND", TYPED_PARAM_BOOL, "false",
          "Enable or disable (default) CPLEX SCRIND and MIPDISPLAY parameters"},
+        {"VAR_NAMES", TYPED_PARAM_BOOL, "false",
+         "Attach human readable names to the MIP rows and columns (eg "
+         "`x(i,j)`, `deg(i)`). Useful for debugging LP files, but slows down "
+         "the model construction"},
         {"NUM_THREADS", TYPED_PARAM_INT32, "0",
          "Set the number of threads to use. Default 0, means autodetect based "
          "on the number of cores available"},
+        {"DET_TIMELIMIT", TYPED_PARAM_DOUBLE, "0",
+         "Deterministic time limit, in CPLEX ticks (CPX_PARAM_DETTILIM), for "
+         "reproducible benchmarking. CPLEX runs in deterministic parallel "
+         "mode, and the work spent by our own phases (warm start, max-flow, "
+         "separation) is accounted in ticks as well, and reported together "
+         "with the solution. The wall clock time limit still applies. "
+         "Default 0 disables it"},
+        {"PORTFOLIO_SIZE", TYPED_PARAM_INT32, "1",
+         "Number of MIP solvers run concurrently, each one on a disjoint "
+         "subset of the threads, with its own random seed and search settings. "
+         "The members share their incumbents, and the first one to terminate "
+         "(eg proving optimality, or finding the pricing tours) stops the "
+         "others. Default 1 disables the portfolio"},
         {"APPLY_UPPER_CUTOFF", TYPED_PARAM_BOOL, "false",
          "Apply upper cutoff value (CPX_PARAM_CUTUP) by using the "
          "zero_reduced_cost_threshold"},
@@ -44,20 +61,94 @@ static const SolverDescriptor MIP_SOLVER_DESCRIPTOR = {
          "trivially computed lower bound for the objective function"},
         {"ENFORCE_STRONG_BRANCHING", TYPED_PARAM_BOOL, "false",
          "Force CPLEX to opt for strong branching decisions"},
+        {"BRANCHING_STRATEGY", TYPED_PARAM_INT32, "0",
+         "Custom branching strategy. 0: CPLEX default (the branching callback "
+         "is not subscribed), 1: branch on the number of visited customers, "
+         "2: pseudo-cost branching on the Y variables, 3: number of visited "
+         "customers first, then pseudo-cost"},
         {"APPLY_LB_HEUR", TYPED_PARAM_BOOL, "false",
          "Apply local branching heuristic (CPX_PARAM_LBHEUR) to try to improve "
          "new incumbents found during a MIP search."},
         {"HEUR_PRICER_MODE", TYPED_PARAM_BOOL, "false",
          "Behave as an heuristic pricer. Terminate solution process as soon as "
          "a reduced cost route, without proving its optimality."},
+        {"PRICER_NUM_TOURS", TYPED_PARAM_INT32, "1",
+         "Number of distinct negative reduced cost tours to collect from the "
+         "warm start, the incumbents and the solution pool. They are returned "
+         "sorted by cost together with the solution. In HEUR_PRICER_MODE the "
+         "solver stops as soon as this many tours are found"},
         {"INS_HEUR_WARM_START", TYPED_PARAM_BOOL, "true",
          "Warm start the MIP solver by using an insertion heuristic for "
          "finding an initial solution"},
+        {"WARM_START_EFFORT", TYPED_PARAM_INT32, "0",
+         "CPLEX effort level (CPX_MIPSTART_*) for the warm start solutions. "
+         "0: auto, 1: check feasibility, 2: solve fixed, 3: solve sub-MIP, "
+         "4: repair, 5: no check. The warm starts list the X variables of "
+         "the tour edges and all the Y variables only (the remaining ones are "
+         "implied by the degree constraints), except for 5 which requires "
+         "complete MIP starts"},
+        {"WARM_START_NUM_TOURS", TYPED_PARAM_INT32, "16",
+         "Number of best distinct tours, among the ones found by the "
+         "multi-start insertion heuristic, that are fed to CPLEX as warm "
+         "starts. The starts are distributed over `NUM_THREADS` threads, "
+         "and the selected tours do not depend on the number of threads"},
+        {"WARM_START_TIME_FRACTION", TYPED_PARAM_DOUBLE, "0.1",
+         "Fraction of the time limit (or of `DET_TIMELIMIT`, when given) "
+         "granted to the warm start. The starting customers are sampled by "
+         "decreasing priority, and the warm start stops early when the budget "
+         "runs out or when the recent starts no longer improve the best "
+         "tours. A value <= 0, without a `WARM_START_MAX_TIME`, runs every "
+         "start to completion"},
+        {"WARM_START_MAX_TIME", TYPED_PARAM_DOUBLE, "0",
+         "If > 0, absolute cap in seconds to the wall clock time of the warm "
+         "start (see `WARM_START_TIME_FRACTION`)"},
         {"APPLY_POLISHING_AFTER_WARM_START", TYPED_PARAM_BOOL, "false",
          "Polish the initial warm start solutions right away before "
          "beginning "
          "the Branch&Cut procedure"},
 
+        {"SPARSE_FORMULATION_KNN", TYPED_PARAM_INT32, "0",
+         "If > 0, build a sparse formulation whose X variables initially are "
+         "only the edges connecting each vertex to its K nearest neighbours "
+         "(plus the depot edges). Pruned edges are priced in against the LP "
+         "duals of the degree constraints before starting the Branch&Cut. "
+         "Only the LP shrinks: the complete edge index and the separation "
+         "still take O(n^2) memory. Default 0 builds the complete "
+         "formulation"},
+        {"REDUCED_COST_FIXING", TYPED_PARAM_BOOL, "false",
+         "Fix to zero the variables whose reduced cost in the root LP "
+         "relaxation, strengthened by the fractional cuts, exceeds the gap "
+         "between the incumbent (the worst of the PRICER_NUM_TOURS tours) and "
+         "the root bound. Whenever the incumbent improves, the separation "
+         "networks drop the nodes that became fixable"},
+        {"PRESOLVE", TYPED_PARAM_BOOL, "false",
+         "Before building the model, remove the customers that cannot be part "
+         "of a tour cheaper than a local search tour (or than the upper "
+         "cutoff), and forbid the edges that cannot be part of such a tour. "
+         "The tours are mapped back to the original instance"},
+        {"RELAXATION_HEUR_FREQ", TYPED_PARAM_INT32, "0",
+         "Primal heuristic run from the relaxation callback: round the LP "
+         "point by Y value, improve it with 2-opt and add/drop moves, and post "
+         "it if it improves the incumbent. It runs at every cut round of the "
+         "root node and at every node whose count is a multiple of this value. "
+         "0 disables it"},
+        {"HEUR_THREAD", TYPED_PARAM_BOOL, "false",
+         "Run an iterated local search on a dedicated thread (taken away from "
+         "CPLEX, when more than one is available) for the whole Branch&Cut. "
+         "Its improving tours are injected as CPLEX incumbents, and it "
+         "restarts from the CPLEX incumbents and drops the customers fixed by "
+         "the REDUCED_COST_FIXING. Ignored with a DET_TIMELIMIT"},
+        {"LIN_KERNIGHAN", TYPED_PARAM_BOOL, "false",
+         "Refine the routes of the warm start and of the HEUR_THREAD with a "
+         "Lin-Kernighan style search instead of 2-opt and Or-opt moves, and "
+         "polish with it the route of the final solution when its optimality "
+         "is not proven"},
+        {"LP_BOUND_MODE", TYPED_PARAM_BOOL, "false",
+         "Do not branch: solve the LP relaxation with our own cutting plane "
+         "loop over the fractional cuts, and report the resulting dual bound, "
+         "the bound of each round and the fractional point"},
+        {"LP_BOUND_MAX_ROUNDS", TYPED_PARAM_INT32, "100",
+         "Maximum number of cutting plane rounds of the LP_BOUND_MODE"},
         {"AMORTIZED_FRACTIONAL_LABELING", TYPED_PARAM_BOOL, "false",
          "Amortize the min-cut/max-flow fractional labeling over multiple "
          "iterations."
@@ -66,6 +157,9 @@ static const SolverDescriptor MIP_SOLVER_DESCRIPTOR = {
         {"GSEC_CUTS", TYPED_PARAM_BOOL, "true", "Enable GSEC cut separation"},
         {"GLM_CUTS", TYPED_PARAM_BOOL, "true", "Enable GLM cuts separation"},
         {"RCI_CUTS", TYPED_PARAM_BOOL, "true", "Enable RCI cuts separation"},
+        {"COMB_CUTS", TYPED_PARAM_BOOL, "false",
+         "Enable comb (2-matching) cuts separation. Combs are separated "
+         "for fractional solutions only"},
         {"DISABLE_FRACTIONAL_SEPARATION", TYPED_PARAM_BOOL, "false",
          "Disable any form of labeling and separation for fractional "
          "solutions. Disables the CPLEX callback entirely."},
@@ -78,6 +172,81 @@ static const SolverDescriptor MIP_SOLVER_DESCRIPTOR = {
         {"RCI_FRAC_CUTS", TYPED_PARAM_BOOL, "true",
          "Enable RCI cut separation for fractional solutions. Param "
          "`RCI_CUTS` must also be enabled for this to take effect."},
+        {"COMB_FRAC_CUTS", TYPED_PARAM_BOOL, "true",
+         "Enable comb cut separation for fractional solutions. Param "
+         "`COMB_CUTS` must also be enabled for this to take effect."},
+        {0},
+    }};
+
+static const SolverDescriptor ILS_SOLVER_DESCRIPTOR = {
+    "ils",
+    {
+        {"MAX_ITERATIONS", TYPED_PARAM_INT32, "10000",
+         "Number of perturbation and local search iterations. 0 runs up until "
+         "the time limit"},
+        {"MAX_TIME", TYPED_PARAM_DOUBLE, "0",
+         "If > 0, cap in seconds to the wall clock time of the search, in "
+         "addition to the time limit"},
+        {"PERTURBATION_STRENGTH", TYPED_PARAM_INT32, "0",
+         "Maximum number of customers dropped (and inserted), and of segments "
+         "reversed, by each perturbation. The strength cycles from 1 up to "
+         "this value. Default 0 picks it from the number of customers"},
+        {"PRICER_NUM_TOURS", TYPED_PARAM_INT32, "1",
+         "Number of distinct negative cost tours, among the local optima "
+         "visited by the search, returned sorted by cost together with the "
+         "solution"},
+        {0},
+    }};
+
+static const SolverDescriptor DP_SOLVER_DESCRIPTOR = {
+    "dp",
+    {
+        {"NG_SIZE", TYPED_PARAM_INT32, "8",
+         "Size of the initial ng-neighborhoods: each customer and its nearest "
+         "customers. In [1, 64]"},
+        {"DSSR", TYPED_PARAM_BOOL, "true",
+         "While the best ng-route is not elementary, grow the "
+         "ng-neighborhoods along its cycles and repeat the labeling. When "
+         "disabled, the ng-route relaxation bound is reported as the dual "
+         "bound after a single labeling"},
+        {"COMPLETION_BOUNDS", TYPED_PARAM_BOOL, "true",
+         "Prune the labels which cannot beat the best elementary route, "
+         "according to a q-path lower bound on the cost of getting back to "
+         "the depot"},
+        {"MAX_NUM_LABELS", TYPED_PARAM_INT32, "10000000",
+         "Maximum number of labels of a labeling. The solver stops when it is "
+         "exceeded"},
+        {0},
+    }};
+
+static const SolverDescriptor HGS_SOLVER_DESCRIPTOR = {
+    "hgs",
+    {
+        {"NUM_THREADS", TYPED_PARAM_INT32, "0",
+         "Number of threads, each evolving its own island population. "
+         "Default 0 uses all the cores"},
+        {"POPULATION_SIZE", TYPED_PARAM_INT32, "25",
+         "Number of individuals of each island surviving a selection"},
+        {"GENERATION_SIZE", TYPED_PARAM_INT32, "40",
+         "Number of offspring generated by each island before a survivors "
+         "selection"},
+        {"NUM_ELITES", TYPED_PARAM_INT32, "4",
+         "Number of individuals protected from the survivors selection by "
+         "their cost alone, irrespective of their diversity contribution"},
+        {"MAX_ITERATIONS_NO_IMPROVEMENT", TYPED_PARAM_INT32, "5000",
+         "An island stops after this many offspring not improving its best "
+         "tour. 0 runs up until the time limit"},
+        {"MIGRATION_PERIOD", TYPED_PARAM_INT32, "200",
+         "Number of offspring generated by an island in between two "
+         "exchanges of best tours with the neighboring islands. 0 disables "
+         "the migrations"},
+        {"MAX_TIME", TYPED_PARAM_DOUBLE, "0",
+         "If > 0, cap in seconds to the wall clock time of the search, in "
+         "addition to the time limit"},
+        {"PRICER_NUM_TOURS", TYPED_PARAM_INT32, "1",
+         "Number of distinct negative cost tours, among the final "
+         "populations of the islands, returned sorted by cost together with "
+         "the solution"},
         {0},
     }};
 
@@ -88,6 +257,12 @@ static const SolverDescriptor STUB_SOLVER_DESCRIPTOR = {"stub",
 
 Solver mip_solver_create(const Instance *instance, SolverTypedParams *tparams,
                          double timelimit, int32_t seed);
+Solver ils_solver_create(const Instance *instance, SolverTypedParams *tparams,
+                         double timelimit, int32_t randomseed);
+Solver dp_solver_create(const Instance *instance, SolverTypedParams *tparams,
+                        double timelimit, int32_t randomseed);
+Solver hgs_solver_create(const Instance *instance, SolverTypedParams *tparams,
+                         double timelimit, int32_t randomseed);
 Solver stub_solver_create(const Instance *instance, SolverTypedParams *tparams,
                           double timelimit, int32_t randomseed);
 
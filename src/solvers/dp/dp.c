@@ -0,0 +1,707 @@
+/*
+ * Copyright (c) 2022 Davide Paro
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "solvers.h"
+#include "core-utils.h"
+#include "local-search.h"
+#include "validation.h"
+
+// NOTE(dparo):
+//      Labeling algorithm for the ESPPRC (the pricing problem this project
+//      solves with the Branch&Cut), with the ng-route relaxation.
+//      A label is a path from the depot, with its cost (travel distance
+//      minus the collected profits), its load, and its ng-memory: the
+//      customers the path cannot go back to. The memory of a path ending in
+//      `i` is a subset of the ng-neighborhood ng(i) of `i`, and it is stored
+//      as a bitmask over the positions of ng(i).
+//      Labels are extended by increasing load (the capacity resource), and
+//      the labels of each node are kept in buckets of load: a new label
+//      only checks the buckets of lighter labels for being dominated, and the
+//      buckets of heavier labels for dominating them. A bucket stores the
+//      dominance keys contiguously, so the checks scan plain memory.
+//      Labels whose completion bound (a lower bound on the cost of getting
+//      back to the depot with the residual capacity, see compute_bounds())
+//      cannot beat the best elementary route are pruned.
+//      Since the ng-routes may contain cycles, the best ng-route only gives a
+//      lower bound. When it is not elementary, the nodes of each of its
+//      cycles are added to the ng-neighborhoods of the nodes along the cycle
+//      (decremental state space relaxation) and the labeling is repeated,
+//      up until the best route is elementary or the neighborhoods are full.
+//      The labeling is mono-directional: the distances are symmetric, but
+//      joining forward and backward ng-paths needs extra memory checks that
+//      do not pay off for the instance sizes we target.
+
+/// The routes visit at least 2 customers, as in the MIP formulation (an
+/// edge cannot be traversed twice).
+#define DP_MIN_NUM_CUSTOMERS (2)
+
+/// ng-memories are 64 bit masks
+#define DP_MAX_NG_SIZE (64)
+
+/// Number of load buckets per node
+#define DP_NUM_BUCKETS (64)
+
+/// Upper bound on the number of states (residual capacity units times the
+/// number of edges) of the completion bounds computation
+#define DP_MAX_BOUND_STATES (INT64_C(1) << 27)
+
+/// The time limit is checked every this many processed labels
+#define DP_CHECK_TIME_PERIOD (4096)
+
+typedef struct {
+    double cost;
+    double load;
+    uint64_t mem;
+    int32_t node;
+    /// Index of the label this one extends, -1 for the root label
+    int32_t pred;
+    int32_t num_customers;
+    bool dead;
+} DpLabel;
+
+/// Dominance keys of a label, as stored in the buckets
+typedef struct {
+    double cost;
+    double load;
+    uint64_t mem;
+    int32_t label;
+    bool can_close;
+} DpBucketEntry;
+
+struct SolverData {
+    int32_t n;
+    int32_t ng_size;
+    int32_t max_num_labels;
+    bool dssr;
+    bool completion_bounds;
+    double timelimit;
+    /// Distance matrix, row major
+    double *dist;
+};
+
+typedef struct {
+    Solver *solver;
+    const Instance *instance;
+    const double *dist;
+    int32_t n;
+    int64_t begin_time;
+
+    /// ng-neighborhoods: the nodes of ng(i) are
+    /// `ng_nodes[i * DP_MAX_NG_SIZE]`, ..., and `ng_pos[i * n + v]` is the
+    /// position of `v` in ng(i), -1 if `v` is not part of it
+    int32_t *ng_nodes;
+    int32_t *ng_len;
+    int8_t *ng_pos;
+
+    /// Completion bounds: `bound[u * n + i]` is a lower bound on the cost of
+    /// the paths from `i` back to the depot using at most `u` capacity units
+    /// of size `unit`. NULL when disabled
+    double *bound;
+    int32_t *units;
+    int32_t num_units;
+    double unit;
+
+    /// (stb_ds arrays)
+    DpLabel *labels;
+    /// Entries of the labels of each node, by load bucket, sorted by
+    /// increasing cost
+    DpBucketEntry **buckets;
+    int32_t *open[DP_NUM_BUCKETS];
+    bool out_of_labels;
+
+    /// Best ng-route of the current round, elementary or not
+    double relaxed_cost;
+    int32_t relaxed_label;
+
+    /// Best elementary route found so far, as the sequence of its customers
+    /// (stb_ds array)
+    int32_t *best_route;
+    double best_cost;
+
+    int32_t *stamp;
+    int32_t curr_stamp;
+} DpSearch;
+
+static inline double dp_dist(const DpSearch *s, int32_t i, int32_t j) {
+    return s->dist[(size_t)i * s->n + j];
+}
+
+static inline int32_t load_bucket(const DpSearch *s, double load) {
+    int32_t b =
+        (int32_t)(load / s->instance->vehicle_cap * (double)DP_NUM_BUCKETS);
+    return CLAMP_MAX(CLAMP_MIN(b, 0), DP_NUM_BUCKETS - 1);
+}
+
+static inline bool is_excluded(const Instance *instance, int32_t i) {
+    return !isfinite(instance->profits[i]);
+}
+
+static bool ng_add(DpSearch *s, int32_t i, int32_t v) {
+    int8_t *pos = &s->ng_pos[(size_t)i * s->n + v];
+    if (*pos >= 0 || s->ng_len[i] >= DP_MAX_NG_SIZE) {
+        return false;
+    }
+    *pos = (int8_t)s->ng_len[i];
+    s->ng_nodes[(size_t)i * DP_MAX_NG_SIZE + s->ng_len[i]] = v;
+    ++s->ng_len[i];
+    return true;
+}
+
+/// Initial ng-neighborhoods: each customer and its `ng_size - 1` nearest
+/// customers
+static void ng_init(DpSearch *s, int32_t ng_size) {
+    const int32_t n = s->n;
+    int32_t nearest[DP_MAX_NG_SIZE];
+
+    memset(s->ng_pos, -1, (size_t)n * n * sizeof(*s->ng_pos));
+    memset(s->ng_len, 0, n * sizeof(*s->ng_len));
+
+    for (int32_t i = 1; i < n; i++) {
+        ng_add(s, i, i);
+
+        // Bounded insertion sort of the nearest customers
+        int32_t cnt = 0;
+        for (int32_t j = 1; j < n && ng_size > 1; j++) {
+            if (j == i) {
+                continue;
+            }
+            double d = dp_dist(s, i, j);
+            if (cnt == ng_size - 1 && !(d < dp_dist(s, i, nearest[cnt - 1]))) {
+                continue;
+            }
+            int32_t k = MIN(cnt, ng_size - 2);
+            while (k > 0 && d < dp_dist(s, i, nearest[k - 1])) {
+                nearest[k] = nearest[k - 1];
+                --k;
+            }
+            nearest[k] = j;
+            cnt = MIN(cnt + 1, ng_size - 1);
+        }
+
+        for (int32_t k = 0; k < cnt; k++) {
+            ng_add(s, i, nearest[k]);
+        }
+    }
+}
+
+/// Memory of the extension to `j` of a path ending in `i` with memory `mem`
+static inline uint64_t ng_extend(const DpSearch *s, int32_t i, uint64_t mem,
+                                 int32_t j) {
+    const int8_t *pos_j = &s->ng_pos[(size_t)j * s->n];
+    const int32_t *nodes_i = &s->ng_nodes[(size_t)i * DP_MAX_NG_SIZE];
+    uint64_t result = UINT64_C(1) << pos_j[j];
+
+    while (mem) {
+        int32_t b = __builtin_ctzll(mem);
+        mem &= mem - 1;
+        int8_t p = pos_j[nodes_i[b]];
+        if (p >= 0) {
+            result |= UINT64_C(1) << p;
+        }
+    }
+    return result;
+}
+
+// NOTE(dparo):
+//      The completion bounds are the costs of the q-paths (paths which may
+//      visit a customer multiple times) back to the depot. Rounding the
+//      demands down to multiples of the smallest demand, and the residual
+//      capacity down as well, every elementary completion is also a q-path:
+//      the bound is valid. Every customer takes at least one unit, such that
+//      the q-paths cannot cycle forever.
+static bool compute_bounds(DpSearch *s) {
+    const Instance *instance = s->instance;
+    const int32_t n = s->n;
+
+    double min_demand = INFINITY;
+    for (int32_t i = 1; i < n; i++) {
+        if (!is_excluded(instance, i)) {
+            min_demand = MIN(min_demand, instance->demands[i]);
+        }
+    }
+    if (!(min_demand > 0.0) || !isfinite(min_demand)) {
+        return false;
+    }
+
+    s->unit = min_demand;
+    s->num_units = (int32_t)MIN(floor(instance->vehicle_cap / s->unit + 1e-9),
+                                (double)INT32_MAX - 1);
+    if ((int64_t)(s->num_units + 1) * n * n > DP_MAX_BOUND_STATES) {
+        return false;
+    }
+
+    s->units = malloc(n * sizeof(*s->units));
+    s->bound = malloc((size_t)(s->num_units + 1) * n * sizeof(*s->bound));
+    if (!s->units || !s->bound) {
+        return false;
+    }
+
+    for (int32_t i = 0; i < n; i++) {
+        s->units[i] = (int32_t)floor(instance->demands[i] / s->unit);
+    }
+
+    for (int32_t u = 0; u <= s->num_units; u++) {
+        double *bound_u = &s->bound[(size_t)u * n];
+        bound_u[0] = 0.0;
+        for (int32_t i = 1; i < n; i++) {
+            double h = dp_dist(s, i, 0);
+            for (int32_t v = 1; v < n; v++) {
+                if (v == i || is_excluded(instance, v) || s->units[v] > u) {
+                    continue;
+                }
+                double c = dp_dist(s, i, v) - instance->profits[v] +
+                           s->bound[(size_t)(u - s->units[v]) * n + v];
+                h = MIN(h, c);
+            }
+            bound_u[i] = h;
+        }
+    }
+
+    return true;
+}
+
+static inline double completion_bound(const DpSearch *s, int32_t i,
+                                      double load) {
+    double residual = s->instance->vehicle_cap - load;
+    int32_t u = (int32_t)MIN(floor(residual / s->unit + 1e-9), s->num_units);
+    return s->bound[(size_t)MAX(u, 0) * s->n + i];
+}
+
+/// Appends to `route` (cleared first) the customers of the path of `label`
+static void path_of(const DpSearch *s, int32_t label, int32_t **route) {
+    arrsetlen(*route, 0);
+    for (int32_t l = label; s->labels[l].node != 0; l = s->labels[l].pred) {
+        arrput(*route, s->labels[l].node);
+    }
+
+    ptrdiff_t len = arrlen(*route);
+    for (ptrdiff_t i = 0; i < len / 2; i++) {
+        SWAP(int32_t, (*route)[i], (*route)[len - 1 - i]);
+    }
+}
+
+static bool is_elementary_path(DpSearch *s, int32_t label) {
+    ++s->curr_stamp;
+    for (int32_t l = label; s->labels[l].node != 0; l = s->labels[l].pred) {
+        int32_t v = s->labels[l].node;
+        if (s->stamp[v] == s->curr_stamp) {
+            return false;
+        }
+        s->stamp[v] = s->curr_stamp;
+    }
+    return true;
+}
+
+static void push_label(DpSearch *s, int32_t node, double cost, double load,
+                       uint64_t mem, int32_t pred, int32_t num_customers) {
+    if (s->bound && cost + completion_bound(s, node, load) >=
+                        s->best_cost - COST_TOLERANCE) {
+        return;
+    }
+
+    const bool can_close = num_customers >= DP_MIN_NUM_CUSTOMERS;
+    const int32_t b = load_bucket(s, load);
+    DpBucketEntry **buckets = &s->buckets[(size_t)node * DP_NUM_BUCKETS];
+
+    // Is the new label dominated by a lighter one? Only the entries not
+    // costlier than the new label may dominate it. The buckets of the
+    // closest loads are the most likely to.
+    for (int32_t k = b; k >= 0; k--) {
+        const DpBucketEntry *entries = buckets[k];
+        const ptrdiff_t len = arrlen(entries);
+        for (ptrdiff_t e = 0; e < len && entries[e].cost <= cost; e++) {
+            if (entries[e].load <= load && (entries[e].mem & ~mem) == 0 &&
+                (entries[e].can_close || !can_close)) {
+                return;
+            }
+        }
+    }
+
+    // Does the new label dominate heavier ones? Only the entries not
+    // cheaper than the new label may be dominated.
+    for (int32_t k = b; k < DP_NUM_BUCKETS; k++) {
+        DpBucketEntry *entries = buckets[k];
+        const ptrdiff_t len = arrlen(entries);
+        ptrdiff_t first = len;
+        while (first > 0 && entries[first - 1].cost >= cost) {
+            --first;
+        }
+
+        ptrdiff_t w = first;
+        for (ptrdiff_t e = first; e < len; e++) {
+            if (load <= entries[e].load && (mem & ~entries[e].mem) == 0 &&
+                (can_close || !entries[e].can_close)) {
+                s->labels[entries[e].label].dead = true;
+            } else {
+                entries[w++] = entries[e];
+            }
+        }
+        arrsetlen(buckets[k], w);
+    }
+
+    if (arrlen(s->labels) >= s->solver->data->max_num_labels) {
+        s->out_of_labels = true;
+        return;
+    }
+
+    DpLabel label = {cost, load, mem, node, pred, num_customers, false};
+    DpBucketEntry entry = {cost, load, mem, (int32_t)arrlen(s->labels),
+                           can_close};
+    arrput(buckets[b], entry);
+    DpBucketEntry *entries = buckets[b];
+    for (ptrdiff_t e = arrlen(entries) - 1; e > 0; e--) {
+        if (entries[e - 1].cost <= cost) {
+            break;
+        }
+        SWAP(DpBucketEntry, entries[e - 1], entries[e]);
+    }
+    arrput(s->open[b], entry.label);
+    arrput(s->labels, label);
+}
+
+/// Closes the path of `label_idx` back to the depot
+static void close_path(DpSearch *s, int32_t label_idx) {
+    const DpLabel *label = &s->labels[label_idx];
+    if (label->num_customers < DP_MIN_NUM_CUSTOMERS) {
+        return;
+    }
+
+    double cost = label->cost + dp_dist(s, label->node, 0);
+    if (cost < s->relaxed_cost) {
+        s->relaxed_cost = cost;
+        s->relaxed_label = label_idx;
+    }
+    if (cost < s->best_cost - COST_TOLERANCE &&
+        is_elementary_path(s, label_idx)) {
+        s->best_cost = cost;
+        path_of(s, label_idx, &s->best_route);
+    }
+}
+
+static void extend_label(DpSearch *s, int32_t label_idx) {
+    const Instance *instance = s->instance;
+    const DpLabel label = s->labels[label_idx];
+    const int32_t i = label.node;
+    const int8_t *pos_i = &s->ng_pos[(size_t)i * s->n];
+
+    for (int32_t j = 1; j < s->n; j++) {
+        if (j == i || is_excluded(instance, j) ||
+            label.load + instance->demands[j] > instance->vehicle_cap) {
+            continue;
+        }
+        if (i != 0 && pos_i[j] >= 0 && (label.mem >> pos_i[j]) & 1) {
+            continue;
+        }
+
+        uint64_t mem = i == 0 ? UINT64_C(1) << s->ng_pos[(size_t)j * s->n + j]
+                              : ng_extend(s, i, label.mem, j);
+        push_label(s, j, label.cost + dp_dist(s, i, j) - instance->profits[j],
+                   label.load + instance->demands[j], mem, label_idx,
+                   label.num_customers + 1);
+    }
+}
+
+/// One labeling pass with the current ng-neighborhoods. Returns the reason
+/// it stopped early, if any.
+static SolveStatus labeling(DpSearch *s) {
+    const Instance *instance = s->instance;
+    const int32_t n = s->n;
+
+    arrsetlen(s->labels, 0);
+    for (int32_t k = 0; k < n * DP_NUM_BUCKETS; k++) {
+        arrsetlen(s->buckets[k], 0);
+    }
+    for (int32_t b = 0; b < DP_NUM_BUCKETS; b++) {
+        arrsetlen(s->open[b], 0);
+    }
+    s->relaxed_cost = INFINITY;
+    s->relaxed_label = -1;
+
+    DpLabel root = {-instance->profits[0], instance->demands[0], 0, 0, -1, 0,
+                    false};
+    arrput(s->labels, root);
+    extend_label(s, 0);
+
+    int64_t num_processed = 0;
+
+    // NOTE(dparo):
+    //      Extensions never decrease the load, therefore they never go into
+    //      an already processed bucket. A bucket may grow while it is being
+    //      processed.
+    for (int32_t b = 0; b < DP_NUM_BUCKETS; b++) {
+        for (ptrdiff_t k = 0; k < arrlen(s->open[b]); k++) {
+            int32_t label_idx = s->open[b][k];
+            if (s->labels[label_idx].dead) {
+                continue;
+            }
+
+            close_path(s, label_idx);
+            extend_label(s, label_idx);
+
+            if (s->out_of_labels) {
+                return SOLVE_STATUS_ABORTION_RES_EXHAUSTED;
+            }
+            if (++num_processed % DP_CHECK_TIME_PERIOD == 0) {
+                if (s->solver->sigterm_occured) {
+                    return SOLVE_STATUS_ABORTION_SIGTERM;
+                }
+                if (os_get_elapsed_secs(s->begin_time) >=
+                    s->solver->data->timelimit) {
+                    return SOLVE_STATUS_ABORTION_RES_EXHAUSTED;
+                }
+            }
+        }
+    }
+
+    return SOLVE_STATUS_NULL;
+}
+
+/// Adds the customers visited more than once by `route` to the
+/// ng-neighborhoods of the customers of the cycles they close. Returns false
+/// if no neighborhood could grow.
+static bool ng_augment(DpSearch *s, const int32_t *route) {
+    const ptrdiff_t len = arrlen(route);
+    bool augmented = false;
+
+    for (ptrdiff_t t = 0; t < len; t++) {
+        for (ptrdiff_t p = t - 1; p >= 0; p--) {
+            if (route[p] == route[t]) {
+                for (ptrdiff_t q = p + 1; q < t; q++) {
+                    augmented |= ng_add(s, route[q], route[t]);
+                }
+                break;
+            }
+        }
+    }
+
+    return augmented;
+}
+
+/// Local search tour used as the initial upper bound
+static void seed_upper_bound(DpSearch *s) {
+    const Instance *instance = s->instance;
+    Tour tour = tour_create(instance);
+    if (!tour_is_valid(&tour)) {
+        return;
+    }
+
+    ls_build_tour_from_scores(instance, &tour, instance->profits, -INFINITY);
+    ls_optimize(instance, &tour, DP_MIN_NUM_CUSTOMERS + 1);
+
+    arrsetlen(s->best_route, 0);
+    for (int32_t v = tour.succ[0]; v != 0; v = tour.succ[v]) {
+        arrput(s->best_route, v);
+    }
+    if (arrlen(s->best_route) >= DP_MIN_NUM_CUSTOMERS) {
+        s->best_cost = tour_eval(instance, &tour);
+    } else {
+        arrsetlen(s->best_route, 0);
+    }
+
+    tour_destroy(&tour);
+}
+
+static void dp_search_destroy(DpSearch *s) {
+    free(s->ng_nodes);
+    free(s->ng_len);
+    free(s->ng_pos);
+    free(s->bound);
+    free(s->units);
+    free(s->stamp);
+    arrfree(s->labels);
+    if (s->buckets) {
+        for (int32_t k = 0; k < s->n * DP_NUM_BUCKETS; k++) {
+            arrfree(s->buckets[k]);
+        }
+        free(s->buckets);
+    }
+    for (int32_t b = 0; b < DP_NUM_BUCKETS; b++) {
+        arrfree(s->open[b]);
+    }
+    arrfree(s->best_route);
+}
+
+static SolveStatus solve(Solver *self, const Instance *instance,
+                         Solution *solution, int64_t begin_time) {
+    SolverData *data = self->data;
+    const int32_t n = instance->num_customers + 1;
+    SolveStatus status = SOLVE_STATUS_ERR;
+
+    DpSearch s = {0};
+    s.solver = self;
+    s.instance = instance;
+    s.dist = data->dist;
+    s.n = n;
+    s.begin_time = begin_time;
+    s.best_cost = INFINITY;
+    s.ng_nodes = malloc((size_t)n * DP_MAX_NG_SIZE * sizeof(*s.ng_nodes));
+    s.ng_len = malloc(n * sizeof(*s.ng_len));
+    s.ng_pos = malloc((size_t)n * n * sizeof(*s.ng_pos));
+    s.buckets = calloc((size_t)n * DP_NUM_BUCKETS, sizeof(*s.buckets));
+    s.stamp = calloc(n, sizeof(*s.stamp));
+    if (!s.ng_nodes || !s.ng_len || !s.ng_pos || !s.buckets || !s.stamp) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        goto terminate;
+    }
+
+    ng_init(&s, data->ng_size);
+    if (data->completion_bounds && !compute_bounds(&s)) {
+        log_warn("%s :: Completion bounds disabled", __func__);
+        free(s.bound);
+        s.bound = NULL;
+    }
+    seed_upper_bound(&s);
+
+    SolveStatus abortion = SOLVE_STATUS_NULL;
+    double lower_bound = -INFINITY;
+    bool closed = false;
+
+    for (int32_t round = 0; !closed; round++) {
+        abortion = labeling(&s);
+        if (abortion != SOLVE_STATUS_NULL) {
+            break;
+        }
+
+        // Labels that cannot beat the best elementary route were pruned
+        lower_bound = MAX(lower_bound, MIN(s.relaxed_cost, s.best_cost));
+        closed = s.best_cost <= lower_bound + COST_TOLERANCE;
+
+        log_info("%s :: round %d, %lld labels, lower bound %f, best route %f",
+                 __func__, round, (long long)arrlen(s.labels), lower_bound,
+                 s.best_cost);
+
+        if (!data->dssr) {
+            break;
+        }
+
+        if (!closed) {
+            int32_t *route = NULL;
+            path_of(&s, s.relaxed_label, &route);
+            bool augmented = ng_augment(&s, route);
+            arrfree(route);
+            if (!augmented) {
+                log_warn("%s :: The ng-neighborhoods cannot grow any further",
+                         __func__);
+                break;
+            }
+        }
+    }
+
+    status = abortion;
+    solution->dual_bound = lower_bound;
+    solution->det_ticks = -1.0;
+
+    if (isfinite(s.best_cost)) {
+        Tour *tour = &solution->tour;
+        tour_clear(tour);
+        tour->num_comps = 1;
+        int32_t prev = 0;
+        tour->comp[0] = 0;
+        for (ptrdiff_t k = 0; k < arrlen(s.best_route); k++) {
+            tour->succ[prev] = s.best_route[k];
+            tour->comp[s.best_route[k]] = 0;
+            prev = s.best_route[k];
+        }
+        tour->succ[prev] = 0;
+
+        solution->primal_bound = tour_eval(instance, tour);
+        validate_primal_solution(instance, solution, DP_MIN_NUM_CUSTOMERS + 1);
+        status |= SOLVE_STATUS_PRIMAL_SOLUTION_AVAIL;
+        if (closed) {
+            status |= SOLVE_STATUS_CLOSED_PROBLEM;
+        }
+    }
+
+terminate:
+    dp_search_destroy(&s);
+    return status;
+}
+
+/// Nothing depends on the profits but the search, which starts from scratch
+/// at each solve
+static bool update_profits(Solver *self, const Instance *instance) {
+    UNUSED_PARAM(self);
+    UNUSED_PARAM(instance);
+    return true;
+}
+
+static void destroy(Solver *self) {
+    if (self->data) {
+        free(self->data->dist);
+        free(self->data);
+    }
+    memset(self, 0, sizeof(*self));
+}
+
+Solver dp_solver_create(const Instance *instance, SolverTypedParams *tparams,
+                        double timelimit, int32_t randomseed) {
+    UNUSED_PARAM(randomseed);
+    const int32_t n = instance->num_customers + 1;
+
+    Solver solver = {0};
+    solver.solve = solve;
+    solver.update_profits = update_profits;
+    solver.destroy = destroy;
+    solver.data = calloc(1, sizeof(*solver.data));
+    if (!solver.data) {
+        goto fail;
+    }
+
+    SolverData *data = solver.data;
+    data->n = n;
+    data->ng_size = solver_params_get_int32(tparams, "NG_SIZE");
+    data->max_num_labels = solver_params_get_int32(tparams, "MAX_NUM_LABELS");
+    data->dssr = solver_params_get_bool(tparams, "DSSR");
+    data->completion_bounds =
+        solver_params_get_bool(tparams, "COMPLETION_BOUNDS");
+    data->timelimit = timelimit > 0 ? timelimit : INFINITY;
+
+    if (data->ng_size < 1 || data->ng_size > DP_MAX_NG_SIZE) {
+        log_fatal("%s :: Invalid NG_SIZE `%d` (must be in [1, %d])", __func__,
+                  data->ng_size, DP_MAX_NG_SIZE);
+        goto fail;
+    }
+    if (data->max_num_labels <= 0) {
+        log_fatal("%s :: Invalid MAX_NUM_LABELS `%d`", __func__,
+                  data->max_num_labels);
+        goto fail;
+    }
+
+    data->dist = malloc((size_t)n * n * sizeof(*data->dist));
+    if (!data->dist) {
+        goto fail;
+    }
+    for (int32_t i = 0; i < n; i++) {
+        data->dist[(size_t)i * n + i] = 0.0;
+        for (int32_t j = i + 1; j < n; j++) {
+            double d = cptp_dist(instance, i, j);
+            data->dist[(size_t)i * n + j] = d;
+            data->dist[(size_t)j * n + i] = d;
+        }
+    }
+
+    return solver;
+
+fail:
+    destroy(&solver);
+    return (Solver){0};
+}
@@ -0,0 +1,974 @@
+/*
+ * Copyright (c) 2022 Davide Paro
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pthread.h>
+
+#include "hgs.h"
+#include "solvers.h"
+#include "core-utils.h"
+#include "local-search.h"
+#include "validation.h"
+
+// NOTE(dparo):
+//      CPLEX free hybrid genetic search, after the HGS of Vidal for the CVRP,
+//      adapted to a single profitable tour.
+//      The chromosome of an individual is a giant tour: a permutation of the
+//      customers which can be served. The split decodes it into the cheapest
+//      tour visiting a subsequence of it, in order. The tour is then made
+//      capacity feasible and educated with the moves of local-search.h, and
+//      the giant tour is rewritten from the educated tour: each visited
+//      customer followed by some of the unvisited customers closest to it.
+//      This way the offspring inherit both the routing and the customer
+//      selection of their parents.
+//      Offspring are generated by order crossover (OX) of two parents picked
+//      by binary tournament on the biased fitness, which ranks the
+//      individuals both by cost and by contribution to the diversity (the
+//      average broken-pairs distance to the closest individuals). When the
+//      population reaches POPULATION_SIZE + GENERATION_SIZE individuals, the
+//      worst ones by biased fitness are discarded.
+//      Each thread evolves its own island population. Every MIGRATION_PERIOD
+//      iterations an island publishes its best tour, when improved, and
+//      imports the one published by the previous island of the ring.
+//      The solver proves nothing: the dual bound is left at -INFINITY.
+
+/// Minimum number of visited nodes (depot included) of the tours, as in the
+/// MIP formulation
+#define HGS_MIN_NUM_VISITED (3)
+
+/// Length of the candidate lists of the local search moves
+#define HGS_NUM_NEIGHBORS (25)
+
+/// Number of closest individuals the diversity contribution is averaged on
+#define HGS_NUM_CLOSE (5)
+
+/// The split links each customer of the giant tour to one of the
+/// HGS_SPLIT_WINDOW customers preceding it only
+#define HGS_SPLIT_WINDOW (32)
+
+/// Maximum number of unvisited customers following a visited one in a
+/// rewritten giant tour. The others are moved to the end of the giant tour.
+#define HGS_MAX_ATTACHED (4)
+
+/// Size of the initial population, as a multiple of POPULATION_SIZE
+#define HGS_INITIAL_POPULATION_FACTOR (4)
+
+/// Number of closest customers the random giant tours of the initial
+/// population choose from
+#define HGS_INITIAL_NUM_CHOICES (3)
+
+struct SolverData {
+    LsNeighborLists nl;
+    int32_t num_threads;
+    int32_t population_size;
+    int32_t generation_size;
+    int32_t num_elites;
+    int32_t max_iterations_no_improvement;
+    int32_t migration_period;
+    int32_t num_tours;
+    /// Wall clock budget of the search, in seconds
+    double time_budget;
+    int32_t randomseed;
+    HgsStats stats;
+};
+
+typedef struct HgsIndividual {
+    /// Giant tour: a permutation of the customers which can be served
+    int32_t *giant;
+    Tour tour;
+    /// Predecessor of each visited node in `tour`
+    int32_t *pred;
+    double cost;
+    double fitness;
+} HgsIndividual;
+
+typedef struct HgsMailbox {
+    pthread_mutex_t mutex;
+    Tour tour;
+    double cost;
+    /// Incremented by each publication, 0 while empty
+    int64_t version;
+} HgsMailbox;
+
+typedef struct HgsIsland {
+    Solver *solver;
+    const Instance *instance;
+    const SolverData *data;
+    int64_t begin_time;
+    /// Customers which can be served: the genes of the giant tours
+    const int32_t *customers;
+    int32_t num_customers;
+    const bool *is_gene;
+
+    /// The population is `pop[0]`, ..., `pop[size - 1]`. The next free
+    /// individual, `pop[size]`, holds the offspring under construction.
+    HgsIndividual *individuals;
+    HgsIndividual **pop;
+    int32_t size;
+    int32_t capacity;
+    /// Broken-pairs distances: `prox[i * capacity + j]` between `pop[i]` and
+    /// `pop[j]`
+    double *prox;
+
+    Tour best;
+    double best_cost;
+
+    HgsMailbox *outbox;
+    HgsMailbox *inbox;
+    int64_t inbox_version;
+
+    // Scratch
+    double *split_cost;
+    double *split_cost_any;
+    bool *split_single;
+    int32_t *split_pred;
+    int32_t *seq;
+    int32_t *marker;
+    int32_t marker_stamp;
+    int32_t *attached_head;
+    int32_t *attached_next;
+    int32_t *num_attached;
+    double *diversity;
+    double *sort_key;
+    int32_t *order;
+
+    uint64_t rng_state;
+    int64_t num_iters;
+    int64_t num_migrations;
+    pthread_t thread;
+} HgsIsland;
+
+static inline bool is_visited(const Tour *tour, int32_t i) {
+    return tour->comp[i] == 0;
+}
+
+static bool should_stop(const HgsIsland *isl) {
+    return isl->solver->sigterm_occured ||
+           os_get_elapsed_secs(isl->begin_time) >= isl->data->time_budget;
+}
+
+static inline int32_t rand_below(HgsIsland *isl, int32_t bound) {
+    return (int32_t)(ls_rand(&isl->rng_state) % (uint64_t)bound);
+}
+
+/// Random nearest neighbor giant tour: starting from a random customer, each
+/// customer is followed by one of the HGS_INITIAL_NUM_CHOICES closest
+/// customers not yet in the giant tour, if any, or by a random one.
+static void random_giant(HgsIsland *isl, HgsIndividual *ind) {
+    const LsNeighborLists *nl = &isl->data->nl;
+    const int32_t m = isl->num_customers;
+    const int32_t stamp = ++isl->marker_stamp;
+    if (m == 0) {
+        return;
+    }
+
+    int32_t curr = isl->customers[rand_below(isl, m)];
+    for (int32_t len = 0;;) {
+        ind->giant[len++] = curr;
+        isl->marker[curr] = stamp;
+        if (len == m) {
+            break;
+        }
+
+        int32_t choices[HGS_INITIAL_NUM_CHOICES];
+        int32_t num_choices = 0;
+        for (int32_t r = 0; r < nl->k && num_choices < ARRAY_LEN_i32(choices);
+             r++) {
+            int32_t v = nl->nodes[curr * nl->k + r];
+            if (v != 0 && isl->marker[v] != stamp && isl->is_gene[v]) {
+                choices[num_choices++] = v;
+            }
+        }
+
+        if (num_choices > 0) {
+            curr = choices[rand_below(isl, num_choices)];
+        } else {
+            int32_t k = rand_below(isl, m);
+            while (isl->marker[isl->customers[k]] == stamp) {
+                k = (k + 1) % m;
+            }
+            curr = isl->customers[k];
+        }
+    }
+}
+
+/// Order crossover: the child inherits a random (circular) segment of the
+/// giant tour of `p1`, and the remaining customers in the order they have in
+/// the giant tour of `p2`.
+static void crossover(HgsIsland *isl, const HgsIndividual *p1,
+                      const HgsIndividual *p2, HgsIndividual *child) {
+    const int32_t m = isl->num_customers;
+    if (m == 0) {
+        return;
+    }
+
+    const int32_t stamp = ++isl->marker_stamp;
+    const int32_t start = rand_below(isl, m);
+    const int32_t end = rand_below(isl, m);
+
+    for (int32_t k = start;; k = (k + 1) % m) {
+        child->giant[k] = p1->giant[k];
+        isl->marker[p1->giant[k]] = stamp;
+        if (k == end) {
+            break;
+        }
+    }
+
+    int32_t dst = (end + 1) % m;
+    for (int32_t s = 1; s <= m; s++) {
+        int32_t c = p2->giant[(end + s) % m];
+        if (isl->marker[c] != stamp) {
+            child->giant[dst] = c;
+            dst = (dst + 1) % m;
+        }
+    }
+}
+
+/// Decodes the giant tour of `ind` into its tour: the cheapest tour visiting
+/// a subsequence of at least two customers of the giant tour, in order,
+/// regardless of the capacity. The capacity is then restored by dropping the
+/// customers collecting the least profit, net of their detour, per unit of
+/// demand.
+static void split(HgsIsland *isl, HgsIndividual *ind) {
+    const Instance *instance = isl->instance;
+    const double Q = instance->vehicle_cap;
+    const int32_t m = isl->num_customers;
+    const int32_t *giant = ind->giant;
+    double *f = isl->split_cost;
+    double *f_any = isl->split_cost_any;
+    bool *single = isl->split_single;
+    int32_t *pred = isl->split_pred;
+    int32_t *seq = isl->seq;
+
+    // f[t]: cheapest path from the depot ending in giant[t], and visiting at
+    // least two customers. f_any[t]: same, for at least one customer.
+    int32_t last = -1;
+    double best_cost = INFINITY;
+    for (int32_t t = 0; t < m; t++) {
+        const int32_t c = giant[t];
+        f[t] = INFINITY;
+        pred[t] = -1;
+        for (int32_t s = MAX(0, t - HGS_SPLIT_WINDOW); s < t; s++) {
+            double cost = f_any[s] + cptp_dist(instance, giant[s], c);
+            if (cost < f[t]) {
+                f[t] = cost;
+                pred[t] = s;
+            }
+        }
+        f[t] -= instance->profits[c];
+
+        double cost_single = cptp_dist(instance, 0, c) - instance->profits[c];
+        single[t] = !(f[t] < cost_single);
+        f_any[t] = single[t] ? cost_single : f[t];
+
+        double cost = f[t] + cptp_dist(instance, c, 0);
+        if (cost < best_cost) {
+            best_cost = cost;
+            last = t;
+        }
+    }
+
+    int32_t len = 0;
+    if (last >= 0) {
+        seq[len++] = giant[last];
+        for (int32_t t = pred[last];; t = pred[t]) {
+            seq[len++] = giant[t];
+            if (single[t]) {
+                break;
+            }
+        }
+    }
+    for (int32_t k = 0; k < len / 2; k++) {
+        SWAP(int32_t, seq[k], seq[len - 1 - k]);
+    }
+
+    double load = 0.0;
+    for (int32_t k = 0; k < len; k++) {
+        load += instance->demands[seq[k]];
+    }
+    while (load > Q && len > 1) {
+        int32_t worst = -1;
+        double worst_ratio = INFINITY;
+        for (int32_t k = 0; k < len; k++) {
+            int32_t c = seq[k];
+            if (instance->demands[c] <= 0.0) {
+                continue;
+            }
+            int32_t a = k > 0 ? seq[k - 1] : 0;
+            int32_t b = k < len - 1 ? seq[k + 1] : 0;
+            double saving = cptp_dist(instance, a, c) +
+                            cptp_dist(instance, c, b) -
+                            cptp_dist(instance, a, b);
+            double ratio =
+                (instance->profits[c] - saving) / instance->demands[c];
+            if (ratio < worst_ratio) {
+                worst_ratio = ratio;
+                worst = k;
+            }
+        }
+        assert(worst >= 0);
+        load -= instance->demands[seq[worst]];
+        memmove(&seq[worst], &seq[worst + 1],
+                (len - worst - 1) * sizeof(*seq));
+        --len;
+    }
+
+    Tour *tour = &ind->tour;
+    tour_clear(tour);
+    tour->num_comps = 1;
+    tour->comp[0] = 0;
+    int32_t prev = 0;
+    for (int32_t k = 0; k < len; k++) {
+        tour->succ[prev] = seq[k];
+        tour->comp[seq[k]] = 0;
+        prev = seq[k];
+    }
+    tour->succ[prev] = 0;
+}
+
+/// Rewrites the giant tour of `ind` from its tour: the visited customers in
+/// tour order, each followed by up to HGS_MAX_ATTACHED of the unvisited
+/// customers having it as the closest visited customer.
+static void rewrite_giant(HgsIsland *isl, HgsIndividual *ind) {
+    const LsNeighborLists *nl = &isl->data->nl;
+    const int32_t n = isl->instance->num_customers + 1;
+    const int32_t m = isl->num_customers;
+    const Tour *tour = &ind->tour;
+    int32_t *head = isl->attached_head;
+    int32_t *next = isl->attached_next;
+    int32_t *orphans = isl->seq;
+    int32_t num_orphans = 0;
+
+    for (int32_t i = 0; i < n; i++) {
+        head[i] = -1;
+        isl->num_attached[i] = 0;
+    }
+
+    for (int32_t k = m - 1; k >= 0; k--) {
+        int32_t u = isl->customers[k];
+        if (is_visited(tour, u)) {
+            continue;
+        }
+        int32_t anchor = -1;
+        for (int32_t r = 0; r < nl->k; r++) {
+            int32_t v = nl->nodes[u * nl->k + r];
+            if (v != 0 && is_visited(tour, v) &&
+                isl->num_attached[v] < HGS_MAX_ATTACHED) {
+                anchor = v;
+                break;
+            }
+        }
+        if (anchor < 0) {
+            orphans[num_orphans++] = u;
+        } else {
+            next[u] = head[anchor];
+            head[anchor] = u;
+            ++isl->num_attached[anchor];
+        }
+    }
+
+    int32_t len = 0;
+    for (int32_t v = tour->succ[0]; v != 0; v = tour->succ[v]) {
+        ind->giant[len++] = v;
+        for (int32_t u = head[v]; u >= 0; u = next[u]) {
+            ind->giant[len++] = u;
+        }
+    }
+    for (int32_t k = num_orphans - 1; k >= 0; k--) {
+        ind->giant[len++] = orphans[k];
+    }
+    assert(len == m);
+}
+
+/// Computes the cost and the predecessors of the tour of `ind`, and rewrites
+/// its giant tour.
+static void finalize_individual(HgsIsland *isl, HgsIndividual *ind) {
+    const int32_t n = isl->instance->num_customers + 1;
+    Tour *tour = &ind->tour;
+
+    ind->cost = tour_eval(isl->instance, tour);
+    for (int32_t i = 0; i < n; i++) {
+        ind->pred[i] = -1;
+    }
+    for (int32_t i = 0; i < n; i++) {
+        if (is_visited(tour, i)) {
+            ind->pred[tour->succ[i]] = i;
+        }
+    }
+    rewrite_giant(isl, ind);
+}
+
+/// Broken-pairs distance: fraction of the nodes visited by `a` or `b` whose
+/// successor in `a` is not adjacent to them in `b`, a node visited by one
+/// individual only counting as broken.
+static double broken_pairs_distance(const HgsIndividual *a,
+                                    const HgsIndividual *b, int32_t n) {
+    int32_t num_nodes = 0;
+    int32_t num_broken = 0;
+    for (int32_t i = 1; i < n; i++) {
+        bool va = is_visited(&a->tour, i);
+        bool vb = is_visited(&b->tour, i);
+        if (!va && !vb) {
+            continue;
+        }
+        ++num_nodes;
+        if (va != vb) {
+            ++num_broken;
+        } else {
+            int32_t s = a->tour.succ[i];
+            if (s != b->tour.succ[i] && s != b->pred[i]) {
+                ++num_broken;
+            }
+        }
+    }
+    return num_nodes > 0 ? (double)num_broken / num_nodes : 0.0;
+}
+
+/// Sorts the first `len` entries of `order` by increasing `key`
+static void sort_by_key(int32_t *order, int32_t len, const double *key) {
+    for (int32_t i = 1; i < len; i++) {
+        int32_t v = order[i];
+        int32_t j = i;
+        while (j > 0 && key[order[j - 1]] > key[v]) {
+            order[j] = order[j - 1];
+            --j;
+        }
+        order[j] = v;
+    }
+}
+
+/// Biased fitness (the lower the better): rank by cost, plus rank by
+/// diversity contribution weighted by `1 - NUM_ELITES / size`. Ranks are
+/// normalized to [0, 1].
+static void update_fitness(HgsIsland *isl) {
+    const int32_t size = isl->size;
+    const int32_t C = isl->capacity;
+    if (size <= 1) {
+        for (int32_t i = 0; i < size; i++) {
+            isl->pop[i]->fitness = 0.0;
+        }
+        return;
+    }
+
+    const int32_t num_close = MIN(HGS_NUM_CLOSE, size - 1);
+    double *key = isl->sort_key;
+
+    for (int32_t i = 0; i < size; i++) {
+        // Average of the `num_close` smallest distances, negated such that
+        // the most diverse individuals come first
+        int32_t cnt = 0;
+        for (int32_t j = 0; j < size; j++) {
+            if (j != i) {
+                isl->order[cnt++] = j;
+            }
+        }
+        double sum = 0.0;
+        for (int32_t r = 0; r < num_close; r++) {
+            int32_t best = r;
+            for (int32_t s = r + 1; s < cnt; s++) {
+                if (isl->prox[i * C + isl->order[s]] <
+                    isl->prox[i * C + isl->order[best]]) {
+                    best = s;
+                }
+            }
+            SWAP(int32_t, isl->order[r], isl->order[best]);
+            sum += isl->prox[i * C + isl->order[r]];
+        }
+        isl->diversity[i] = -sum / num_close;
+    }
+
+    for (int32_t i = 0; i < size; i++) {
+        isl->order[i] = i;
+        key[i] = isl->pop[i]->cost;
+    }
+    sort_by_key(isl->order, size, key);
+    for (int32_t r = 0; r < size; r++) {
+        isl->pop[isl->order[r]]->fitness = (double)r / (size - 1);
+    }
+
+    const double weight =
+        MAX(0.0, 1.0 - (double)isl->data->num_elites / size);
+    for (int32_t i = 0; i < size; i++) {
+        isl->order[i] = i;
+    }
+    sort_by_key(isl->order, size, isl->diversity);
+    for (int32_t r = 0; r < size; r++) {
+        isl->pop[isl->order[r]]->fitness += weight * r / (size - 1);
+    }
+}
+
+static void remove_individual(HgsIsland *isl, int32_t i) {
+    const int32_t C = isl->capacity;
+    const int32_t last = --isl->size;
+
+    SWAP(HgsIndividual *, isl->pop[i], isl->pop[last]);
+    for (int32_t j = 0; j < last; j++) {
+        isl->prox[i * C + j] = isl->prox[last * C + j];
+        isl->prox[j * C + i] = isl->prox[j * C + last];
+    }
+    isl->prox[i * C + i] = 0.0;
+}
+
+/// Discards the individuals of worst biased fitness, down to POPULATION_SIZE
+static void select_survivors(HgsIsland *isl) {
+    while (isl->size > isl->data->population_size) {
+        update_fitness(isl);
+        int32_t worst = 0;
+        for (int32_t i = 1; i < isl->size; i++) {
+            if (isl->pop[i]->fitness > isl->pop[worst]->fitness) {
+                worst = i;
+            }
+        }
+        remove_individual(isl, worst);
+    }
+}
+
+/// Adds the individual `pop[size]` to the population, unless it is a clone of
+/// one of its individuals. Returns whether it improves the best tour of the
+/// island.
+static bool add_individual(HgsIsland *isl) {
+    const int32_t n = isl->instance->num_customers + 1;
+    const int32_t C = isl->capacity;
+    const int32_t i = isl->size;
+    HgsIndividual *ind = isl->pop[i];
+
+    bool improved = ind->cost < isl->best_cost - COST_TOLERANCE;
+    if (improved || isl->best_cost == INFINITY) {
+        tour_copy_into(&isl->best, &ind->tour);
+        isl->best_cost = ind->cost;
+    }
+
+    for (int32_t j = 0; j < i; j++) {
+        double d = broken_pairs_distance(ind, isl->pop[j], n);
+        if (d <= 0.0) {
+            return improved;
+        }
+        isl->prox[i * C + j] = d;
+        isl->prox[j * C + i] = d;
+    }
+    isl->prox[i * C + i] = 0.0;
+    ++isl->size;
+
+    if (isl->size >= C) {
+        select_survivors(isl);
+    }
+    return improved;
+}
+
+static HgsIndividual *binary_tournament(HgsIsland *isl) {
+    HgsIndividual *a = isl->pop[rand_below(isl, isl->size)];
+    HgsIndividual *b = isl->pop[rand_below(isl, isl->size)];
+    return a->fitness <= b->fitness ? a : b;
+}
+
+/// Publishes the best tour of the island, if improved, and imports the one of
+/// the previous island of the ring, if new. Returns whether the imported tour
+/// improves the best tour of the island.
+static bool migrate(HgsIsland *isl) {
+    HgsIndividual *ind = isl->pop[isl->size];
+    bool imported = false;
+
+    pthread_mutex_lock(&isl->outbox->mutex);
+    if (isl->outbox->version == 0 ||
+        isl->best_cost < isl->outbox->cost - COST_TOLERANCE) {
+        tour_copy_into(&isl->outbox->tour, &isl->best);
+        isl->outbox->cost = isl->best_cost;
+        ++isl->outbox->version;
+    }
+    pthread_mutex_unlock(&isl->outbox->mutex);
+
+    if (isl->inbox == isl->outbox) {
+        return false;
+    }
+
+    pthread_mutex_lock(&isl->inbox->mutex);
+    if (isl->inbox->version > isl->inbox_version) {
+        tour_copy_into(&ind->tour, &isl->inbox->tour);
+        isl->inbox_version = isl->inbox->version;
+        imported = true;
+    }
+    pthread_mutex_unlock(&isl->inbox->mutex);
+
+    if (!imported) {
+        return false;
+    }
+    ++isl->num_migrations;
+    finalize_individual(isl, ind);
+    return add_individual(isl);
+}
+
+static void *island_main(void *arg) {
+    HgsIsland *isl = arg;
+    const SolverData *data = isl->data;
+    const Instance *instance = isl->instance;
+    const int32_t num_initial =
+        HGS_INITIAL_POPULATION_FACTOR * data->population_size;
+
+    // NOTE(dparo):
+    //      The first individual is always built, such that the island has a
+    //      tour to report even when the time limit is already exhausted.
+    for (int32_t k = 0; k < num_initial && (k == 0 || !should_stop(isl));
+         k++) {
+        HgsIndividual *ind = isl->pop[isl->size];
+        random_giant(isl, ind);
+        split(isl, ind);
+        ls_optimize_nl(instance, &data->nl, &ind->tour, HGS_MIN_NUM_VISITED,
+                       NULL);
+        finalize_individual(isl, ind);
+        add_individual(isl);
+    }
+
+    int64_t num_no_improvement = 0;
+    while (isl->size > 0 && !should_stop(isl) &&
+           (data->max_iterations_no_improvement <= 0 ||
+            num_no_improvement < data->max_iterations_no_improvement)) {
+        update_fitness(isl);
+        HgsIndividual *p1 = binary_tournament(isl);
+        HgsIndividual *p2 = binary_tournament(isl);
+        HgsIndividual *child = isl->pop[isl->size];
+
+        crossover(isl, p1, p2, child);
+        split(isl, child);
+        ls_optimize_nl(instance, &data->nl, &child->tour, HGS_MIN_NUM_VISITED,
+                       NULL);
+        finalize_individual(isl, child);
+        ++isl->num_iters;
+
+        if (add_individual(isl)) {
+            num_no_improvement = 0;
+            log_trace("%s :: iteration %lld, new best tour of cost %f",
+                      __func__, (long long)isl->num_iters, isl->best_cost);
+        } else {
+            ++num_no_improvement;
+        }
+
+        if (data->migration_period > 0 &&
+            isl->num_iters % data->migration_period == 0 && migrate(isl)) {
+            num_no_improvement = 0;
+        }
+    }
+
+    return NULL;
+}
+
+static bool mailbox_init(HgsMailbox *mailbox, const Instance *instance) {
+    mailbox->tour = tour_create(instance);
+    mailbox->cost = INFINITY;
+    mailbox->version = 0;
+    if (!tour_is_valid(&mailbox->tour)) {
+        return false;
+    }
+    if (pthread_mutex_init(&mailbox->mutex, NULL) != 0) {
+        tour_destroy(&mailbox->tour);
+        return false;
+    }
+    return true;
+}
+
+static void mailbox_destroy(HgsMailbox *mailbox) {
+    pthread_mutex_destroy(&mailbox->mutex);
+    tour_destroy(&mailbox->tour);
+}
+
+static void island_destroy(HgsIsland *isl) {
+    if (isl->individuals) {
+        for (int32_t i = 0; i <= isl->capacity; i++) {
+            free(isl->individuals[i].giant);
+            free(isl->individuals[i].pred);
+            tour_destroy(&isl->individuals[i].tour);
+        }
+    }
+    free(isl->individuals);
+    free(isl->pop);
+    free(isl->prox);
+    tour_destroy(&isl->best);
+    free(isl->split_cost);
+    free(isl->split_cost_any);
+    free(isl->split_single);
+    free(isl->split_pred);
+    free(isl->seq);
+    free(isl->marker);
+    free(isl->attached_head);
+    free(isl->attached_next);
+    free(isl->num_attached);
+    free(isl->diversity);
+    free(isl->sort_key);
+    free(isl->order);
+    memset(isl, 0, sizeof(*isl));
+}
+
+static bool island_init(HgsIsland *isl, Solver *solver,
+                        const Instance *instance, const int32_t *customers,
+                        int32_t num_customers, const bool *is_gene) {
+    const SolverData *data = solver->data;
+    const int32_t n = instance->num_customers + 1;
+    const int32_t m = MAX(1, num_customers);
+    const int32_t C = data->population_size + data->generation_size;
+
+    isl->solver = solver;
+    isl->instance = instance;
+    isl->data = data;
+    isl->customers = customers;
+    isl->num_customers = num_customers;
+    isl->is_gene = is_gene;
+    isl->capacity = C;
+    isl->best_cost = INFINITY;
+
+    // One more individual for the offspring under construction
+    isl->individuals = calloc(C + 1, sizeof(*isl->individuals));
+    isl->pop = malloc((C + 1) * sizeof(*isl->pop));
+    isl->prox = malloc((size_t)C * C * sizeof(*isl->prox));
+    isl->best = tour_create(instance);
+    isl->split_cost = malloc(m * sizeof(*isl->split_cost));
+    isl->split_cost_any = malloc(m * sizeof(*isl->split_cost_any));
+    isl->split_single = malloc(m * sizeof(*isl->split_single));
+    isl->split_pred = malloc(m * sizeof(*isl->split_pred));
+    isl->seq = malloc(m * sizeof(*isl->seq));
+    isl->marker = calloc(n, sizeof(*isl->marker));
+    isl->attached_head = malloc(n * sizeof(*isl->attached_head));
+    isl->attached_next = malloc(n * sizeof(*isl->attached_next));
+    isl->num_attached = malloc(n * sizeof(*isl->num_attached));
+    isl->diversity = malloc((C + 1) * sizeof(*isl->diversity));
+    isl->sort_key = malloc((C + 1) * sizeof(*isl->sort_key));
+    isl->order = malloc((C + 1) * sizeof(*isl->order));
+
+    if (!isl->individuals || !isl->pop || !isl->prox ||
+        !tour_is_valid(&isl->best) || !isl->split_cost ||
+        !isl->split_cost_any || !isl->split_single || !isl->split_pred ||
+        !isl->seq || !isl->marker || !isl->attached_head ||
+        !isl->attached_next || !isl->num_attached || !isl->diversity ||
+        !isl->sort_key || !isl->order) {
+        return false;
+    }
+
+    for (int32_t i = 0; i <= C; i++) {
+        HgsIndividual *ind = &isl->individuals[i];
+        ind->giant = malloc(m * sizeof(*ind->giant));
+        ind->pred = malloc(n * sizeof(*ind->pred));
+        ind->tour = tour_create(instance);
+        if (!ind->giant || !ind->pred || !tour_is_valid(&ind->tour)) {
+            return false;
+        }
+        isl->pop[i] = ind;
+    }
+
+    return true;
+}
+
+static SolveStatus solve(Solver *self, const Instance *instance,
+                         Solution *solution, int64_t begin_time) {
+    SolverData *data = self->data;
+    const int32_t n = instance->num_customers + 1;
+    const int32_t num_islands = data->num_threads;
+    SolveStatus status = SOLVE_STATUS_ERR;
+    int32_t num_mailboxes = 0;
+    int32_t num_spawned = 0;
+
+    int32_t *customers = malloc(n * sizeof(*customers));
+    bool *is_gene = calloc(n, sizeof(*is_gene));
+    HgsMailbox *mailboxes = calloc(num_islands, sizeof(*mailboxes));
+    HgsIsland *islands = calloc(num_islands, sizeof(*islands));
+    if (!customers || !is_gene || !mailboxes || !islands) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        goto terminate;
+    }
+
+    solution_clear_tours(solution);
+
+    int32_t num_customers = 0;
+    for (int32_t i = 1; i < n; i++) {
+        if (isfinite(instance->profits[i]) &&
+            instance->demands[i] <= instance->vehicle_cap) {
+            customers[num_customers++] = i;
+            is_gene[i] = true;
+        }
+    }
+
+    for (; num_mailboxes < num_islands; num_mailboxes++) {
+        if (!mailbox_init(&mailboxes[num_mailboxes], instance)) {
+            log_fatal("%s :: Failed to create the mailboxes", __func__);
+            goto terminate;
+        }
+    }
+
+    for (int32_t k = 0; k < num_islands; k++) {
+        HgsIsland *isl = &islands[k];
+        if (!island_init(isl, self, instance, customers, num_customers,
+                         is_gene)) {
+            log_fatal("%s :: Failed memory allocation", __func__);
+            goto terminate;
+        }
+        isl->begin_time = begin_time;
+        isl->outbox = &mailboxes[k];
+        isl->inbox = &mailboxes[(k + num_islands - 1) % num_islands];
+        // Distinct, non zero, random generator states per island
+        uint64_t seed =
+            ((uint64_t)(uint32_t)data->randomseed << 32) | (uint32_t)k;
+        isl->rng_state = (seed * UINT64_C(0x9E3779B97F4A7C15)) | 1;
+    }
+
+    // NOTE(dparo):
+    //      The calling thread evolves the first island. An island whose
+    //      thread cannot be spawned is left empty.
+    for (int32_t k = 1; k < num_islands; k++) {
+        if (0 != pthread_create(&islands[k].thread, NULL, island_main,
+                                &islands[k])) {
+            log_warn("%s :: pthread_create failed", __func__);
+            break;
+        }
+        ++num_spawned;
+    }
+    island_main(&islands[0]);
+    for (int32_t k = 1; k <= num_spawned; k++) {
+        pthread_join(islands[k].thread, NULL);
+    }
+
+    int32_t best_k = 0;
+    int64_t num_iters = 0;
+    int64_t num_migrations = 0;
+    for (int32_t k = 0; k <= num_spawned; k++) {
+        HgsIsland *isl = &islands[k];
+        num_iters += isl->num_iters;
+        num_migrations += isl->num_migrations;
+        if (isl->best_cost < islands[best_k].best_cost) {
+            best_k = k;
+        }
+        solution_collect_tour(solution, data->num_tours, &isl->best,
+                              isl->best_cost);
+        for (int32_t i = 0; i < isl->size; i++) {
+            solution_collect_tour(solution, data->num_tours,
+                                  &isl->pop[i]->tour, isl->pop[i]->cost);
+        }
+    }
+
+    data->stats.num_islands = num_spawned + 1;
+    data->stats.num_iters = num_iters;
+    data->stats.num_migrations = num_migrations;
+    log_info("%s :: %d islands, %lld iterations, %lld migrations (best cost "
+             "%f)",
+             __func__, num_spawned + 1, (long long)num_iters,
+             (long long)num_migrations, islands[best_k].best_cost);
+
+    SolveStatus abortion = SOLVE_STATUS_NULL;
+    if (self->sigterm_occured) {
+        abortion = SOLVE_STATUS_ABORTION_SIGTERM;
+    } else if (os_get_elapsed_secs(begin_time) >= data->time_budget) {
+        abortion = SOLVE_STATUS_ABORTION_RES_EXHAUSTED;
+    }
+
+    tour_copy_into(&solution->tour, &islands[best_k].best);
+    solution->primal_bound = islands[best_k].best_cost;
+    solution->dual_bound = -INFINITY;
+    solution->det_ticks = -1.0;
+    validate_primal_solution(instance, solution, HGS_MIN_NUM_VISITED);
+    status = SOLVE_STATUS_PRIMAL_SOLUTION_AVAIL | abortion;
+
+terminate:
+    if (islands) {
+        for (int32_t k = 0; k < num_islands; k++) {
+            island_destroy(&islands[k]);
+        }
+    }
+    for (int32_t k = 0; k < num_mailboxes; k++) {
+        mailbox_destroy(&mailboxes[k]);
+    }
+    free(islands);
+    free(mailboxes);
+    free(customers);
+    free(is_gene);
+    return status;
+}
+
+HgsStats hgs_solver_stats(const Solver *solver) {
+    return solver->data->stats;
+}
+
+/// The search does not cache anything depending on the profits
+static bool update_profits(Solver *self, const Instance *instance) {
+    UNUSED_PARAM(self);
+    UNUSED_PARAM(instance);
+    return true;
+}
+
+static void destroy(Solver *self) {
+    if (self->data) {
+        ls_neighbor_lists_destroy(&self->data->nl);
+        free(self->data);
+    }
+    memset(self, 0, sizeof(*self));
+}
+
+Solver hgs_solver_create(const Instance *instance, SolverTypedParams *tparams,
+                         double timelimit, int32_t randomseed) {
+    Solver solver = {0};
+    solver.solve = solve;
+    solver.update_profits = update_profits;
+    solver.destroy = destroy;
+    solver.data = calloc(1, sizeof(*solver.data));
+    if (!solver.data) {
+        goto fail;
+    }
+
+    SolverData *data = solver.data;
+    data->num_threads = solver_params_get_int32(tparams, "NUM_THREADS");
+    data->population_size =
+        solver_params_get_int32(tparams, "POPULATION_SIZE");
+    data->generation_size =
+        solver_params_get_int32(tparams, "GENERATION_SIZE");
+    data->num_elites = solver_params_get_int32(tparams, "NUM_ELITES");
+    data->max_iterations_no_improvement =
+        solver_params_get_int32(tparams, "MAX_ITERATIONS_NO_IMPROVEMENT");
+    data->migration_period =
+        solver_params_get_int32(tparams, "MIGRATION_PERIOD");
+    data->num_tours = solver_params_get_int32(tparams, "PRICER_NUM_TOURS");
+    double max_time = solver_params_get_double(tparams, "MAX_TIME");
+
+    if (data->num_threads < 0) {
+        log_fatal("%s :: Invalid NUM_THREADS `%d`", __func__,
+                  data->num_threads);
+        goto fail;
+    } else if (data->num_threads == 0) {
+        data->num_threads = os_get_num_cores();
+    }
+    if (data->population_size < 1 || data->generation_size < 1) {
+        log_fatal("%s :: Invalid POPULATION_SIZE `%d` or GENERATION_SIZE "
+                  "`%d`",
+                  __func__, data->population_size, data->generation_size);
+        goto fail;
+    }
+
+    data->time_budget = timelimit > 0 ? timelimit : INFINITY;
+    if (max_time > 0) {
+        data->time_budget = MIN(data->time_budget, max_time);
+    }
+    data->randomseed = randomseed;
+
+    if (!ls_neighbor_lists_create(&data->nl, instance, HGS_NUM_NEIGHBORS)) {
+        log_fatal("%s :: Failed to build the candidate lists", __func__);
+        goto fail;
+    }
+
+    return solver;
+
+fail:
+    destroy(&solver);
+    return (Solver){0};
+}
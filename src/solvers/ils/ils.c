@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2022 Davide Paro
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "solvers.h"
+#include "core-utils.h"
+#include "local-search.h"
+#include "validation.h"
+
+// NOTE(dparo):
+//      CPLEX free iterated local search. The initial tour visits the customers
+//      whose profit covers the round trip from the depot. Each iteration
+//      perturbs the best tour (random drops, insertions and segment
+//      reversals, see ls_perturb() and ls_perturb_segments()), and brings it
+//      back to a local optimum of both the 2-opt / Or-opt and the add / drop /
+//      swap neighborhoods. Improving tours replace the best one.
+//      The solver proves nothing: the dual bound is left at -INFINITY.
+
+/// Minimum number of visited nodes (depot included) of the tours, as in the
+/// MIP formulation
+#define ILS_MIN_NUM_VISITED (3)
+
+struct SolverData {
+    LsNeighborLists nl;
+    int32_t max_iterations;
+    int32_t max_strength;
+    int32_t num_tours;
+    /// Wall clock budget of the search, in seconds
+    double time_budget;
+    uint64_t rng_state;
+};
+
+static SolveStatus solve(Solver *self, const Instance *instance,
+                         Solution *solution, int64_t begin_time) {
+    SolverData *data = self->data;
+    const int32_t n = instance->num_customers + 1;
+    SolveStatus status = SOLVE_STATUS_ERR;
+
+    double *score = malloc(n * sizeof(*score));
+    Tour best = tour_create(instance);
+    Tour curr = tour_create(instance);
+    if (!score || !tour_is_valid(&best) || !tour_is_valid(&curr)) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        goto terminate;
+    }
+
+    solution_clear_tours(solution);
+
+    // Initial tour: the customers whose profit covers the round trip
+    score[0] = 0.0;
+    for (int32_t i = 1; i < n; i++) {
+        score[i] = instance->profits[i] - cptp_dist(instance, 0, i) -
+                   cptp_dist(instance, i, 0);
+    }
+    ls_build_tour_from_scores(instance, &best, score, 0.0);
+    ls_optimize_nl(instance, &data->nl, &best, ILS_MIN_NUM_VISITED, NULL);
+    double best_cost = tour_eval(instance, &best);
+    solution_collect_tour(solution, data->num_tours, &best, best_cost);
+
+    SolveStatus abortion = SOLVE_STATUS_NULL;
+    int64_t num_iters = 0;
+    int64_t num_improvements = 0;
+
+    while (data->max_iterations <= 0 || num_iters < data->max_iterations) {
+        if (self->sigterm_occured) {
+            abortion = SOLVE_STATUS_ABORTION_SIGTERM;
+            break;
+        }
+        if (os_get_elapsed_secs(begin_time) >= data->time_budget) {
+            abortion = SOLVE_STATUS_ABORTION_RES_EXHAUSTED;
+            break;
+        }
+
+        tour_copy_into(&curr, &best);
+        int32_t strength = 1 + (int32_t)(num_iters % data->max_strength);
+        ls_perturb(instance, &curr, strength, ILS_MIN_NUM_VISITED,
+                   &data->rng_state);
+        ls_perturb_segments(instance, &curr, strength, &data->rng_state);
+        ls_optimize_nl(instance, &data->nl, &curr, ILS_MIN_NUM_VISITED, NULL);
+        ++num_iters;
+
+        double cost = tour_eval(instance, &curr);
+        solution_collect_tour(solution, data->num_tours, &curr, cost);
+        if (cost < best_cost - COST_TOLERANCE) {
+            tour_copy_into(&best, &curr);
+            best_cost = cost;
+            ++num_improvements;
+            log_trace("%s :: iteration %lld, new best tour of cost %f",
+                      __func__, (long long)num_iters, cost);
+        }
+    }
+
+    log_info("%s :: %lld iterations, %lld improvements (best cost %f)",
+             __func__, (long long)num_iters, (long long)num_improvements,
+             best_cost);
+
+    tour_copy_into(&solution->tour, &best);
+    solution->primal_bound = best_cost;
+    solution->dual_bound = -INFINITY;
+    solution->det_ticks = -1.0;
+    validate_primal_solution(instance, solution, ILS_MIN_NUM_VISITED);
+    status = SOLVE_STATUS_PRIMAL_SOLUTION_AVAIL | abortion;
+
+terminate:
+    free(score);
+    tour_destroy(&best);
+    tour_destroy(&curr);
+    return status;
+}
+
+/// The search does not cache anything depending on the profits
+static bool update_profits(Solver *self, const Instance *instance) {
+    UNUSED_PARAM(self);
+    UNUSED_PARAM(instance);
+    return true;
+}
+
+static void destroy(Solver *self) {
+    if (self->data) {
+        ls_neighbor_lists_destroy(&self->data->nl);
+        free(self->data);
+    }
+    memset(self, 0, sizeof(*self));
+}
+
+Solver ils_solver_create(const Instance *instance, SolverTypedParams *tparams,
+                         double timelimit, int32_t randomseed) {
+    Solver solver = {0};
+    solver.solve = solve;
+    solver.update_profits = update_profits;
+    solver.destroy = destroy;
+    solver.data = calloc(1, sizeof(*solver.data));
+    if (!solver.data) {
+        goto fail;
+    }
+
+    SolverData *data = solver.data;
+    data->max_iterations = solver_params_get_int32(tparams, "MAX_ITERATIONS");
+    data->max_strength =
+        solver_params_get_int32(tparams, "PERTURBATION_STRENGTH");
+    data->num_tours = solver_params_get_int32(tparams, "PRICER_NUM_TOURS");
+    double max_time = solver_params_get_double(tparams, "MAX_TIME");
+
+    if (data->max_strength < 0) {
+        log_fatal("%s :: Invalid PERTURBATION_STRENGTH `%d`", __func__,
+                  data->max_strength);
+        goto fail;
+    } else if (data->max_strength == 0) {
+        data->max_strength =
+            MAX(1, MIN(LS_ILS_MAX_PERTURBATION, instance->num_customers / 4));
+    }
+
+    data->time_budget = timelimit > 0 ? timelimit : INFINITY;
+    if (max_time > 0) {
+        data->time_budget = MIN(data->time_budget, max_time);
+    }
+    data->rng_state = ((uint64_t)(uint32_t)randomseed << 1) | 1;
+
+    if (!ls_neighbor_lists_create(&data->nl, instance, LS_ILS_NUM_NEIGHBORS)) {
+        log_fatal("%s :: Failed to build the candidate lists", __func__);
+        goto fail;
+    }
+
+    return solver;
+
+fail:
+    destroy(&solver);
+    return (Solver){0};
+}
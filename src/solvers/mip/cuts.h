@@ -44,6 +44,7 @@ typedef struct CutDescriptor {
 extern const CutSeparationIface CUT_GSEC_IFACE;
 extern const CutSeparationIface CUT_GLM_IFACE;
 extern const CutSeparationIface CUT_RCI_IFACE;
+extern const CutSeparationIface CUT_COMB_IFACE;
 
 static const CutDescriptor CUT_GSEC_DESCRIPTOR = {
     "GSEC",
@@ -63,6 +64,12 @@ static const CutDescriptor CUT_RCI_DESCRIPTOR = {
     {{0}},
 };
 
+static const CutDescriptor CUT_COMB_DESCRIPTOR = {
+    "COMB",
+    &CUT_COMB_IFACE,
+    {{0}},
+};
+
 #if __cplusplus
 }
 #endif
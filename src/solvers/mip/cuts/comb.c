@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2022 Davide Paro
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "../mip.h"
+#include "../cuts.h"
+#include "./cuts-utils.h"
+
+// NOTE(dparo):
+//      Comb (2-matching / blossom) inequalities adapted to the
+//      prize-collecting formulation.
+//      Given an handle H and an odd set of teeth T, each tooth being a single
+//      edge of the cut-set delta(H), summing the degree equations of the
+//      nodes in H, adding x_e <= 1 for e in T, and applying Chvatal-Gomory
+//      rounding yields
+//
+//              x(E(H)) + x(T) <= y(H) + (|T| - 1) / 2
+//
+//      Substituting x(E(H)) = y(H) - x(delta(H)) / 2 (again from the degree
+//      equations) the y variables cancel out and we get the equivalent
+//      cut-set form
+//
+//              x(delta(H) \ T) - x(T) >= 1 - |T|
+//
+//      which is what this module separates. The inequality is valid for any
+//      handle, regardless of the depot being inside H or not, and the teeth
+//      need not be disjoint.
+//      The handle candidates are the min-cut bipartitions produced by the
+//      Gomory-Hu tree, and the teeth are chosen with the Padberg-Rao
+//      heuristic: the edges of delta(H) with x_e > 0.5, fixing the parity by
+//      toggling the edge closest to 0.5.
+
+static const double FRACTIONAL_VIOLATION_TOLERANCE = 1e-2;
+ATTRIB_MAYBE_UNUSED static const double EPS = 1e-6;
+
+/// Combs with a single tooth are seldom violated by points satisfying the
+/// GSEC cuts. Do not bother with them.
+#define MIN_NUM_TEETH 3
+
+struct CutSeparationPrivCtx {
+    CutSeparationPrivCtxCommon super;
+};
+
+static inline CPXNNZ get_nnz_upper_bound(const Instance *instance) {
+    int32_t n = instance->num_customers + 1;
+    return ((CPXNNZ)(n + 1) * (CPXNNZ)(n + 1)) / 4;
+}
+
+static void deactivate(CutSeparationPrivCtx *ctx) {
+    free(ctx->super.index);
+    free(ctx->super.value);
+    free(ctx);
+}
+
+static CutSeparationPrivCtx *activate(const Instance *instance,
+                                      Solver *solver) {
+    UNUSED_PARAM(solver);
+
+    CutSeparationPrivCtx *ctx = malloc(sizeof(*ctx));
+    size_t nnz_ub = get_nnz_upper_bound(instance);
+
+    ctx->super.index = malloc(nnz_ub * sizeof(*ctx->super.index));
+    ctx->super.value = malloc(nnz_ub * sizeof(*ctx->super.value));
+
+    if (!ctx->super.index || !ctx->super.value) {
+        deactivate(ctx);
+        return NULL;
+    }
+
+    return ctx;
+}
+
+static inline bool is_tooth(double x) { return x > 0.5; }
+
+static inline SeparationInfo separate(CutSeparationFunctor *self,
+                                      const double *vstar, int32_t *colors,
+                                      int32_t curr_color, double tolerance) {
+    SeparationInfo info = {0};
+    CutSeparationPrivCtx *ctx = self->ctx;
+    const Instance *instance = self->instance;
+    const int32_t n = instance->num_customers + 1;
+
+    info.sense = 'G';
+
+    int32_t num_teeth = 0;
+    size_t toggle_idx = SIZE_MAX;
+    double toggle_dist = INFINITY;
+
+    for (int32_t i = 0; i < n; i++) {
+        if (colors[i] != curr_color) {
+            continue;
+        }
+        for (int32_t j = 0; j < n; j++) {
+            if (colors[j] == curr_color) {
+                continue;
+            }
+
+            size_t x_idx = get_x_mip_var_idx(instance, i, j);
+            double x = vstar[x_idx];
+            if (is_tooth(x)) {
+                ++num_teeth;
+            }
+
+            double dist = fabs(x - 0.5);
+            if (dist < toggle_dist) {
+                toggle_dist = dist;
+                toggle_idx = x_idx;
+            }
+        }
+    }
+
+    // Enforce an odd number of teeth by toggling the least decided edge
+    bool toggle = (num_teeth % 2) == 0 && toggle_idx != SIZE_MAX;
+    if (toggle) {
+        num_teeth += is_tooth(vstar[toggle_idx]) ? -1 : +1;
+    }
+
+    if (num_teeth >= MIN_NUM_TEETH) {
+        for (int32_t i = 0; i < n; i++) {
+            if (colors[i] != curr_color) {
+                continue;
+            }
+            for (int32_t j = 0; j < n; j++) {
+                if (colors[j] == curr_color) {
+                    continue;
+                }
+
+                size_t x_idx = get_x_mip_var_idx(instance, i, j);
+                bool in_teeth = is_tooth(vstar[x_idx]);
+                if (toggle && x_idx == toggle_idx) {
+                    in_teeth = !in_teeth;
+                }
+
+                push_var_lhs(&ctx->super, &info, vstar, in_teeth ? -1.0 : 1.0,
+                             (CPXDIM)x_idx);
+            }
+        }
+
+        add_term_rhs(&ctx->super, &info, 1.0 - num_teeth);
+
+        assert(info.num_vars);
+        info.is_violated = is_violated_cut(&ctx->super, &info, tolerance);
+        validate_cut_info(self, &ctx->super, &info, vstar);
+    }
+
+    info.purgeable = CPX_USECUT_FILTER;
+    info.local_validity = 0; // (Globally valid)
+
+    return info;
+}
+
+static bool fractional_sep(CutSeparationFunctor *self, const double obj_p,
+                           const double *vstar, MaxFlowResult *mf,
+                           double max_flow) {
+    UNUSED_PARAM(obj_p);
+    UNUSED_PARAM(max_flow);
+
+    CutSeparationPrivCtx *ctx = self->ctx;
+    int32_t depot_color = mf->colors[0];
+    SeparationInfo info =
+        separate(self, vstar, mf->colors, depot_color == BLACK ? WHITE : BLACK,
+                 FRACTIONAL_VIOLATION_TOLERANCE);
+    if (!push_fractional_cut("COMB", self, &ctx->super, &info)) {
+        return false;
+    }
+
+    return true;
+}
+
+const CutSeparationIface CUT_COMB_IFACE = {
+    .activate = activate,
+    .deactivate = deactivate,
+    .fractional_sep = fractional_sep,
+    .integral_sep = NULL,
+};
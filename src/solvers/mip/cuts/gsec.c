@@ -93,7 +93,7 @@ static inline void validate_index_array(CutSeparationPrivCtx *ctx, CPXNNZ nnz) {
 
 static inline CPXNNZ get_nnz_upper_bound(const Instance *instance) {
     int32_t n = instance->num_customers + 1;
-    return 1 + (n * n) / 4;
+    return 1 + ((CPXNNZ)n * (CPXNNZ)n) / 4;
 }
 
 static inline bool is_violated_fractional_cut(double flow, double y_i) {
@@ -111,7 +111,7 @@ static void deactivate(CutSeparationPrivCtx *ctx) {
 static CutSeparationPrivCtx *activate(const Instance *instance,
                                       Solver *solver) {
     CutSeparationPrivCtx *ctx = malloc(sizeof(*ctx));
-    int32_t nnz_ub = get_nnz_upper_bound(instance);
+    size_t nnz_ub = get_nnz_upper_bound(instance);
 
     int32_t n = instance->num_customers + 1;
     ctx->index = malloc(nnz_ub * sizeof(*ctx->index));
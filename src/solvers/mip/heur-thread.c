@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2022 Davide Paro
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "heur-thread.h"
+#include "log.h"
+#include "local-search.h"
+
+// NOTE(dparo):
+//      Iterated local search run on its own thread for the whole
+//      Branch&Cut. The incumbents flow both ways through the shared
+//      incumbent slot (see MipSharedIncumbent): the improving tours found by
+//      the search are imported by the relaxation callbacks, while the search
+//      restarts from the CPLEX incumbents published by the global progress
+//      callback. The callbacks never wait on the search: the slot is guarded
+//      by a spin lock held only for copying a tour.
+//      The customers whose Y column is fixed to zero by the reduced cost
+//      fixing cannot be part of an improving tour, and the search drops
+//      them.
+
+/// Gives an infinite negative profit to the customers fixed to zero by the
+/// reduced cost fixing since the last call. `num_seen` is the number of
+/// `rcfix.fixed_cols` entries already processed.
+static void exclude_rcfixed_customers(const SolverData *data,
+                                      const Instance *instance,
+                                      double *profits, CPXDIM *num_seen) {
+    const CPXDIM end = mip_rcfix_num_published(data);
+    const size_t y_offset = get_y_mip_var_idx_offset(instance);
+
+    for (CPXDIM k = *num_seen; k < end; k++) {
+        CPXDIM col = data->rcfix.fixed_cols[k];
+        size_t var_idx =
+            data->sparse.enabled ? data->sparse.col_to_var[col] : (size_t)col;
+        if (var_idx > y_offset) {
+            profits[var_idx - y_offset] = -INFINITY;
+        }
+    }
+
+    *num_seen = end;
+}
+
+/// Removes from `tour` the customers excluded by exclude_rcfixed_customers().
+/// ls_add_drop_swap() does not drop them, their infinite profit giving no
+/// finite delta.
+static void drop_excluded_customers(const double *profits, Tour *tour) {
+    int32_t a = 0;
+    do {
+        int32_t b = tour->succ[a];
+        while (b != 0 && !isfinite(profits[b])) {
+            int32_t next = tour->succ[b];
+            tour->succ[b] = INT32_DEAD_VAL;
+            tour->comp[b] = INT32_DEAD_VAL;
+            b = next;
+        }
+        tour->succ[a] = b;
+        a = b;
+    } while (a != 0);
+}
+
+/// Restarts the search from the shared incumbent, if it was updated since the
+/// last call and it is better than the best tour of the search.
+static void adopt_shared_incumbent(MipSharedIncumbent *shared, Tour *best,
+                                   double *best_cost, int64_t *seen_version) {
+    int64_t version = atomic_load(&shared->version);
+    if (version <= *seen_version) {
+        return;
+    }
+    *seen_version = version;
+
+    mip_spin_lock(&shared->lock);
+    if (shared->cost < *best_cost - COST_TOLERANCE) {
+        tour_copy_into(best, &shared->tour);
+        *best_cost = shared->cost;
+    }
+    mip_spin_unlock(&shared->lock);
+}
+
+/// Publishes `tour` into the shared incumbent slot, if it improves it
+static bool publish_tour(MipSharedIncumbent *shared, const Tour *tour,
+                         double cost) {
+    bool published = false;
+
+    mip_spin_lock(&shared->lock);
+    if (cost < shared->cost - COST_TOLERANCE) {
+        tour_copy_into(&shared->tour, tour);
+        shared->cost = cost;
+        shared->owner = MIP_SHARED_OWNER_HEURISTIC;
+        atomic_fetch_add(&shared->version, 1);
+        published = true;
+    }
+    mip_spin_unlock(&shared->lock);
+
+    return published;
+}
+
+/// Checks that `tour` can be injected into the MIP: it must visit enough
+/// nodes, none of the excluded customers, and respect the edge fixings.
+static bool is_admissible_tour(const SolverData *data,
+                               const Instance *instance,
+                               const double *profits, const Tour *tour) {
+    int32_t num_visited = 0;
+    for (int32_t i = 0; i < instance->num_customers + 1; i++) {
+        if (tour->comp[i] == 0) {
+            if (!isfinite(profits[i])) {
+                return false;
+            }
+            ++num_visited;
+        }
+    }
+
+    return num_visited >= MIP_MIN_NUM_VISITED &&
+           mip_tour_respects_edge_fixings(data, instance, tour);
+}
+
+static void *heur_thread_main(void *arg) {
+    Solver *self = arg;
+    SolverData *data = self->data;
+    MipSharedIncumbent *shared = data->portfolio.shared;
+    const Instance *instance = data->heur_thread.instance;
+    const int32_t n = instance->num_customers + 1;
+    const int32_t max_strength =
+        MAX(1, MIN(LS_ILS_MAX_PERTURBATION, instance->num_customers / 4));
+
+    // NOTE(dparo):
+    //      The search runs over a shallow copy of the instance, whose profits
+    //      are overridden for excluding the reduced cost fixed customers. The
+    //      tours are always evaluated against the original instance.
+    Instance search_instance = *instance;
+    double *profits = malloc(n * sizeof(*profits));
+    Tour best = tour_create(instance);
+    Tour curr = tour_create(instance);
+    LsNeighborLists nl = {0};
+    if (!profits || !tour_is_valid(&best) || !tour_is_valid(&curr) ||
+        !ls_neighbor_lists_create(&nl, instance, LS_ILS_NUM_NEIGHBORS)) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        goto terminate;
+    }
+    memcpy(profits, instance->profits, n * sizeof(*profits));
+    search_instance.profits = profits;
+
+    // The first iteration perturbs the tour visiting the depot only
+    best.succ[0] = 0;
+    best.comp[0] = 0;
+    best.num_comps = 1;
+    double best_cost = INFINITY;
+
+    CPXDIM num_rcfix_seen = 0;
+    int64_t seen_version = 0;
+    int64_t num_iters = 0;
+    int64_t num_published = 0;
+
+    while (!atomic_load(&data->heur_thread.stop) && !self->sigterm_occured) {
+        exclude_rcfixed_customers(data, instance, profits, &num_rcfix_seen);
+        adopt_shared_incumbent(shared, &best, &best_cost, &seen_version);
+
+        tour_copy_into(&curr, &best);
+        drop_excluded_customers(profits, &curr);
+        int32_t strength = 1 + (int32_t)(num_iters % max_strength);
+        ls_perturb(&search_instance, &curr, strength, MIP_MIN_NUM_VISITED,
+                   &data->heur_thread.rng_state);
+        ls_optimize_nl(&search_instance, &nl, &curr, MIP_MIN_NUM_VISITED,
+                       NULL);
+        if (data->lin_kernighan) {
+            ls_lin_kernighan(instance, &nl, &curr, NULL);
+        }
+        ++num_iters;
+
+        double cost = tour_eval(instance, &curr);
+        if (!(cost < best_cost - COST_TOLERANCE) ||
+            !is_admissible_tour(data, instance, profits, &curr)) {
+            continue;
+        }
+
+        tour_copy_into(&best, &curr);
+        best_cost = cost;
+        mip_pricer_collect_tour(data, &curr, cost);
+        if (publish_tour(shared, &curr, cost)) {
+            ++num_published;
+            log_trace("%s :: iteration %lld, published a tour of cost %f",
+                      __func__, (long long)num_iters, cost);
+        }
+    }
+
+    log_info("%s :: %lld iterations, %lld tours published (best cost %f)",
+             __func__, (long long)num_iters, (long long)num_published,
+             best_cost);
+    data->heur_thread.num_iters = num_iters;
+    data->heur_thread.num_published = num_published;
+
+terminate:
+    free(profits);
+    tour_destroy(&best);
+    tour_destroy(&curr);
+    ls_neighbor_lists_destroy(&nl);
+    return NULL;
+}
+
+bool mip_heur_thread_start(Solver *self, const Instance *instance) {
+    SolverData *data = self->data;
+    assert(data->portfolio.shared);
+    assert(!data->heur_thread.running);
+
+    data->heur_thread.instance = instance;
+    data->heur_thread.num_iters = 0;
+    data->heur_thread.num_published = 0;
+    atomic_store(&data->heur_thread.stop, false);
+    if (0 != pthread_create(&data->heur_thread.thread, NULL, heur_thread_main,
+                            self)) {
+        log_fatal("%s :: pthread_create failed", __func__);
+        return false;
+    }
+
+    data->heur_thread.running = true;
+    return true;
+}
+
+void mip_heur_thread_stop(Solver *self) {
+    SolverData *data = self->data;
+    if (!data->heur_thread.running) {
+        return;
+    }
+
+    atomic_store(&data->heur_thread.stop, true);
+    pthread_join(data->heur_thread.thread, NULL);
+    data->heur_thread.running = false;
+}
@@ -54,6 +54,9 @@ Solver mip_solver_create(const Instance *instance, SolverTypedParams *tparams,
 #include "warm-start.h"
 #include "maxflow.h"
 #include "validation.h"
+#include "local-search.h"
+#include "portfolio.h"
+#include "heur-thread.h"
 
 ATTRIB_MAYBE_UNUSED static void show_lp_file(Solver *self) {
     (void)self;
@@ -63,17 +66,6 @@ ATTRIB_MAYBE_UNUSED static void show_lp_file(Solver *self) {
 #endif
 }
 
-// NOTE:
-// From: https://www.ibm.com/docs/en/icos/12.10.0?topic=threads-parameter
-
-// You manage the number of threads that CPLEX uses with the global thread count
-// parameter (Threads, CPX_PARAM_THREADS) documented in the CPLEX Parameters
-// Reference Manual. At its default setting 0 (zero), the number of threads that
-// CPLEX actually uses during a parallel optimization is no more than 32 or the
-// number of CPU cores available on the computer where CPLEX is running
-// (whichever is smaller).
-#define MAX_NUM_CORES 32
-
 typedef enum {
     // NOTE:
     //         This enum should remain packed. Enum fields should maintain a
@@ -82,6 +74,7 @@ typedef enum {
     GSEC_CUT_ID = 0,
     GLM_CUT_ID,
     RCI_CUT_ID,
+    COMB_CUT_ID,
     NUM_CUTS,
 } CutId;
 
@@ -94,6 +87,7 @@ static struct {
     [GSEC_CUT_ID] = {&CUT_GSEC_DESCRIPTOR, true, false},
     [GLM_CUT_ID] = {&CUT_GLM_DESCRIPTOR, false, false},
     [RCI_CUT_ID] = {&CUT_RCI_DESCRIPTOR, false, false},
+    [COMB_CUT_ID] = {&CUT_COMB_DESCRIPTOR, false, false},
 };
 
 static inline bool is_active_cut(CutId id) {
@@ -116,18 +110,65 @@ typedef struct {
     Tour tour;
     CutSeparationFunctor functors[NUM_CUTS];
 
+    /// Buffers indexed by CPLEX column, sized for `num_cols` columns (see
+    /// alloc_col_buffers())
+    CPXDIM num_cols;
     CPXDIM *index;
     double *value;
+
+    /// Buffers used only with the sparse formulation (see
+    /// SolverData::sparse).
+    double *colbuf;
+    CPXDIM *col_index;
+    double *col_value;
+
+    /// Reduced cost fixing: the nodes whose y variable is fixed to zero are
+    /// left out of the separation network, which is built only upon the
+    /// `num_active_nodes` nodes listed in `active_nodes`. The `maxflow`,
+    /// `gh_tree` and `compact_result` are sized accordingly.
+    int32_t *active_nodes;
+    int32_t num_active_nodes;
+    uint8_t *is_fixed_node;
+    MaxFlowResult compact_result;
+    /// Number of entries of `SolverData::rcfix.fixed_cols` already
+    /// accounted for in `active_nodes`
+    CPXDIM rcfix_num_seen;
+
+    /// Cuts separated by this thread, when the solver is persistent
+    CutPool cut_pool;
+
+    /// Relaxation heuristic: scratch tour and the last node it ran at
+    Tour heur_tour;
+    CPXLONG heur_last_node;
 } CallbackThreadLocalData;
 
 /// Struct that is used as a userhandle to be passed to the cplex generic
 /// callback
-typedef struct {
+typedef struct CplexCallbackCtx {
     Solver *solver;
     const Instance *instance;
-    CallbackThreadLocalData thread_local_data[MAX_NUM_CORES];
+    /// One slot per CPLEX thread (see SolverData::num_threads). Each thread
+    /// allocates its own data the first time it is activated, such that the
+    /// memory is first touched, and therefore placed on the NUMA node, of the
+    /// thread using it. The slots are reused across the solves.
+    int32_t num_threads;
+    CallbackThreadLocalData **thread_local_data;
+
+    /// Reduced cost fixing progress, shared among the threads. The entries
+    /// of `SolverData::rcfix.fixed_cols` are written from the global progress
+    /// callback only, and become visible to the other threads once published.
+    struct {
+        /// Number of `fixed_cols` entries visible to every thread
+        _Atomic CPXDIM num_published;
+    } rcfix;
 } CplexCallbackCtx;
 
+/// Number of `SolverData::rcfix.fixed_cols` entries that can be read from
+/// any thread during a solve
+CPXDIM mip_rcfix_num_published(const SolverData *data) {
+    return atomic_load(&data->callback_ctx->rcfix.num_published);
+}
+
 static void
 destroy_callback_thread_local_data(CallbackThreadLocalData *thread_local_data) {
     if (!thread_local_data->valid) {
@@ -148,7 +189,15 @@ destroy_callback_thread_local_data(CallbackThreadLocalData *thread_local_data) {
     free(thread_local_data->index);
     free(thread_local_data->value);
     free(thread_local_data->vstar);
+    free(thread_local_data->colbuf);
+    free(thread_local_data->col_index);
+    free(thread_local_data->col_value);
+    free(thread_local_data->active_nodes);
+    free(thread_local_data->is_fixed_node);
+    max_flow_result_destroy(&thread_local_data->compact_result);
+    cut_pool_destroy(&thread_local_data->cut_pool);
     tour_destroy(&thread_local_data->tour);
+    tour_destroy(&thread_local_data->heur_tour);
     flow_network_destroy(&thread_local_data->network);
     max_flow_destroy(&thread_local_data->maxflow);
     gomory_hu_tree_destroy(&thread_local_data->gh_tree);
@@ -157,11 +206,51 @@ destroy_callback_thread_local_data(CallbackThreadLocalData *thread_local_data) {
 }
 
 static void destroy_all_callback_thread_local_data(CplexCallbackCtx *ctx) {
-    for (int32_t i = 0; i < MAX_NUM_CORES; i++) {
-        if (ctx->thread_local_data[i].valid) {
-            destroy_callback_thread_local_data(&ctx->thread_local_data[i]);
+    for (int32_t i = 0; i < ctx->num_threads; i++) {
+        if (ctx->thread_local_data[i]) {
+            destroy_callback_thread_local_data(ctx->thread_local_data[i]);
+            free(ctx->thread_local_data[i]);
+            ctx->thread_local_data[i] = NULL;
+        }
+    }
+}
+
+/// Allocates the thread local buffers indexed by CPLEX column, unless they
+/// can already hold every column. The sparse formulation can grow between the
+/// solves of a persistent solver (see price_forced_edges()), therefore the
+/// buffers of the thread local data kept alive are grown as well.
+static bool alloc_col_buffers(CallbackThreadLocalData *tld,
+                              const SolverData *data) {
+    const CPXDIM num_cols = mip_num_cols(data);
+    if (tld->index && num_cols <= tld->num_cols) {
+        return true;
+    }
+
+    free(tld->index);
+    free(tld->value);
+    tld->index = malloc(num_cols * sizeof(*tld->index));
+    tld->value = malloc(num_cols * sizeof(*tld->value));
+    bool success = tld->index && tld->value;
+
+    if (data->sparse.enabled) {
+        free(tld->colbuf);
+        free(tld->col_index);
+        free(tld->col_value);
+        tld->colbuf = malloc(num_cols * sizeof(*tld->colbuf));
+        tld->col_index = malloc(num_cols * sizeof(*tld->col_index));
+        tld->col_value = malloc(num_cols * sizeof(*tld->col_value));
+        success &= tld->colbuf && tld->col_index && tld->col_value;
+    }
+
+    for (int32_t cut_id = 0; cut_id < (int32_t)NUM_CUTS; cut_id++) {
+        if (is_active_cut(cut_id)) {
+            tld->functors[cut_id].internal.col_index = tld->col_index;
+            tld->functors[cut_id].internal.col_value = tld->col_value;
         }
     }
+
+    tld->num_cols = success ? num_cols : 0;
+    return success;
 }
 
 static bool
@@ -177,15 +266,28 @@ create_callback_thread_local_data(CallbackThreadLocalData *thread_local_data,
     max_flow_result_create(&thread_local_data->maxflow_result, n);
     gomory_hu_tree_create(&thread_local_data->gh_tree, n);
 
+    thread_local_data->active_nodes =
+        malloc(n * sizeof(*thread_local_data->active_nodes));
+    thread_local_data->is_fixed_node =
+        calloc(n, sizeof(*thread_local_data->is_fixed_node));
+    success &= thread_local_data->active_nodes &&
+               thread_local_data->is_fixed_node;
+    if (thread_local_data->active_nodes) {
+        for (int32_t i = 0; i < n; i++) {
+            thread_local_data->active_nodes[i] = i;
+        }
+    }
+    thread_local_data->num_active_nodes = n;
+
     thread_local_data->tour = tour_create(instance);
+    thread_local_data->heur_tour = tour_create(instance);
+    thread_local_data->heur_last_node = -1;
+    success &= tour_is_valid(&thread_local_data->heur_tour);
 
     thread_local_data->vstar =
         malloc(sizeof(*thread_local_data->vstar) * solver->data->num_mip_vars);
 
-    thread_local_data->index =
-        malloc(solver->data->num_mip_vars * sizeof(*thread_local_data->index));
-    thread_local_data->value =
-        malloc(solver->data->num_mip_vars * sizeof(*thread_local_data->value));
+    success &= alloc_col_buffers(thread_local_data, solver->data);
 
     for (int32_t cut_id = 0; cut_id < (int32_t)NUM_CUTS; cut_id++) {
         if (is_active_cut(cut_id)) {
@@ -195,6 +297,10 @@ create_callback_thread_local_data(CallbackThreadLocalData *thread_local_data,
 
             functor->ctx = iface->activate(instance, solver);
             functor->internal.cplex_cb_ctx = cplex_cb_ctx;
+            functor->internal.col_index = thread_local_data->col_index;
+            functor->internal.col_value = thread_local_data->col_value;
+            functor->internal.cut_pool =
+                solver->persistent ? &thread_local_data->cut_pool : NULL;
             functor->instance = instance;
             functor->solver = solver;
 
@@ -212,6 +318,130 @@ create_callback_thread_local_data(CallbackThreadLocalData *thread_local_data,
     return success;
 }
 
+/// Recreates the separation network, the maxflow and the Gomory-Hu tree of
+/// the thread local data, for a network having `nnodes` nodes.
+static bool resize_separation_network(CallbackThreadLocalData *tld,
+                                      int32_t nnodes) {
+    flow_network_create(&tld->network, nnodes);
+    max_flow_create(&tld->maxflow, nnodes, MAXFLOW_ALGO_PUSH_RELABEL);
+    gomory_hu_tree_destroy(&tld->gh_tree);
+    gomory_hu_tree_create(&tld->gh_tree, nnodes);
+    max_flow_result_destroy(&tld->compact_result);
+    max_flow_result_create(&tld->compact_result, nnodes);
+
+    return tld->network.caps && tld->compact_result.colors;
+}
+
+/// Prepares the thread local data, kept alive from a previous solve of a
+/// persistent solver, for a new solve.
+static bool reset_callback_thread_local_data(CallbackThreadLocalData *tld,
+                                             const Instance *instance,
+                                             const SolverData *data) {
+    const int32_t n = instance->num_customers + 1;
+
+    if (!alloc_col_buffers(tld, data)) {
+        return false;
+    }
+
+    tld->fractional_sep_it = 0;
+    tld->rcfix_num_seen = 0;
+    tld->heur_last_node = -1;
+    memset(tld->is_fixed_node, 0, n * sizeof(*tld->is_fixed_node));
+    for (int32_t i = 0; i < n; i++) {
+        tld->active_nodes[i] = i;
+    }
+    tld->num_active_nodes = n;
+
+    if (tld->network.nnodes != n) {
+        return resize_separation_network(tld, n);
+    }
+    return true;
+}
+
+static void pricer_clear_tours(SolverData *data) {
+    for (ptrdiff_t i = 0; i < arrlen(data->pricer.tours); i++) {
+        tour_destroy(&data->pricer.tours[i]);
+    }
+    arrfree(data->pricer.tours);
+    arrfree(data->pricer.costs);
+}
+
+/// Records `tour` among the best `PRICER_NUM_TOURS` distinct negative reduced
+/// cost tours found so far. Non negative tours are discarded. Thread safe.
+void mip_pricer_collect_tour(SolverData *data, const Tour *tour, double cost) {
+    const int32_t k = data->pricer.num_tours;
+    if (k <= 0 || !is_valid_reduced_cost(cost)) {
+        return;
+    }
+
+    mip_spin_lock(&data->pricer.lock);
+
+    ptrdiff_t len = arrlen(data->pricer.tours);
+    bool duplicate = false;
+    for (ptrdiff_t i = 0; i < len && !duplicate; i++) {
+        duplicate = tour_same_route(&data->pricer.tours[i], tour);
+    }
+
+    if (!duplicate && (len < k || cost < data->pricer.costs[len - 1])) {
+        if (len >= k) {
+            // Evict the worst tour
+            tour_destroy(&data->pricer.tours[len - 1]);
+            arrsetlen(data->pricer.tours, len - 1);
+            arrsetlen(data->pricer.costs, len - 1);
+            --len;
+        }
+
+        // Insertion sort by increasing cost
+        arrput(data->pricer.tours, tour_copy(tour));
+        arrput(data->pricer.costs, cost);
+        for (ptrdiff_t i = len; i > 0; i--) {
+            if (data->pricer.costs[i - 1] <= data->pricer.costs[i]) {
+                break;
+            }
+            SWAP(Tour, data->pricer.tours[i - 1], data->pricer.tours[i]);
+            SWAP(double, data->pricer.costs[i - 1], data->pricer.costs[i]);
+        }
+    }
+
+    mip_spin_unlock(&data->pricer.lock);
+}
+
+/// Pricer mode can stop as soon as `PRICER_NUM_TOURS` distinct negative
+/// reduced cost tours are collected. If only one tour is requested, a
+/// negative `primal_bound` is enough.
+bool mip_pricer_is_done(SolverData *data, double primal_bound) {
+    const int32_t k = data->pricer.num_tours;
+    if (k <= 1 && is_valid_reduced_cost(primal_bound)) {
+        return true;
+    }
+
+    mip_spin_lock(&data->pricer.lock);
+    bool done = k > 0 && arrlen(data->pricer.tours) >= k;
+    mip_spin_unlock(&data->pricer.lock);
+    return done;
+}
+
+/// Objective value that a solution must beat to be of any interest, given the
+/// `incumbent`. With `PRICER_NUM_TOURS` > 1 every one of the best tours is
+/// wanted, not only the best one: the bound is the cost of the worst collected
+/// tour, and stays at the upper cutoff until all of them are collected. Used
+/// to drop the variables that cannot take part in any interesting solution.
+/// Thread safe.
+static double interesting_primal_bound(SolverData *data, double incumbent) {
+    const int32_t k = data->pricer.num_tours;
+    if (k <= 1) {
+        return MIN(incumbent, data->upper_cutoff);
+    }
+
+    double bound = data->upper_cutoff;
+    mip_spin_lock(&data->pricer.lock);
+    if (arrlen(data->pricer.costs) >= k) {
+        bound = MIN(bound, data->pricer.costs[k - 1]);
+    }
+    mip_spin_unlock(&data->pricer.lock);
+    return bound;
+}
+
 static void validate_mip_vars_packing(const Instance *instance) {
 #ifndef NDEBUG
     size_t cnt = 0;
@@ -232,6 +462,29 @@ static void validate_mip_vars_packing(const Instance *instance) {
 #endif
 }
 
+/// Checks that `tour` uses none of the forbidden edges, and all the forced ones
+bool mip_tour_respects_edge_fixings(const SolverData *data,
+                                    const Instance *instance,
+                                    const Tour *tour) {
+    if (!data->edge_fixing.state) {
+        return true;
+    }
+
+    int32_t num_forced = 0;
+    for (int32_t i = 0; i < instance->num_customers + 1; i++) {
+        if (tour->comp[i] < 0) {
+            continue;
+        }
+        EdgeFixing fixing = mip_edge_fixing(data, instance, i, tour->succ[i]);
+        if (fixing == EDGE_FIXING_FORBIDDEN) {
+            return false;
+        }
+        num_forced += fixing == EDGE_FIXING_FORCED;
+    }
+
+    return num_forced == data->edge_fixing.num_forced;
+}
+
 void unpack_mip_solution(const Instance *instance, Tour *t, double *vstar) {
 
     int32_t n = t->num_customers + 1;
@@ -302,61 +555,90 @@ void unpack_mip_solution(const Instance *instance, Tour *t, double *vstar) {
 
 static bool add_degree_constraints(Solver *self, const Instance *instance) {
     bool result = true;
-    CPXNNZ nnz = instance->num_customers + 1;
-
-    CPXNNZ rmatbeg[] = {0};
-    CPXDIM *index = NULL;
-    double *value = NULL;
-    char cname[128];
-    const char *pcname[] = {(const char *)cname};
-
-    double rhs[] = {0.0};
-    char sense[] = {'E'};
-
-    index = malloc(nnz * sizeof(*index));
-    value = malloc(nnz * sizeof(*value));
+    const int32_t n = instance->num_customers + 1;
 
-    if (!index || !value) {
+    // NOTE(dparo):
+    //      Each degree row has the (n - 1) X variables incident to the node,
+    //      plus the Y variable of the node itself. All the rows are submitted
+    //      to CPLEX in a single bulk CPXXaddrows call.
+    //      With the sparse formulation, the pruned X variables are skipped.
+    //      The degree row of node `i` is always the i-th row of the LP: the
+    //      edge pricing relies on this.
+    assert(CPXXgetnumrows(self->data->env, self->data->lp) == 0);
+    const CPXNNZ nnz = (CPXNNZ)n * n;
+
+    CPXNNZ *rmatbeg = malloc(n * sizeof(*rmatbeg));
+    CPXDIM *index = malloc(nnz * sizeof(*index));
+    double *value = malloc(nnz * sizeof(*value));
+    double *rhs = malloc(n * sizeof(*rhs));
+    char *sense = malloc(n * sizeof(*sense));
+    char *names_buf = NULL;
+    char **rownames = NULL;
+
+    if (!rmatbeg || !index || !value || !rhs || !sense) {
         log_fatal("%s :: Failed memory allocation", __func__);
         result = false;
         goto terminate;
     }
 
-    for (int32_t i = 0; i < instance->num_customers + 1; i++) {
-        snprintf_safe(cname, ARRAY_LEN(cname), "deg(%d)", i);
-        int32_t cnt = 0;
+    if (self->data->var_names) {
+        names_buf = malloc(n * MIP_NAME_MAX_LEN * sizeof(*names_buf));
+        rownames = malloc(n * sizeof(*rownames));
+        if (!names_buf || !rownames) {
+            log_fatal("%s :: Failed memory allocation", __func__);
+            result = false;
+            goto terminate;
+        }
+    }
+
+    CPXNNZ cnt = 0;
+    for (int32_t i = 0; i < n; i++) {
+        rmatbeg[i] = cnt;
+        rhs[i] = 0.0;
+        sense[i] = 'E';
 
-        for (int32_t j = 0; j < instance->num_customers + 1; j++) {
+        if (rownames) {
+            rownames[i] = names_buf + (size_t)i * MIP_NAME_MAX_LEN;
+            snprintf_safe(rownames[i], MIP_NAME_MAX_LEN, "deg(%d)", i);
+        }
+
+        for (int32_t j = 0; j < n; j++) {
             if (i == j) {
                 continue;
             }
 
-            int32_t x_idx = get_x_mip_var_idx(instance, i, j);
-            index[cnt] = x_idx;
-            value[cnt] = +1.0;
-            cnt++;
-            // log_trace("%s :: x_idx = %d", __func__, x_idx);
+            CPXDIM col =
+                mip_var_to_col(self->data, get_x_mip_var_idx(instance, i, j));
+            if (col >= 0) {
+                index[cnt] = col;
+                value[cnt] = +1.0;
+                cnt++;
+            }
         }
 
-        assert(cnt == instance->num_customers);
-        int32_t y_idx = get_y_mip_var_idx(instance, i);
-        index[cnt] = y_idx;
+        index[cnt] = mip_var_to_col(self->data, get_y_mip_var_idx(instance, i));
         value[cnt] = -2.0;
         cnt++;
+    }
 
-        assert(cnt == nnz);
+    assert(self->data->sparse.enabled || cnt == nnz);
 
-        if (CPXXaddrows(self->data->env, self->data->lp, 0, 1, nnz, rhs, sense,
-                        rmatbeg, index, value, NULL, pcname)) {
-            log_fatal("%s :: CPXXaddrows failure", __func__);
-            result = false;
-            goto terminate;
-        }
+    if (CPXXaddrows(self->data->env, self->data->lp, 0, n, cnt, rhs, sense,
+                    rmatbeg, index, value, NULL,
+                    (const char *const *)rownames)) {
+        log_fatal("%s :: CPXXaddrows failure", __func__);
+        result = false;
+        goto terminate;
     }
 
 terminate:
+    free(rmatbeg);
     free(index);
     free(value);
+    free(rhs);
+    free(sense);
+    free(names_buf);
+    free(rownames);
 
 #if 0
     if (result) {
@@ -371,7 +653,8 @@ static bool add_depot_is_part_of_tour_constraint(Solver *self,
                                                  const Instance *instance) {
     bool result = true;
 
-    CPXDIM indices[] = {get_y_mip_var_idx(instance, 0)};
+    CPXDIM indices[] = {
+        mip_var_to_col(self->data, get_y_mip_var_idx(instance, 0))};
     char lu[] = {'L'};
     double bd[] = {1.0};
     if (CPXXchgbds(self->data->env, self->data->lp, 1, indices, lu, bd)) {
@@ -408,14 +691,15 @@ static bool add_capacity_ub(Solver *self, const Instance *instance) {
     assert(demand(instance, 0) == 0.0);
 
     for (int32_t i = 0; i < nnz; i++) {
-        index[i] = (CPXDIM)get_y_mip_var_idx(instance, i);
+        index[i] = mip_var_to_col(self->data, get_y_mip_var_idx(instance, i));
         value[i] = demand(instance, i);
     }
 
     snprintf_safe(cname, ARRAY_LEN(cname), "CAP_UB");
 
     if (CPXXaddrows(self->data->env, self->data->lp, 0, 1, nnz, rhs, sense,
-                    rmatbeg, index, value, NULL, pcname)) {
+                    rmatbeg, index, value, NULL,
+                    self->data->var_names ? pcname : NULL)) {
         log_fatal("%s :: CPXXaddrows failure", __func__);
         result = false;
         goto terminate;
@@ -508,7 +792,7 @@ static bool add_capacity_lb(Solver *self, const Instance *instance) {
     value = malloc(nnz * sizeof(*value));
 
     for (int32_t i = 0; i < nnz; i++) {
-        index[i] = (CPXDIM)get_y_mip_var_idx(instance, i);
+        index[i] = mip_var_to_col(self->data, get_y_mip_var_idx(instance, i));
         value[i] = demand(instance, i);
     }
 
@@ -516,7 +800,8 @@ static bool add_capacity_lb(Solver *self, const Instance *instance) {
 
     // Add rows
     if (CPXXaddrows(self->data->env, self->data->lp, 0, 1, nnz, rhs, sense,
-                    rmatbeg, index, value, NULL, pcname)) {
+                    rmatbeg, index, value, NULL,
+                    self->data->var_names ? pcname : NULL)) {
         log_fatal("%s :: CPXXaddrows failure", __func__);
         result = false;
         goto terminate;
@@ -535,244 +820,869 @@ terminate:
     return result;
 }
 
-bool build_mip_formulation(Solver *self, const Instance *instance) {
-    bool result = true;
+static bool add_mip_columns(Solver *self, CPXDIM ncols, const double *obj,
+                            const double *lb, const double *ub,
+                            const char *xctype, char **colnames) {
+    if (CPXXnewcols(self->data->env, self->data->lp, ncols, obj, lb, ub, xctype,
+                    (const char *const *)colnames)) {
+        log_fatal("%s :: CPXXnewcols returned an error", __func__);
+        return false;
+    }
+    return true;
+}
 
-    //
-    // Create all the MIP variables that we need first (eg add the columns)
-    //
+typedef struct {
+    int32_t i, j;
+} SparseEdge;
 
-    // Create the X MIP variable
-    {
-        double obj[1];
-        double lb[1] = {0.0};
-        double ub[1] = {1.0};
-        char xctype[] = {'B'};
+typedef struct {
+    size_t key;
+    bool value;
+} SelectedVarEntry;
+
+/// Selects the edges initially part of the sparse formulation: the edges
+/// connecting each vertex to its `k` nearest neighbours, plus all the edges
+/// incident to the depot. Selected edges are marked with a non negative value
+/// in `var_to_col`. Returns the number of selected edges.
+static size_t select_sparse_edges(Solver *self, const Instance *instance,
+                                  int32_t k) {
+    const int32_t n = instance->num_customers + 1;
+    CPXDIM *var_to_col = self->data->sparse.var_to_col;
+    size_t num_selected = 0;
+
+    for (size_t v = 0; v < self->data->num_mip_vars; v++) {
+        var_to_col[v] = -1;
+    }
 
-        char cname[128];
-        const char *pcname[] = {(const char *)cname};
+    k = MAX(1, MIN(k, n - 1));
+    int32_t *nn = malloc(k * sizeof(*nn));
+    double *nn_cost = malloc(k * sizeof(*nn_cost));
 
+    for (int32_t i = 0; i < n; i++) {
         int32_t cnt = 0;
-        for (int32_t i = 0; i < instance->num_customers + 1; i++) {
-            for (int32_t j = i + 1; j < instance->num_customers + 1; j++) {
-                if (i == j)
-                    continue;
-
-                snprintf_safe(cname, sizeof(cname), "x(%d,%d)", i, j);
-                obj[0] = cost(instance, i, j);
+        for (int32_t j = 0; j < n; j++) {
+            if (i == j) {
+                continue;
+            }
+            double c = cost(instance, i, j);
+            if (cnt == k && c >= nn_cost[cnt - 1]) {
+                continue;
+            }
 
-                if (CPXXnewcols(self->data->env, self->data->lp, 1, obj, lb, ub,
-                                xctype, pcname)) {
-                    log_fatal("%s :: CPXXnewcols returned an error", __func__);
-                    return false;
-                }
-                cnt++;
+            // Sorted insertion
+            int32_t pos = cnt < k ? cnt++ : cnt - 1;
+            while (pos > 0 && nn_cost[pos - 1] > c) {
+                nn[pos] = nn[pos - 1];
+                nn_cost[pos] = nn_cost[pos - 1];
+                --pos;
             }
+            nn[pos] = j;
+            nn_cost[pos] = c;
+        }
+
+        for (int32_t m = 0; m < cnt; m++) {
+            size_t var_idx = get_x_mip_var_idx(instance, i, nn[m]);
+            num_selected += var_to_col[var_idx] < 0;
+            var_to_col[var_idx] = 0;
         }
-        assert(cnt == hm_nentries(instance->num_customers + 1));
     }
 
-    assert(hm_nentries(instance->num_customers + 1) ==
-           CPXXgetnumcols(self->data->env, self->data->lp));
+    for (int32_t j = 1; j < n; j++) {
+        size_t var_idx = get_x_mip_var_idx(instance, 0, j);
+        num_selected += var_to_col[var_idx] < 0;
+        var_to_col[var_idx] = 0;
+    }
 
-    // Create the Y MIP variable
-    {
+    free(nn);
+    free(nn_cost);
+    return num_selected;
+}
 
-        double obj[1];
-        double lb[1] = {0.0};
-        double ub[1] = {1.0};
-        char xctype[] = {'B'};
+/// Adds to the sparse formulation the columns associated to the given edges.
+/// The coefficients of the new columns in the degree rows are filled in as
+/// well.
+static bool add_sparse_edges(Solver *self, const Instance *instance,
+                             const SparseEdge *edges, CPXDIM count) {
+    bool result = true;
+    SolverData *data = self->data;
 
-        char cname[128];
-        const char *pcname[] = {(const char *)cname};
+    if (count <= 0) {
+        return true;
+    }
 
-        for (int32_t i = 0; i < instance->num_customers + 1; i++) {
-            snprintf_safe(cname, sizeof(cname), "y(%d)", i);
-            obj[0] = -1.0 * profit(instance, i);
+    double *obj = malloc(count * sizeof(*obj));
+    double *lb = malloc(count * sizeof(*lb));
+    double *ub = malloc(count * sizeof(*ub));
+    CPXNNZ *cmatbeg = malloc(count * sizeof(*cmatbeg));
+    CPXDIM *cmatind = malloc(2 * count * sizeof(*cmatind));
+    double *cmatval = malloc(2 * count * sizeof(*cmatval));
+    char *xctype = malloc(count * sizeof(*xctype));
+    CPXDIM *indices = malloc(count * sizeof(*indices));
+    char *names_buf = NULL;
+    char **colnames = NULL;
+
+    if (!obj || !lb || !ub || !cmatbeg || !cmatind || !cmatval || !xctype ||
+        !indices) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        result = false;
+        goto terminate;
+    }
 
-            if (CPXXnewcols(self->data->env, self->data->lp, 1, obj, lb, ub,
-                            xctype, pcname)) {
-                log_fatal("%s :: CPXXnewcols returned an error", __func__);
-                return false;
-            }
+    if (data->var_names) {
+        names_buf = malloc((size_t)count * MIP_NAME_MAX_LEN *
+                           sizeof(*names_buf));
+        colnames = malloc(count * sizeof(*colnames));
+        if (!names_buf || !colnames) {
+            log_fatal("%s :: Failed memory allocation", __func__);
+            result = false;
+            goto terminate;
         }
     }
 
-    //
-    // Now create the constraints (eg add the rows)
-    //
-
-    validate_mip_vars_packing(instance);
-
-    if (!add_degree_constraints(self, instance)) {
-        log_fatal("%s :: add_degree_constraints failed", __func__);
-        return false;
+    for (CPXDIM k = 0; k < count; k++) {
+        const int32_t i = edges[k].i;
+        const int32_t j = edges[k].j;
+        size_t var_idx = get_x_mip_var_idx(instance, i, j);
+        CPXDIM col = data->sparse.num_cols + k;
+
+        assert(data->sparse.var_to_col[var_idx] < 0);
+        assert(arrlen(data->sparse.col_to_var) == col);
+        data->sparse.var_to_col[var_idx] = col;
+        arrput(data->sparse.col_to_var, var_idx);
+
+        // NOTE(dparo): Pricing an edge back in must not undo its fixing
+        EdgeFixing fixing = mip_edge_fixing(data, instance, i, j);
+        obj[k] = cost(instance, i, j);
+        lb[k] = fixing == EDGE_FIXING_FORCED ? 1.0 : 0.0;
+        ub[k] = fixing == EDGE_FIXING_FORBIDDEN ? 0.0 : 1.0;
+        xctype[k] = 'B';
+        indices[k] = col;
+
+        // The degree row of node `i` is the i-th row
+        cmatbeg[k] = 2 * k;
+        cmatind[2 * k + 0] = i;
+        cmatind[2 * k + 1] = j;
+        cmatval[2 * k + 0] = 1.0;
+        cmatval[2 * k + 1] = 1.0;
+
+        if (colnames) {
+            colnames[k] = names_buf + (size_t)k * MIP_NAME_MAX_LEN;
+            snprintf_safe(colnames[k], MIP_NAME_MAX_LEN, "x(%d,%d)", MIN(i, j),
+                          MAX(i, j));
+        }
     }
 
-    if (!add_depot_is_part_of_tour_constraint(self, instance)) {
-        log_fatal("%s :: add_depot_is_part_of_tour_constraint failed",
-                  __func__);
-        return false;
-    }
-    if (!add_capacity_ub(self, instance)) {
-        log_fatal("%s :: add_capacity_ub constraint failed", __func__);
-        return false;
+    if (CPXXaddcols(data->env, data->lp, count, 2 * count, obj, cmatbeg,
+                    cmatind, cmatval, lb, ub,
+                    (const char *const *)colnames)) {
+        log_fatal("%s :: CPXXaddcols failure", __func__);
+        result = false;
+        goto terminate;
     }
 
-    if (!add_capacity_lb(self, instance)) {
-        log_fatal("%s :: add_capacity_lb constraint failed", __func__);
-        return false;
+    data->sparse.num_cols += count;
+
+    if (data->sparse.finalized) {
+        if (CPXXchgctype(data->env, data->lp, count, indices, xctype)) {
+            log_fatal("%s :: CPXXchgctype failure", __func__);
+            result = false;
+            goto terminate;
+        }
     }
 
+terminate:
+    free(obj);
+    free(lb);
+    free(ub);
+    free(cmatbeg);
+    free(cmatind);
+    free(cmatval);
+    free(xctype);
+    free(indices);
+    free(names_buf);
+    free(colnames);
     return result;
 }
 
-#define CAP_DOUBLE_TO_INT (1 << 24)
-
-static void init_flow_network(FlowNetwork *net, const Instance *instance,
-                              const double *vstar) {
+static inline double sparse_edge_reduced_cost(const SolverData *data,
+                                              const Instance *instance,
+                                              int32_t i, int32_t j) {
+    return cost(instance, i, j) - data->sparse.duals[i] -
+           data->sparse.duals[j];
+}
 
+#define SPARSE_MAX_PRICING_ROUNDS (128)
+#define SPARSE_PRICING_RC_TOLERANCE (1e-6)
+
+/// Column generation on the LP relaxation (degree and capacity constraints
+/// only) of the sparse formulation. At each round the LP is solved and the
+/// pruned edges having a negative reduced cost, computed from the duals of
+/// the degree constraints, are added to the LP.
+/// At the end, a lower bound of the (complete) LP relaxation is available in
+/// `lagrangian_bound`. Even if pricing does not converge, this bound remains
+/// valid by accounting the negative reduced costs of the edges still pruned.
+static bool price_sparse_formulation(Solver *self, const Instance *instance) {
+    bool result = true;
+    SolverData *data = self->data;
     const int32_t n = instance->num_customers + 1;
 
-    for (int32_t i = 0; i < n; i++) {
-        for (int32_t j = 0; j < n; j++) {
-            double cap =
-                i == j ? 0.0 : vstar[get_x_mip_var_idx(instance, i, j)];
-            assert(fgte(cap, 0.0, 1e-5));
-            // NOTE: Fix floating point rounding errors. In fact cap may be
-            // slightly negative...
-            cap = MAX(0.0, cap);
-            if (feq(cap, 0.0, 1e-6)) {
-                cap = 0.0;
+    // NOTE(dparo):
+    //      Only the edges priced in by a round are stored (stb_ds array),
+    //      instead of sizing the buffer for every pruned edge.
+    SparseEdge *edges = NULL;
+
+    data->sparse.lagrangian_bound = -INFINITY;
+
+    for (int32_t round = 0; round < SPARSE_MAX_PRICING_ROUNDS; round++) {
+        if (CPXXlpopt(data->env, data->lp) != 0) {
+            log_fatal("%s :: CPXXlpopt failed", __func__);
+            result = false;
+            goto terminate;
+        }
+
+        double lp_obj = -INFINITY;
+        int lpstat = CPXXgetstat(data->env, data->lp);
+        if (lpstat != CPX_STAT_OPTIMAL ||
+            CPXXgetobjval(data->env, data->lp, &lp_obj) != 0 ||
+            CPXXgetpi(data->env, data->lp, data->sparse.duals, 0, n - 1) != 0) {
+            // NOTE(dparo):
+            //      The restricted LP can be infeasible (eg the pruned
+            //      formulation does not contain enough edges to satisfy the
+            //      capacity lower bound). We have no duals to price with, thus
+            //      leave the lagrangian bound to -INFINITY: the completion
+            //      step will add back every pruned edge.
+            log_warn("%s :: restricted LP not solved to optimality (lpstat = "
+                     "%d). Pricing cannot proceed",
+                     __func__, lpstat);
+            data->sparse.lagrangian_bound = -INFINITY;
+            break;
+        }
+
+        double penalty = 0.0;
+        arrsetlen(edges, 0);
+        for (int32_t i = 0; i < n; i++) {
+            for (int32_t j = i + 1; j < n; j++) {
+                size_t var_idx = get_x_mip_var_idx(instance, i, j);
+                if (data->sparse.var_to_col[var_idx] >= 0) {
+                    continue;
+                }
+                double rc = sparse_edge_reduced_cost(data, instance, i, j);
+                if (rc < -SPARSE_PRICING_RC_TOLERANCE) {
+                    SparseEdge e = {i, j};
+                    arrput(edges, e);
+                    penalty += rc;
+                }
             }
-            assert(cap >= 0.0);
-            flow_t cap_int = (flow_t)(cap * CAP_DOUBLE_TO_INT);
-            flow_net_set_cap(net, i, j, cap_int);
+        }
+        const CPXDIM cnt = (CPXDIM)arrlen(edges);
+
+        data->sparse.lagrangian_bound = lp_obj + penalty;
+
+        log_info("%s :: round %d -- LP obj = %f, lagrangian bound = %f, "
+                 "num_cols = %d, adding %d columns",
+                 __func__, round, lp_obj, data->sparse.lagrangian_bound,
+                 data->sparse.num_cols, cnt);
+
+        if (cnt == 0) {
+            break;
+        }
+
+        if (!add_sparse_edges(self, instance, edges, cnt)) {
+            result = false;
+            goto terminate;
         }
     }
+
+terminate:
+    arrfree(edges);
+    return result;
 }
 
-static inline bool
-is_any_fractional_cut_enabled(const CallbackThreadLocalData *tld) {
-    for (int32_t cut_id = 0; cut_id < (int32_t)NUM_CUTS; cut_id++) {
-        if (is_fractional_cut_active(cut_id)) {
-            const CutSeparationIface *iface = G_cuts[cut_id].descr->iface;
-            if (iface->fractional_sep) {
-                return true;
+/// Adds back to the sparse formulation every pruned edge that can be part of a
+/// solution having cost strictly lower than `primal_bound`, together with the
+/// edges used by the deferred warm start tours. An edge e can be part of such a
+/// solution only if `lagrangian_bound + rc(e) < primal_bound`. After this
+/// step, the optimal solution of the restricted MIP is the optimal solution of
+/// the complete one, as long as its cost is lower than `primal_bound`.
+static bool complete_sparse_formulation(Solver *self, const Instance *instance,
+                                        double primal_bound) {
+    bool result = true;
+    SolverData *data = self->data;
+    const int32_t n = instance->num_customers + 1;
+    const double lagrangian_bound = data->sparse.lagrangian_bound;
+    const double gap = primal_bound - lagrangian_bound;
+
+    // NOTE(dparo):
+    //      Both the edges used by the warm starts (stb_ds hashmap keyed by the
+    //      MIP variable index) and the edges added back (stb_ds array) are
+    //      few compared to the pruned ones: do not size anything O(n^2).
+    SelectedVarEntry *selected = NULL;
+    SparseEdge *edges = NULL;
+
+    for (ptrdiff_t t = 0; t < arrlen(data->sparse.deferred_warm_starts); t++) {
+        Tour *tour = &data->sparse.deferred_warm_starts[t];
+        for (int32_t i = 0; i < n; i++) {
+            int32_t j = tour->succ[i];
+            if (tour->comp[i] >= 0 && i != j) {
+                size_t var_idx = get_x_mip_var_idx(instance, i, j);
+                hmput(selected, var_idx, true);
             }
         }
     }
-    return false;
-}
-
-static int cplex_on_new_relaxation(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
-                                   CplexCallbackCtx *ctx, int32_t threadid,
-                                   int32_t numthreads) {
-    // NOTE:
-    //      Called when cplex has a new feasible LP solution (not necessarily
-    //      satisfying the integrality constraints)
 
-    assert(threadid < numthreads);
-    assert(threadid <= MAX_NUM_CORES);
+    for (int32_t i = 0; i < n; i++) {
+        for (int32_t j = i + 1; j < n; j++) {
+            size_t var_idx = get_x_mip_var_idx(instance, i, j);
+            if (data->sparse.var_to_col[var_idx] >= 0) {
+                continue;
+            }
 
-    Solver *solver = ctx->solver;
-    const Instance *instance = ctx->instance;
-    CallbackThreadLocalData *tld = &ctx->thread_local_data[threadid];
-    double *vstar = tld->vstar;
+            bool add = isinf(gap) || hmgetp_null(selected, var_idx) != NULL;
+            if (!add) {
+                double rc = sparse_edge_reduced_cost(data, instance, i, j);
+                add = rc < 0.0 || rc < gap + COST_TOLERANCE;
+            }
 
-    if (!solver->data->fractional_separation_enabled) {
-        return 0;
+            if (add) {
+                SparseEdge e = {i, j};
+                arrput(edges, e);
+            }
+        }
     }
+    const CPXDIM cnt = (CPXDIM)arrlen(edges);
 
-    if (!vstar) {
-        log_fatal("%s :: Failed memory allocation", __func__);
-        goto terminate;
-    }
+    log_info("%s :: primal_bound = %f, lagrangian_bound = %f -- adding back "
+             "%d of the %lld pruned edges",
+             __func__, primal_bound, lagrangian_bound, cnt,
+             (long long)(hm_nentries(n) - (data->sparse.num_cols - n)));
 
-    double obj_p = INFINITY;
-    if (CPXXcallbackgetrelaxationpoint(
-            cplex_cb_ctx, vstar, 0, solver->data->num_mip_vars - 1, &obj_p)) {
-        log_fatal("%s :: Failed `CPXXcallbackgetrelaxationpoint`", __func__);
+    if (!add_sparse_edges(self, instance, edges, cnt)) {
+        result = false;
         goto terminate;
     }
 
-    const bool any_fractional = is_any_fractional_cut_enabled(tld);
-    bool do_fractional_sep = true;
-    if (solver->data->amortized_fractional_labeling) {
-        do_fractional_sep =
-            (tld->fractional_sep_it % (instance->num_customers + 1) == 0);
-    } else {
-        do_fractional_sep = true;
+terminate:
+    hmfree(selected);
+    arrfree(edges);
+    return result;
+}
+
+/// Converts the (LP) sparse formulation into a MIP.
+static bool finalize_sparse_formulation(Solver *self) {
+    bool result = true;
+    SolverData *data = self->data;
+    const CPXDIM num_cols = data->sparse.num_cols;
+
+    CPXDIM *indices = malloc(num_cols * sizeof(*indices));
+    char *xctype = malloc(num_cols * sizeof(*xctype));
+    if (!indices || !xctype) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        result = false;
+        goto terminate;
     }
 
-    if (any_fractional && do_fractional_sep) {
-        FlowNetwork *net = &tld->network;
-        init_flow_network(net, instance, vstar);
+    for (CPXDIM c = 0; c < num_cols; c++) {
+        indices[c] = c;
+        xctype[c] = 'B';
+    }
 
-        max_flow_all_pairs(net, &tld->maxflow, &tld->gh_tree);
+    if (CPXXchgprobtype(data->env, data->lp, CPXPROB_MILP) != 0 ||
+        CPXXchgctype(data->env, data->lp, num_cols, indices, xctype) != 0) {
+        log_fatal("%s :: Failed to convert the sparse formulation to a MIP",
+                  __func__);
+        result = false;
+        goto terminate;
+    }
 
-        for (int32_t s = 0; s < instance->num_customers + 1; s++) {
-            for (int32_t t = 0; t < instance->num_customers + 1; t++) {
-                if (s == t) {
-                    continue;
+    data->sparse.finalized = true;
+
+terminate:
+    free(indices);
+    free(xctype);
+    return result;
+}
+
+bool build_mip_formulation(Solver *self, const Instance *instance) {
+    bool result = true;
+    const int32_t n = instance->num_customers + 1;
+    const size_t num_x_vars = (size_t)hm_nentries(n);
+
+    self->data->num_mip_vars = get_y_mip_var_idx_offset(instance) + n;
+
+    // Number of X columns actually created
+    size_t num_x_cols = num_x_vars;
+    if (self->data->sparse.enabled) {
+        SolverData *data = self->data;
+        data->sparse.var_to_col =
+            malloc(data->num_mip_vars * sizeof(*data->sparse.var_to_col));
+        data->sparse.duals = calloc(n, sizeof(*data->sparse.duals));
+        if (!data->sparse.var_to_col || !data->sparse.duals) {
+            log_fatal("%s :: Failed memory allocation", __func__);
+            return false;
+        }
+        num_x_cols = select_sparse_edges(self, instance, data->sparse.knn);
+        arrsetcap(data->sparse.col_to_var, num_x_cols + n);
+    }
+
+    //
+    // Create all the MIP variables that we need first (eg add the columns)
+    //
+    // NOTE(dparo):
+    //      The columns are built in contiguous arrays and submitted in bulk.
+    //      Calling CPXXnewcols once per variable requires O(n^2) API calls,
+    //      which quickly dominates the model construction time.
+    //      Names are generated only if explicitly requested (see `VAR_NAMES`
+    //      param), since formatting O(n^2) strings is far from free.
+    //
+    //      With the sparse formulation only a subset of the X variables is
+    //      created, and the columns are created continuous: the LP undergoes
+    //      edge pricing first (see price_sparse_formulation()), and only
+    //      then it gets converted to a MIP.
+    const bool sparse = self->data->sparse.enabled;
+    const size_t max_ncols = MAX(num_x_cols, (size_t)n);
+    double *obj = malloc(max_ncols * sizeof(*obj));
+    double *lb = malloc(max_ncols * sizeof(*lb));
+    double *ub = malloc(max_ncols * sizeof(*ub));
+    char *xctype = malloc(max_ncols * sizeof(*xctype));
+    char *names_buf = NULL;
+    char **colnames = NULL;
+
+    if (!obj || !lb || !ub || !xctype) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        result = false;
+        goto terminate;
+    }
+
+    if (self->data->var_names) {
+        names_buf = malloc((size_t)max_ncols * MIP_NAME_MAX_LEN *
+                           sizeof(*names_buf));
+        colnames = malloc(max_ncols * sizeof(*colnames));
+        if (!names_buf || !colnames) {
+            log_fatal("%s :: Failed memory allocation", __func__);
+            result = false;
+            goto terminate;
+        }
+        for (size_t k = 0; k < max_ncols; k++) {
+            colnames[k] = names_buf + k * MIP_NAME_MAX_LEN;
+        }
+    }
+
+    // Create the X MIP variable
+    {
+        CPXDIM cnt = 0;
+        for (int32_t i = 0; i < n; i++) {
+            for (int32_t j = i + 1; j < n; j++) {
+                size_t var_idx = get_x_mip_var_idx(instance, i, j);
+                if (sparse) {
+                    if (self->data->sparse.var_to_col[var_idx] < 0) {
+                        continue;
+                    }
+                    self->data->sparse.var_to_col[var_idx] = cnt;
+                    arrput(self->data->sparse.col_to_var, var_idx);
+                }
+
+                assert(sparse || (size_t)cnt == var_idx);
+                obj[cnt] = cost(instance, i, j);
+                lb[cnt] = 0.0;
+                ub[cnt] = 1.0;
+                xctype[cnt] = 'B';
+                if (colnames) {
+                    snprintf_safe(colnames[cnt], MIP_NAME_MAX_LEN, "x(%d,%d)",
+                                  i, j);
                 }
+                cnt++;
+            }
+        }
+        assert((size_t)cnt == num_x_cols);
+
+        if (!add_mip_columns(self, cnt, obj, lb, ub, sparse ? NULL : xctype,
+                             colnames)) {
+            result = false;
+            goto terminate;
+        }
+        self->data->sparse.num_cols = cnt;
+    }
+
+    assert(sparse || num_x_vars == (size_t)CPXXgetnumcols(self->data->env,
+                                                          self->data->lp));
+
+    // Create the Y MIP variable
+    {
+        for (int32_t i = 0; i < n; i++) {
+            if (sparse) {
+                size_t var_idx = get_y_mip_var_idx(instance, i);
+                CPXDIM col = self->data->sparse.num_cols + i;
+                self->data->sparse.var_to_col[var_idx] = col;
+                arrput(self->data->sparse.col_to_var, var_idx);
+            }
+            obj[i] = -1.0 * profit(instance, i);
+            lb[i] = 0.0;
+            ub[i] = 1.0;
+            xctype[i] = 'B';
+            if (colnames) {
+                snprintf_safe(colnames[i], MIP_NAME_MAX_LEN, "y(%d)", i);
+            }
+        }
+
+        if (!add_mip_columns(self, n, obj, lb, ub, sparse ? NULL : xctype,
+                             colnames)) {
+            result = false;
+            goto terminate;
+        }
+        self->data->sparse.num_cols += n;
+    }
+
+    //
+    // Now create the constraints (eg add the rows)
+    //
+
+    validate_mip_vars_packing(instance);
+
+    if (!add_degree_constraints(self, instance)) {
+        log_fatal("%s :: add_degree_constraints failed", __func__);
+        result = false;
+        goto terminate;
+    }
+
+    if (!add_depot_is_part_of_tour_constraint(self, instance)) {
+        log_fatal("%s :: add_depot_is_part_of_tour_constraint failed",
+                  __func__);
+        result = false;
+        goto terminate;
+    }
+    if (!add_capacity_ub(self, instance)) {
+        log_fatal("%s :: add_capacity_ub constraint failed", __func__);
+        result = false;
+        goto terminate;
+    }
+
+    if (!add_capacity_lb(self, instance)) {
+        log_fatal("%s :: add_capacity_lb constraint failed", __func__);
+        result = false;
+        goto terminate;
+    }
+
+terminate:
+    free(obj);
+    free(lb);
+    free(ub);
+    free(xctype);
+    free(names_buf);
+    free(colnames);
+    return result;
+}
 
-                //
-                // NOTE(dparo):
-                //      Since the network formulation is symmetric,
-                //      it is guaranteed that maxflow(s, t) == maxflow(t, s).
-                //      BUT!!!!
-                //      It is important to note that while the maxflows are
-                //      identical, the induced bipartitions, may not. Thus
-                //      solving two maxflows  (s, t), (t, s) could produce two
-                //      totally different bipartitions which are not
-                //      complementary with one another
-                //      ======================================================
-                //      Example (a single path network):
-                //            0 [--0--] 1 [--10--] 2 [--10--] 3 [--0--] 4
-                //      where [--c--] denotes an edge with capacity c.
-                //
-                //      - Solving maxflow(0, 4) finds bipartition:
-                //            [{0}, {1, 2, 3, 4}]
-                //      - While solving maxflow(4, 0) finds bipartition:
-                //           [{4}, {0, 1, 2, 3}]
-                //
-                //      which are not complementary!!
-                //
-
-                flow_t max_flow_int = gomory_hu_tree_query(
-                    &tld->gh_tree, &tld->maxflow_result, s, t);
-
-                double max_flow = max_flow_int / (double)CAP_DOUBLE_TO_INT;
-
-                assert(tld->maxflow_result.colors[s] == BLACK);
-                assert(tld->maxflow_result.colors[t] == WHITE);
-
-                for (int32_t cut_id = 0; cut_id < (int32_t)NUM_CUTS; cut_id++) {
-                    if (is_fractional_cut_active(cut_id)) {
-                        CutSeparationFunctor *functor = &tld->functors[cut_id];
-                        const CutSeparationIface *iface =
-                            G_cuts[cut_id].descr->iface;
-                        if (iface->fractional_sep) {
-                            const int64_t begin_time = os_get_usecs();
-                            // NOTE: We need to reset the cplex_cb_ctx since
-                            // it might change during the execution. The
-                            // same threadid id, is not guaranteed to have
-                            // the same cplex_cb_ctx for the entire duration
-                            // of the thread
-                            functor->internal.cplex_cb_ctx = cplex_cb_ctx;
-                            bool separation_success = iface->fractional_sep(
-                                functor, obj_p, vstar, &tld->maxflow_result,
-                                max_flow);
-                            functor->internal.fractional_stats.accum_usecs +=
-                                os_get_usecs() - begin_time;
-
-                            if (!separation_success) {
-                                log_fatal("Separation of fractional cut `%s` "
-                                          "failed",
-                                          G_cuts[cut_id].descr->name);
-                                goto terminate;
-                            }
+/// Marks as fixed every column that cannot be part of a solution having cost
+/// strictly lower than `primal_bound`: a column at its lower bound in the root
+/// LP, having reduced cost `dj`, can be set to one only in solutions costing at
+/// least `root_bound + dj`. Newly fixed columns are appended to
+/// `rcfix.fixed_cols`. Returns the number of newly fixed columns.
+static CPXDIM mark_reduced_cost_fixable_cols(SolverData *data,
+                                             const Instance *instance,
+                                             double primal_bound) {
+    const double gap = primal_bound - data->rcfix.root_bound;
+    if (!isfinite(gap)) {
+        return 0;
+    }
+
+    // NOTE(dparo): The depot is always part of the tour, never fix y(0)
+    const CPXDIM depot_col =
+        mip_var_to_col(data, get_y_mip_var_idx(instance, 0));
+
+    CPXDIM cnt = 0;
+    for (CPXDIM c = 0; c < mip_num_cols(data); c++) {
+        if (c == depot_col || data->rcfix.is_fixed[c]) {
+            continue;
+        }
+        // NOTE(dparo):
+        //      The bounds of the fixed edges are owned by
+        //      set_edge_fixings(): undoing the reduced cost fixing must not
+        //      touch them.
+        size_t var =
+            data->sparse.enabled ? data->sparse.col_to_var[c] : (size_t)c;
+        if (data->edge_fixing.state &&
+            data->edge_fixing.state[var] != EDGE_FIXING_NONE) {
+            continue;
+        }
+        if (data->rcfix.dj[c] > gap + COST_TOLERANCE) {
+            data->rcfix.is_fixed[c] = 1;
+            data->rcfix.fixed_cols[data->rcfix.num_fixed++] = c;
+            ++cnt;
+        }
+    }
+
+    data->rcfix.primal_bound = primal_bound;
+    return cnt;
+}
+
+/// Releases the columns fixed by init_reduced_cost_fixing(). The reduced
+/// costs need to be recomputed whenever the objective changes.
+static bool undo_reduced_cost_fixing(Solver *self) {
+    SolverData *data = self->data;
+    const CPXDIM cnt = data->rcfix.num_presolve_fixed;
+    bool success = true;
+
+    if (cnt > 0) {
+        char *lu = malloc(cnt * sizeof(*lu));
+        double *bd = malloc(cnt * sizeof(*bd));
+        success = lu && bd;
+
+        for (CPXDIM k = 0; success && k < cnt; k++) {
+            lu[k] = 'U';
+            bd[k] = 1.0;
+        }
+
+        success = success && 0 == CPXXchgbds(data->env, data->lp, cnt,
+                                             data->rcfix.fixed_cols, lu, bd);
+        free(lu);
+        free(bd);
+    }
+
+    data->rcfix.num_fixed = 0;
+    data->rcfix.num_presolve_fixed = 0;
+    return success;
+}
+
+#define CAP_DOUBLE_TO_INT (1 << 24)
+
+/// Builds the separation network upon the `num_nodes` nodes listed in
+/// `nodes`. Node `a` of the network corresponds to node `nodes[a]` of the
+/// instance.
+static void init_flow_network(FlowNetwork *net, const Instance *instance,
+                              const double *vstar, const int32_t *nodes,
+                              int32_t num_nodes) {
+    assert(net->nnodes == num_nodes);
+
+    for (int32_t a = 0; a < num_nodes; a++) {
+        for (int32_t b = 0; b < num_nodes; b++) {
+            const int32_t i = nodes[a];
+            const int32_t j = nodes[b];
+            double cap =
+                i == j ? 0.0 : vstar[get_x_mip_var_idx(instance, i, j)];
+            assert(fgte(cap, 0.0, 1e-5));
+            // NOTE: Fix floating point rounding errors. In fact cap may be
+            // slightly negative...
+            cap = MAX(0.0, cap);
+            if (feq(cap, 0.0, 1e-6)) {
+                cap = 0.0;
+            }
+            assert(cap >= 0.0);
+            flow_t cap_int = (flow_t)(cap * CAP_DOUBLE_TO_INT);
+            flow_net_set_cap(net, a, b, cap_int);
+        }
+    }
+}
+
+static inline bool
+is_any_fractional_cut_enabled(const CallbackThreadLocalData *tld) {
+    for (int32_t cut_id = 0; cut_id < (int32_t)NUM_CUTS; cut_id++) {
+        if (is_fractional_cut_active(cut_id)) {
+            const CutSeparationIface *iface = G_cuts[cut_id].descr->iface;
+            if (iface->fractional_sep) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/// Retrieves the current relaxation point into `tld->vstar`, expressed in
+/// terms of the (complete) MIP variables.
+static bool get_relaxation_point(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
+                                 const SolverData *data,
+                                 CallbackThreadLocalData *tld, double *obj_p) {
+    if (!data->sparse.enabled) {
+        const CPXDIM last = (CPXDIM)data->num_mip_vars - 1;
+        return 0 == CPXXcallbackgetrelaxationpoint(cplex_cb_ctx, tld->vstar, 0,
+                                                   last, obj_p);
+    }
+
+    if (0 != CPXXcallbackgetrelaxationpoint(cplex_cb_ctx, tld->colbuf, 0,
+                                            data->sparse.num_cols - 1, obj_p)) {
+        return false;
+    }
+    mip_scatter_cols(data, tld->colbuf, tld->vstar);
+    return true;
+}
+
+/// Retrieves the current candidate point into `tld->vstar`, expressed in
+/// terms of the (complete) MIP variables.
+static bool get_candidate_point(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
+                                const SolverData *data,
+                                CallbackThreadLocalData *tld, double *obj_p) {
+    if (!data->sparse.enabled) {
+        const CPXDIM last = (CPXDIM)data->num_mip_vars - 1;
+        return 0 == CPXXcallbackgetcandidatepoint(cplex_cb_ctx, tld->vstar, 0,
+                                                  last, obj_p);
+    }
+
+    if (0 != CPXXcallbackgetcandidatepoint(cplex_cb_ctx, tld->colbuf, 0,
+                                           data->sparse.num_cols - 1, obj_p)) {
+        return false;
+    }
+    mip_scatter_cols(data, tld->colbuf, tld->vstar);
+    return true;
+}
+
+/// Drops from the thread local separation network the nodes whose y variable
+/// got fixed to zero since the last call. The network, the maxflow and the
+/// Gomory-Hu tree are recreated with the reduced number of nodes.
+static bool shrink_separation_network(CplexCallbackCtx *ctx,
+                                      CallbackThreadLocalData *tld) {
+    const SolverData *data = ctx->solver->data;
+    const Instance *instance = ctx->instance;
+    const int32_t n = instance->num_customers + 1;
+    const size_t y_offset = get_y_mip_var_idx_offset(instance);
+    const CPXDIM end = atomic_load(&ctx->rcfix.num_published);
+
+    bool changed = false;
+    for (CPXDIM k = tld->rcfix_num_seen; k < end; k++) {
+        CPXDIM col = data->rcfix.fixed_cols[k];
+        size_t var_idx =
+            data->sparse.enabled ? data->sparse.col_to_var[col] : (size_t)col;
+        if (var_idx >= y_offset) {
+            int32_t i = (int32_t)(var_idx - y_offset);
+            assert(i > 0 && i < n);
+            tld->is_fixed_node[i] = 1;
+            changed = true;
+        }
+    }
+    tld->rcfix_num_seen = end;
+
+    if (!changed) {
+        return true;
+    }
+
+    int32_t m = 0;
+    for (int32_t i = 0; i < n; i++) {
+        if (!tld->is_fixed_node[i]) {
+            tld->active_nodes[m++] = i;
+        }
+    }
+    assert(tld->active_nodes[0] == 0);
+    tld->num_active_nodes = m;
+
+    log_trace("%s :: separation network shrinked to %d nodes", __func__, m);
+
+    if (m < 2) {
+        // NOTE(dparo): Nothing left to separate. Keep the old structures
+        return true;
+    }
+
+    return resize_separation_network(tld, m);
+}
+
+/// Maps the bipartition found on the shrinked separation network back to the
+/// nodes of the instance. Dropped nodes are placed on the same side of the
+/// depot.
+static void expand_compact_maxflow_result(CallbackThreadLocalData *tld,
+                                          int32_t n) {
+    const MaxFlowResult *src = &tld->compact_result;
+    MaxFlowResult *dest = &tld->maxflow_result;
+
+    for (int32_t i = 0; i < n; i++) {
+        dest->colors[i] = src->colors[0];
+    }
+    for (int32_t a = 0; a < tld->num_active_nodes; a++) {
+        dest->colors[tld->active_nodes[a]] = src->colors[a];
+    }
+    dest->s = tld->active_nodes[src->s];
+    dest->t = tld->active_nodes[src->t];
+    dest->maxflow = src->maxflow;
+}
+
+/// Separates the fractional cuts violated by `tld->vstar`, using the
+/// Gomory-Hu tree of the separation network (restricted to the active nodes).
+/// `cplex_cb_ctx` is NULL when the separation is driven by our own cutting
+/// plane loop: the cuts are then only recorded in the cut pools.
+static bool separate_fractional_point(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
+                                      SolverData *data,
+                                      CallbackThreadLocalData *tld,
+                                      const Instance *instance, double obj_p) {
+    double *vstar = tld->vstar;
+    const int32_t n = instance->num_customers + 1;
+    const int32_t m = tld->num_active_nodes;
+
+    FlowNetwork *net = &tld->network;
+    const bool shrinked = m < n;
+    init_flow_network(net, instance, vstar, tld->active_nodes, m);
+
+    // NOTE(dparo):
+    //      The Gomory-Hu tree solves m - 1 max-flows over m^2 arcs, while
+    //      each separator scans the n^2 variables once per pair of nodes.
+    max_flow_all_pairs(net, &tld->maxflow, &tld->gh_tree);
+    int64_t work = (int64_t)m * m * m;
+
+    for (int32_t s = 0; s < m; s++) {
+        for (int32_t t = 0; t < m; t++) {
+            if (s == t) {
+                continue;
+            }
+
+            //
+            // NOTE(dparo):
+            //      Since the network formulation is symmetric,
+            //      it is guaranteed that maxflow(s, t) == maxflow(t, s).
+            //      BUT!!!!
+            //      It is important to note that while the maxflows are
+            //      identical, the induced bipartitions, may not. Thus
+            //      solving two maxflows  (s, t), (t, s) could produce two
+            //      totally different bipartitions which are not
+            //      complementary with one another
+            //      ======================================================
+            //      Example (a single path network):
+            //            0 [--0--] 1 [--10--] 2 [--10--] 3 [--0--] 4
+            //      where [--c--] denotes an edge with capacity c.
+            //
+            //      - Solving maxflow(0, 4) finds bipartition:
+            //            [{0}, {1, 2, 3, 4}]
+            //      - While solving maxflow(4, 0) finds bipartition:
+            //           [{4}, {0, 1, 2, 3}]
+            //
+            //      which are not complementary!!
+            //
+
+            flow_t max_flow_int = gomory_hu_tree_query(
+                &tld->gh_tree,
+                shrinked ? &tld->compact_result : &tld->maxflow_result, s,
+                t);
+
+            if (shrinked) {
+                expand_compact_maxflow_result(tld, n);
+            }
+
+            double max_flow = max_flow_int / (double)CAP_DOUBLE_TO_INT;
+
+            assert(tld->maxflow_result.colors[tld->active_nodes[s]] ==
+                   BLACK);
+            assert(tld->maxflow_result.colors[tld->active_nodes[t]] ==
+                   WHITE);
+
+            for (int32_t cut_id = 0; cut_id < (int32_t)NUM_CUTS; cut_id++) {
+                if (is_fractional_cut_active(cut_id)) {
+                    CutSeparationFunctor *functor = &tld->functors[cut_id];
+                    const CutSeparationIface *iface =
+                        G_cuts[cut_id].descr->iface;
+                    if (iface->fractional_sep) {
+                        const int64_t begin_time = os_get_usecs();
+                        // NOTE: We need to reset the cplex_cb_ctx since
+                        // it might change during the execution. The
+                        // same threadid id, is not guaranteed to have
+                        // the same cplex_cb_ctx for the entire duration
+                        // of the thread
+                        functor->internal.cplex_cb_ctx = cplex_cb_ctx;
+                        bool separation_success = iface->fractional_sep(
+                            functor, obj_p, vstar, &tld->maxflow_result,
+                            max_flow);
+                        functor->internal.fractional_stats.accum_usecs +=
+                            os_get_usecs() - begin_time;
+                        work += (int64_t)n * n;
+
+                        if (!separation_success) {
+                            log_fatal("Separation of fractional cut `%s` "
+                                      "failed",
+                                      G_cuts[cut_id].descr->name);
+                            return false;
                         }
                     }
                 }
@@ -780,6 +1690,217 @@ static int cplex_on_new_relaxation(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
         }
     }
 
+    mip_add_work(data, work);
+    return true;
+}
+
+/// Posts `tour`, having objective value `cost`, as an heuristic solution.
+/// Tours using an edge pruned by the sparse formulation are silently skipped.
+static bool post_heuristic_tour(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
+                                SolverData *data, const Instance *instance,
+                                CallbackThreadLocalData *tld, const Tour *tour,
+                                double cost) {
+    const int32_t n = instance->num_customers + 1;
+
+    // Pack the tour as a complete assignment of the CPLEX columns
+    const CPXDIM num_cols = mip_num_cols(data);
+    for (CPXDIM col = 0; col < num_cols; col++) {
+        tld->index[col] = col;
+        tld->value[col] = 0.0;
+    }
+    for (int32_t i = 0; i < n; i++) {
+        if (tour->comp[i] != 0) {
+            continue;
+        }
+        CPXDIM y_col = mip_var_to_col(data, get_y_mip_var_idx(instance, i));
+        CPXDIM x_col = mip_var_to_col(
+            data, get_x_mip_var_idx(instance, i, tour->succ[i]));
+        if (x_col < 0) {
+            // The edge was pruned by the sparse formulation
+            return true;
+        }
+        tld->value[y_col] = 1.0;
+        tld->value[x_col] = 1.0;
+    }
+
+    if (0 != CPXXcallbackpostheursoln(cplex_cb_ctx, num_cols, tld->index,
+                                      tld->value, cost,
+                                      CPXCALLBACKSOLUTION_CHECKFEAS)) {
+        log_fatal("%s :: Failed CPXXcallbackpostheursoln", __func__);
+        return false;
+    }
+
+    return true;
+}
+
+/// Customers having a Y value at least this large are part of the rounded tour
+static const double RELAX_HEUR_Y_THRESHOLD = 0.5;
+
+/// Rounds the relaxation point `tld->vstar` into a tour, improves it with
+/// local search, and posts it to CPLEX if it improves the incumbent.
+static bool relaxation_heuristic(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
+                                 SolverData *data, const Instance *instance,
+                                 CallbackThreadLocalData *tld) {
+    const int32_t n = instance->num_customers + 1;
+    CPXLONG nodecount = 0;
+    if (0 != CPXXcallbackgetinfolong(cplex_cb_ctx, CPXCALLBACKINFO_NODECOUNT,
+                                     &nodecount)) {
+        return false;
+    }
+
+    // NOTE(dparo):
+    //      At the root node the LP point improves at every cut round, and it
+    //      is worth rounding each of them. Past the root, run at most once per
+    //      selected node.
+    if (nodecount > 0 && (nodecount % data->relax_heur_freq != 0 ||
+                          nodecount == tld->heur_last_node)) {
+        return true;
+    }
+    tld->heur_last_node = nodecount;
+
+    Tour *tour = &tld->heur_tour;
+    const double *y = &tld->vstar[get_y_mip_var_idx_offset(instance)];
+    ls_build_tour_from_scores(instance, tour, y, RELAX_HEUR_Y_THRESHOLD);
+    ls_optimize(instance, tour, MIP_MIN_NUM_VISITED);
+
+    int32_t num_visited = 0;
+    for (int32_t i = 0; i < n; i++) {
+        num_visited += tour->comp[i] == 0;
+    }
+    if (num_visited < MIP_MIN_NUM_VISITED) {
+        return true;
+    }
+
+    if (!mip_tour_respects_edge_fixings(data, instance, tour)) {
+        return true;
+    }
+
+    const double cost = tour_eval(instance, tour);
+    double incumbent = INFINITY;
+    CPXXcallbackgetinfodbl(cplex_cb_ctx, CPXCALLBACKINFO_BEST_SOL, &incumbent);
+
+    mip_pricer_collect_tour(data, tour, cost);
+    if (!(cost < incumbent - COST_TOLERANCE)) {
+        return true;
+    }
+
+    if (!post_heuristic_tour(cplex_cb_ctx, data, instance, tld, tour, cost)) {
+        return false;
+    }
+
+    atomic_fetch_add(&data->relax_heur_num_posted, 1);
+    log_trace("%s :: node %lld, posted a tour of cost %f (incumbent %f)",
+              __func__, (long long)nodecount, cost, incumbent);
+    return true;
+}
+
+/// Posts the best incumbent published by the other members of the portfolio,
+/// if it was not imported yet and it improves the incumbent of this solver.
+static bool import_shared_incumbent(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
+                                    SolverData *data, const Instance *instance,
+                                    CallbackThreadLocalData *tld) {
+    MipSharedIncumbent *shared = data->portfolio.shared;
+    int64_t version = atomic_load(&shared->version);
+    int64_t seen = atomic_load(&data->portfolio.seen_version);
+
+    // NOTE(dparo): A single thread imports each version
+    if (version <= seen || !atomic_compare_exchange_strong(
+                               &data->portfolio.seen_version, &seen, version)) {
+        return true;
+    }
+
+    Tour *tour = &tld->heur_tour;
+    const int32_t n = instance->num_customers + 1;
+    mip_spin_lock(&shared->lock);
+    const bool foreign = shared->owner != data->portfolio.member_id;
+    const double cost = shared->cost;
+    if (foreign) {
+        memcpy(tour->succ, shared->tour.succ, n * sizeof(*tour->succ));
+        memcpy(tour->comp, shared->tour.comp, n * sizeof(*tour->comp));
+        tour->num_comps = shared->tour.num_comps;
+    }
+    mip_spin_unlock(&shared->lock);
+
+    double incumbent = INFINITY;
+    CPXXcallbackgetinfodbl(cplex_cb_ctx, CPXCALLBACKINFO_BEST_SOL, &incumbent);
+    if (!foreign || !(cost < incumbent - COST_TOLERANCE)) {
+        return true;
+    }
+
+    log_trace("%s :: importing a tour of cost %f (incumbent %f)", __func__,
+              cost, incumbent);
+    return post_heuristic_tour(cplex_cb_ctx, data, instance, tld, tour, cost);
+}
+
+static int cplex_on_new_relaxation(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
+                                   CplexCallbackCtx *ctx, int32_t threadid,
+                                   int32_t numthreads) {
+    // NOTE:
+    //      Called when cplex has a new feasible LP solution (not necessarily
+    //      satisfying the integrality constraints)
+
+    assert(threadid < numthreads);
+    assert(threadid < ctx->num_threads);
+
+    Solver *solver = ctx->solver;
+    const Instance *instance = ctx->instance;
+    CallbackThreadLocalData *tld = ctx->thread_local_data[threadid];
+    double *vstar = tld->vstar;
+
+    if (solver->data->rcfix.enabled) {
+        if (!shrink_separation_network(ctx, tld)) {
+            log_fatal("%s :: Failed to shrink the separation network",
+                      __func__);
+            goto terminate;
+        }
+    }
+
+    if (solver->data->portfolio.shared &&
+        !import_shared_incumbent(cplex_cb_ctx, solver->data, instance, tld)) {
+        log_fatal("%s :: Failed to import the shared incumbent", __func__);
+        goto terminate;
+    }
+
+    if (!solver->data->fractional_separation_enabled &&
+        solver->data->relax_heur_freq <= 0) {
+        return 0;
+    }
+
+    if (!vstar) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        goto terminate;
+    }
+
+    double obj_p = INFINITY;
+    if (!get_relaxation_point(cplex_cb_ctx, solver->data, tld, &obj_p)) {
+        log_fatal("%s :: Failed `CPXXcallbackgetrelaxationpoint`", __func__);
+        goto terminate;
+    }
+
+    const bool any_fractional = is_any_fractional_cut_enabled(tld);
+    bool do_fractional_sep = true;
+    if (solver->data->amortized_fractional_labeling) {
+        do_fractional_sep =
+            (tld->fractional_sep_it % (instance->num_customers + 1) == 0);
+    } else {
+        do_fractional_sep = true;
+    }
+
+    if (solver->data->fractional_separation_enabled && any_fractional &&
+        do_fractional_sep && tld->num_active_nodes >= 2) {
+        if (!separate_fractional_point(cplex_cb_ctx, solver->data, tld,
+                                       instance, obj_p)) {
+            goto terminate;
+        }
+    }
+
+    if (solver->data->relax_heur_freq > 0) {
+        if (!relaxation_heuristic(cplex_cb_ctx, solver->data, instance, tld)) {
+            log_fatal("%s :: Relaxation heuristic failed", __func__);
+            goto terminate;
+        }
+    }
+
     ++tld->fractional_sep_it;
 
     return 0;
@@ -788,66 +1909,312 @@ terminate:
     return 1;
 }
 
-static int cplex_on_branching(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
-                              CplexCallbackCtx *ctx, int32_t threadid,
-                              int32_t numthreads) {
+/// Cardinality branching kicks in only when the number of visited customers is
+/// at least this far from an integer
+static const double CARDINALITY_BRANCHING_MIN_FRAC = 0.1;
+/// Y variables closer than this to an integer are not branching candidates
+static const double BRANCHING_FRAC_EPS = 1e-6;
+/// Lower bound on the scores of the branches, such that the product score
+/// still discriminates candidates having a null pseudo-cost on one side
+static const double PSEUDOCOST_SCORE_EPS = 1e-6;
+
+/// Pending branches are evicted, oldest first, when they outnumber the open
+/// nodes by this factor (plus PENDING_BRANCHES_SLACK)
+#define PENDING_BRANCHES_MAX_FACTOR 2
+#define PENDING_BRANCHES_SLACK 256
+
+/// Updates the pseudo-costs with the objective change observed at the node
+/// being branched, if it was created by a pseudo-cost branching. The pending
+/// branch of the node is dropped.
+static void update_pseudocosts(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
+                               SolverData *data, double obj_p) {
+    CPXLONG nodeuid = -1;
+    if (0 != CPXXcallbackgetinfolong(cplex_cb_ctx, CPXCALLBACKINFO_NODEUID,
+                                     &nodeuid)) {
+        return;
+    }
 
-    assert(threadid < numthreads);
-    assert(threadid <= MAX_NUM_CORES);
+    mip_spin_lock(&data->branching.lock);
+    PendingBranchEntry *entry = hmgetp_null(data->branching.pending, nodeuid);
+    if (entry) {
+        PendingBranch b = entry->value;
+        double gain = MAX(0.0, obj_p - b.parent_obj);
+        data->branching.pc_sum[b.dir][b.node] += gain / b.delta;
+        data->branching.pc_cnt[b.dir][b.node] += 1;
+        hmdel(data->branching.pending, nodeuid);
+    }
+    mip_spin_unlock(&data->branching.lock);
+}
 
-    Solver *solver = ctx->solver;
-    ATTRIB_MAYBE_UNUSED const Instance *instance = ctx->instance;
-    CallbackThreadLocalData *tld = &ctx->thread_local_data[threadid];
-    double *vstar = tld->vstar;
-    double obj_p;
+/// Drops the pending branch of the node being processed, if any, without
+/// observing its objective change. Used for the nodes that are not branched
+/// on (eg the ones whose relaxation point is an accepted candidate).
+static void drop_pending_branch(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
+                                SolverData *data) {
+    CPXLONG nodeuid = -1;
+    if (hmlenu(data->branching.pending) == 0 ||
+        0 != CPXXcallbackgetinfolong(cplex_cb_ctx, CPXCALLBACKINFO_NODEUID,
+                                     &nodeuid)) {
+        return;
+    }
 
-    if (0 != CPXXcallbackgetrelaxationpoint(cplex_cb_ctx, vstar, 0,
-                                            solver->data->num_mip_vars - 1,
-                                            &obj_p)) {
-        log_fatal("%s :: CPXXcallbackgetrelaxationpoint() failed", __func__);
-        goto terminate;
+    mip_spin_lock(&data->branching.lock);
+    hmdel(data->branching.pending, nodeuid);
+    mip_spin_unlock(&data->branching.lock);
+}
+
+static int cmp_node_uids(const void *a, const void *b) {
+    CPXLONG ua = *(const CPXLONG *)a;
+    CPXLONG ub = *(const CPXLONG *)b;
+    return (ua > ub) - (ua < ub);
+}
+
+/// Drops the pending branches whose node is pruned without being processed.
+/// NOTE(dparo):
+///      CPLEX does not call back for the nodes pruned by bound, nor for the
+///      ones found infeasible. The former are recognized from the parent
+///      objective, which bounds the objective of the node, whenever the
+///      incumbent improves. The latter cannot be recognized: when the pending
+///      branches outnumber the open nodes, the oldest ones are evicted. An
+///      evicted node which is still open only misses its observation.
+static void prune_pending_branches(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
+                                   SolverData *data) {
+    double incumbent = INFINITY;
+    CPXLONG nodes_left = -1;
+    CPXXcallbackgetinfodbl(cplex_cb_ctx, CPXCALLBACKINFO_BEST_SOL, &incumbent);
+    if (0 != CPXXcallbackgetinfolong(cplex_cb_ctx, CPXCALLBACKINFO_NODESLEFT,
+                                     &nodes_left)) {
+        nodes_left = -1;
+    }
+
+    mip_spin_lock(&data->branching.lock);
+    PendingBranchEntry *pending = data->branching.pending;
+
+    if (incumbent < data->branching.pruned_bound - COST_TOLERANCE) {
+        data->branching.pruned_bound = incumbent;
+        for (ptrdiff_t k = (ptrdiff_t)hmlenu(pending) - 1; k >= 0; k--) {
+            if (pending[k].value.parent_obj >= incumbent - COST_TOLERANCE) {
+                CPXLONG key = pending[k].key;
+                hmdel(pending, key);
+            }
+        }
     }
 
+    const size_t len = hmlenu(pending);
+    const size_t max_len =
+        PENDING_BRANCHES_MAX_FACTOR * (size_t)nodes_left +
+        PENDING_BRANCHES_SLACK;
+    CPXLONG *uids = nodes_left >= 0 && len > max_len
+                        ? malloc(len * sizeof(*uids))
+                        : NULL;
+    if (uids) {
+        for (size_t k = 0; k < len; k++) {
+            uids[k] = pending[k].key;
+        }
+        // NOTE(dparo): Node unique ids grow with the creation order
+        qsort(uids, len, sizeof(*uids), cmp_node_uids);
+        const size_t num_evicted = len - MIN(len, (size_t)nodes_left);
+        for (size_t k = 0; k < num_evicted; k++) {
+            hmdel(pending, uids[k]);
+        }
+        log_trace("%s :: evicted %zu pending branches", __func__,
+                  num_evicted);
+        free(uids);
+    }
+
+    data->branching.pending = pending;
+    mip_spin_unlock(&data->branching.lock);
+}
+
+/// Per unit objective change of branching on customer `i` in direction `dir`.
+/// Uninitialized pseudo-costs take the average over the initialized ones.
+static double get_pseudocost(const SolverData *data, int32_t dir, int32_t i,
+                             double avg) {
+    int64_t cnt = data->branching.pc_cnt[dir][i];
+    return cnt > 0 ? data->branching.pc_sum[dir][i] / (double)cnt : avg;
+}
+
+static double get_average_pseudocost(const SolverData *data,
+                                     const Instance *instance, int32_t dir) {
+    double sum = 0.0;
+    int64_t cnt = 0;
+    for (int32_t i = 1; i < instance->num_customers + 1; i++) {
+        if (data->branching.pc_cnt[dir][i] > 0) {
+            sum += data->branching.pc_sum[dir][i] /
+                   (double)data->branching.pc_cnt[dir][i];
+            ++cnt;
+        }
+    }
+    return cnt > 0 ? sum / (double)cnt : 1.0;
+}
+
+/// Branches on sum(y) <= floor or sum(y) >= ceil, where sum(y) is the
+/// (fractional) number of visited customers.
+/// Returns true if the branches were created.
+static bool branch_on_cardinality(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
+                                  SolverData *data, const Instance *instance,
+                                  CallbackThreadLocalData *tld, double obj_p,
+                                  bool *failure) {
+    double *vstar = tld->vstar;
     double accum = 0.0;
     for (int32_t i = 0; i < instance->num_customers + 1; i++) {
         double y_i = vstar[get_y_mip_var_idx(instance, i)];
         accum += y_i;
     }
 
-    double intval = round(accum);
-    double frac = fabs(intval - accum);
+    double frac = fabs(round(accum) - accum);
+    if (frac <= CARDINALITY_BRANCHING_MIN_FRAC) {
+        return false;
+    }
+
+    double const up = ceil(accum);
+    double const down = floor(accum);
+    CPXNNZ rmatbeg[] = {0};
+    CPXDIM nnz = instance->num_customers + 1;
 
-    // printf("Branching :: intval = %f, frac = %f\n", intval, frac);
+    for (int32_t i = 0; i < instance->num_customers + 1; i++) {
+        tld->index[i] = mip_var_to_col(data, get_y_mip_var_idx(instance, i));
+        tld->value[i] = 1.0;
+    }
 
-    if (false && frac > 0.1) {
-        double const up = ceil(frac);
-        double const down = floor(frac);
-        CPXNNZ rmatbeg[] = {0};
-        CPXDIM nnz = instance->num_customers + 1;
+    /* Create the UP branch. */
+    if (0 != CPXXcallbackmakebranch(cplex_cb_ctx, 0, NULL, NULL, NULL, 1, nnz,
+                                    &up, "G", rmatbeg, tld->index, tld->value,
+                                    obj_p, NULL)) {
+        log_fatal("Failed to create up branch\n");
+        *failure = true;
+        return false;
+    }
 
-        for (int32_t i = 0; i < instance->num_customers + 1; i++) {
-            tld->index[i] = (CPXDIM)get_y_mip_var_idx(instance, i);
-            tld->value[i] = 1.0;
-        }
+    /* Create the DOWN branch. */
+    if (0 != CPXXcallbackmakebranch(cplex_cb_ctx, 0, NULL, NULL, NULL, 1, nnz,
+                                    &down, "L", rmatbeg, tld->index,
+                                    tld->value, obj_p, NULL)) {
+        log_fatal("Failed to create down branch\n");
+        *failure = true;
+        return false;
+    }
 
-        /* Create the UP branch. */
-        if (0 != CPXXcallbackmakebranch(cplex_cb_ctx, 0, NULL, NULL, NULL, 1,
-                                        nnz, &up, "G", rmatbeg, tld->index,
-                                        tld->value, obj_p, NULL)) {
-            log_fatal("Failed to create up branch\n");
-            goto terminate;
+    atomic_fetch_add(&data->branching.num_cardinality_branches, 1);
+    log_trace("%s :: sum(y) = %f, branched on <= %f, >= %f", __func__, accum,
+              down, up);
+    return true;
+}
+
+/// Branches on the fractional Y variable maximizing the product of the
+/// estimated objective changes of its two branches.
+/// Returns true if the branches were created.
+static bool branch_on_pseudocost(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
+                                 SolverData *data, const Instance *instance,
+                                 CallbackThreadLocalData *tld, double obj_p,
+                                 bool *failure) {
+    double *vstar = tld->vstar;
+    int32_t best_i = -1;
+    double best_score = -INFINITY;
+
+    mip_spin_lock(&data->branching.lock);
+    double avg[2] = {get_average_pseudocost(data, instance, 0),
+                     get_average_pseudocost(data, instance, 1)};
+
+    // NOTE(dparo): Start from 1, the depot is always visited
+    for (int32_t i = 1; i < instance->num_customers + 1; i++) {
+        double f = vstar[get_y_mip_var_idx(instance, i)];
+        if (f <= BRANCHING_FRAC_EPS || f >= 1.0 - BRANCHING_FRAC_EPS) {
+            continue;
         }
+        double down = get_pseudocost(data, 0, i, avg[0]) * f;
+        double up = get_pseudocost(data, 1, i, avg[1]) * (1.0 - f);
+        double score =
+            MAX(down, PSEUDOCOST_SCORE_EPS) * MAX(up, PSEUDOCOST_SCORE_EPS);
+        if (score > best_score) {
+            best_score = score;
+            best_i = i;
+        }
+    }
+    mip_spin_unlock(&data->branching.lock);
 
-        /* Create the DOWN branch. */
-        if (0 != CPXXcallbackmakebranch(cplex_cb_ctx, 0, NULL, NULL, NULL, 1,
-                                        nnz, &down, "L", rmatbeg, tld->index,
-                                        tld->value, obj_p, NULL)) {
-            log_fatal("Failed to create up branch\n");
-            goto terminate;
+    if (best_i < 0) {
+        return false;
+    }
+
+    double f = vstar[get_y_mip_var_idx(instance, best_i)];
+    CPXDIM col = mip_var_to_col(data, get_y_mip_var_idx(instance, best_i));
+    const char lu[2] = {'U', 'L'};
+    const double bd[2] = {0.0, 1.0};
+    const double delta[2] = {f, 1.0 - f};
+    CPXLONG seqnum[2] = {-1, -1};
+
+    for (int32_t dir = 0; dir < 2; dir++) {
+        if (0 != CPXXcallbackmakebranch(cplex_cb_ctx, 1, &col, &lu[dir],
+                                        &bd[dir], 0, 0, NULL, NULL, NULL, NULL,
+                                        NULL, obj_p, &seqnum[dir])) {
+            log_fatal("Failed to create %s branch\n", dir ? "up" : "down");
+            *failure = true;
+            return false;
         }
     }
 
-    log_trace("%s :: obj_p = %f", __func__, obj_p);
+    mip_spin_lock(&data->branching.lock);
+    for (int32_t dir = 0; dir < 2; dir++) {
+        PendingBranch b = {best_i, dir, obj_p, delta[dir]};
+        hmput(data->branching.pending, seqnum[dir], b);
+    }
+    mip_spin_unlock(&data->branching.lock);
+
+    atomic_fetch_add(&data->branching.num_pseudocost_branches, 1);
+    log_trace("%s :: branched on y(%d) = %f", __func__, best_i, f);
+    return true;
+}
+
+static int cplex_on_branching(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
+                              CplexCallbackCtx *ctx, int32_t threadid,
+                              int32_t numthreads) {
+
+    assert(threadid < numthreads);
+    assert(threadid < ctx->num_threads);
+
+    Solver *solver = ctx->solver;
+    SolverData *data = solver->data;
+    const Instance *instance = ctx->instance;
+    CallbackThreadLocalData *tld = ctx->thread_local_data[threadid];
+    const BranchingStrategy strategy = data->branching.strategy;
+    double obj_p;
+    bool failure = false;
+
+    if (!get_relaxation_point(cplex_cb_ctx, data, tld, &obj_p)) {
+        log_fatal("%s :: CPXXcallbackgetrelaxationpoint() failed", __func__);
+        goto terminate;
+    }
+
+    const bool use_pseudocost =
+        strategy == BRANCHING_STRATEGY_PSEUDOCOST ||
+        strategy == BRANCHING_STRATEGY_CARDINALITY_PSEUDOCOST;
+    const bool use_cardinality =
+        strategy == BRANCHING_STRATEGY_CARDINALITY ||
+        strategy == BRANCHING_STRATEGY_CARDINALITY_PSEUDOCOST;
+
+    if (use_pseudocost) {
+        update_pseudocosts(cplex_cb_ctx, data, obj_p);
+        prune_pending_branches(cplex_cb_ctx, data);
+    }
+
+    bool branched = false;
+    if (use_cardinality) {
+        branched = branch_on_cardinality(cplex_cb_ctx, data, instance, tld,
+                                         obj_p, &failure);
+    }
+    if (!branched && !failure && use_pseudocost) {
+        branched = branch_on_pseudocost(cplex_cb_ctx, data, instance, tld,
+                                        obj_p, &failure);
+    }
+    if (failure) {
+        goto terminate;
+    }
+
+    // NOTE(dparo):
+    //      When the Y variables are all integral the branching decision is
+    //      left to CPLEX, which branches on the X variables.
+    log_trace("%s :: obj_p = %f, branched = %d", __func__, obj_p, branched);
 
     return 0;
 terminate:
@@ -863,11 +2230,11 @@ static int cplex_on_new_candidate_point(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
     //      satisfying all constraints
 
     assert(threadid < numthreads);
-    assert(threadid <= MAX_NUM_CORES);
+    assert(threadid < ctx->num_threads);
 
     Solver *solver = ctx->solver;
     const Instance *instance = ctx->instance;
-    CallbackThreadLocalData *tld = &ctx->thread_local_data[threadid];
+    CallbackThreadLocalData *tld = ctx->thread_local_data[threadid];
     double *vstar = tld->vstar;
     Tour *tour = &tld->tour;
 
@@ -881,9 +2248,7 @@ static int cplex_on_new_candidate_point(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
     }
 
     double obj_p;
-    if (0 != CPXXcallbackgetcandidatepoint(cplex_cb_ctx, vstar, 0,
-                                           solver->data->num_mip_vars - 1,
-                                           &obj_p)) {
+    if (!get_candidate_point(cplex_cb_ctx, solver->data, tld, &obj_p)) {
         log_fatal("%s :: Failed `CPXcallbackgetcandidatepoint`", __func__);
         goto terminate;
     }
@@ -911,6 +2276,10 @@ static int cplex_on_new_candidate_point(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
                         iface->integral_sep(functor, obj_p, vstar, tour);
                     functor->internal.integral_stats.accum_usecs +=
                         os_get_usecs() - begin_time;
+                    mip_add_work(solver->data,
+                                 (int64_t)tour->num_comps *
+                                     (instance->num_customers + 1) *
+                                     (instance->num_customers + 1));
 
                     if (!separation_success) {
                         log_fatal("Separation of integral cut `%s` "
@@ -926,6 +2295,15 @@ static int cplex_on_new_candidate_point(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
         log_trace("%s :: num_comps of unpacked tour is %d -- accepting "
                   "candidate point...",
                   __func__, tour->num_comps);
+
+        // The node is not going to be branched on
+        drop_pending_branch(cplex_cb_ctx, solver->data);
+
+        mip_pricer_collect_tour(solver->data, tour, obj_p);
+        if (solver->data->heur_pricer_mode &&
+            mip_pricer_is_done(solver->data, INFINITY)) {
+            CPXXcallbackabort(cplex_cb_ctx);
+        }
     }
 
     return 0;
@@ -977,20 +2355,116 @@ static int cplex_on_progress(char *progress_kind, CPXCALLBACKCONTEXTptr context,
               progress_kind, num_restarts, num_processed_nodes, num_nodes_left,
               simplex_iterations, dual_bound, primal_bound);
 
-    if (solver->data->heur_pricer_mode && is_valid_reduced_cost(primal_bound)) {
-        CPXXcallbackabort(context);
+    if (solver->data->heur_pricer_mode &&
+        mip_pricer_is_done(solver->data, primal_bound)) {
+        CPXXcallbackabort(context);
+    }
+
+    return 0;
+}
+
+/// Marks the columns that cannot improve over the new incumbent, and publishes
+/// them to the other threads, which drop the corresponding nodes from their
+/// separation networks (see shrink_separation_network()).
+/// NOTE(dparo):
+///      The LP is left untouched: CPLEX does not allow to change the bounds
+///      while CPXXmipopt is running, and it already applies its own reduced
+///      cost fixing at the nodes. The cuts separated on the shrinked network
+///      remain valid, since the dropped nodes still take part in them.
+static void reduced_cost_fixing(CPXCALLBACKCONTEXTptr context,
+                                CplexCallbackCtx *ctx) {
+    SolverData *data = ctx->solver->data;
+    double incumbent = INFINITY;
+
+    if (0 != CPXXcallbackgetinfodbl(context, CPXCALLBACKINFO_BEST_SOL,
+                                    &incumbent) ||
+        incumbent >= CPX_INFBOUND) {
+        return;
+    }
+
+    const double primal_bound = interesting_primal_bound(data, incumbent);
+    if (primal_bound >= data->rcfix.primal_bound - COST_TOLERANCE) {
+        return;
+    }
+
+    CPXDIM cnt = mark_reduced_cost_fixable_cols(data, ctx->instance,
+                                                primal_bound);
+    if (cnt > 0) {
+        atomic_store(&ctx->rcfix.num_published, data->rcfix.num_fixed);
+        log_info("%s :: primal bound improved to %f -- fixed %d more columns "
+                 "(%d in total)",
+                 __func__, primal_bound, cnt, data->rcfix.num_fixed);
+    }
+}
+
+/// Publishes the incumbent of this solver to the other members of the
+/// portfolio, when it improves the shared one.
+static void publish_incumbent(CPXCALLBACKCONTEXTptr context,
+                              CplexCallbackCtx *ctx) {
+    SolverData *data = ctx->solver->data;
+    MipSharedIncumbent *shared = data->portfolio.shared;
+    double primal_bound = INFINITY;
+
+    if (0 != CPXXcallbackgetinfodbl(context, CPXCALLBACKINFO_BEST_SOL,
+                                    &primal_bound) ||
+        primal_bound >= CPX_INFBOUND) {
+        return;
+    }
+
+    mip_spin_lock(&shared->lock);
+    double shared_cost = shared->cost;
+    mip_spin_unlock(&shared->lock);
+    if (primal_bound >= shared_cost - COST_TOLERANCE) {
+        return;
+    }
+
+    double cost = INFINITY;
+    const CPXDIM num_cols = mip_num_cols(data);
+    if (0 != CPXXcallbackgetincumbent(context, data->portfolio.cols, 0,
+                                      num_cols - 1, &cost)) {
+        log_warn("%s :: Failed CPXXcallbackgetincumbent", __func__);
+        return;
+    }
+
+    double *vstar = data->portfolio.cols;
+    if (data->sparse.enabled) {
+        mip_scatter_cols(data, data->portfolio.cols, data->portfolio.vstar);
+        vstar = data->portfolio.vstar;
     }
 
-    return 0;
+    Tour *tour = &data->portfolio.tour;
+    unpack_mip_solution(ctx->instance, tour, vstar);
+    if (tour->num_comps != 1) {
+        return;
+    }
+
+    const int32_t n = ctx->instance->num_customers + 1;
+    mip_spin_lock(&shared->lock);
+    if (cost < shared->cost - COST_TOLERANCE) {
+        memcpy(shared->tour.succ, tour->succ, n * sizeof(*tour->succ));
+        memcpy(shared->tour.comp, tour->comp, n * sizeof(*tour->comp));
+        shared->tour.num_comps = tour->num_comps;
+        shared->cost = cost;
+        shared->owner = data->portfolio.member_id;
+        atomic_fetch_add(&shared->version, 1);
+    }
+    mip_spin_unlock(&shared->lock);
 }
 
 static int cplex_on_global_progress(CPXCALLBACKCONTEXTptr context,
-                                    Solver *solver, const Instance *instance) {
+                                    CplexCallbackCtx *ctx) {
     // NOTE:
     // CPLEX invokes the generic callback in this context when it has made
     // global progress, that is, when new information has been committed to the
     // global solution structures.
-    return cplex_on_progress("Global progress", context, solver, instance);
+    if (ctx->solver->data->rcfix.enabled) {
+        reduced_cost_fixing(context, ctx);
+    }
+    if (ctx->solver->data->portfolio.shared) {
+        publish_incumbent(context, ctx);
+    }
+    return cplex_on_progress("Global progress", context, ctx->solver,
+                             ctx->instance);
 }
 
 static int cplex_on_local_progress(CPXCALLBACKCONTEXTptr context,
@@ -1012,18 +2486,38 @@ static int cplex_on_thread_activation(int activation,
                                       CplexCallbackCtx *ctx, CPXLONG threadid,
                                       CPXLONG numthreads) {
     assert(activation == -1 || activation == 1);
-    assert(numthreads <= MAX_NUM_CORES);
+    assert(numthreads <= ctx->num_threads);
 
     CallbackThreadLocalData *thread_local_data =
-        &ctx->thread_local_data[threadid];
+        ctx->thread_local_data[threadid];
 
     if (activation > 0) {
         log_trace("cplex_callback activated a thread :: threadid = "
                   "%lld, numthreads = %lld",
                   threadid, numthreads);
 
-        if (!create_callback_thread_local_data(thread_local_data, cplex_cb_ctx,
-                                               ctx->instance, ctx->solver)) {
+        if (!thread_local_data) {
+            // NOTE(dparo): First touch from the owning thread
+            thread_local_data = calloc(1, sizeof(*thread_local_data));
+            if (!thread_local_data) {
+                log_fatal("%s :: Failed memory allocation", __func__);
+                return 1;
+            }
+            ctx->thread_local_data[threadid] = thread_local_data;
+        }
+
+        if (thread_local_data->valid) {
+            // NOTE(dparo): Left alive by a previous solve of a persistent
+            //              solver
+            if (!reset_callback_thread_local_data(
+                    thread_local_data, ctx->instance, ctx->solver->data)) {
+                log_fatal("%s :: Failed reset_callback_thread_local_data()",
+                          __func__);
+                return 1;
+            }
+        } else if (!create_callback_thread_local_data(
+                       thread_local_data, cplex_cb_ctx, ctx->instance,
+                       ctx->solver)) {
             destroy_callback_thread_local_data(thread_local_data);
             log_fatal("%s :: Failed create_callback_thread_local_data()",
                       __func__);
@@ -1033,7 +2527,9 @@ static int cplex_on_thread_activation(int activation,
         log_trace("cplex_callback deactivated an old thread :: threadid = "
                   "%lld, numthreads = %lld\n",
                   threadid, numthreads);
-        destroy_callback_thread_local_data(thread_local_data);
+        if (!ctx->solver->persistent) {
+            destroy_callback_thread_local_data(thread_local_data);
+        }
     } else {
         assert(!"Invalid code path");
     }
@@ -1051,9 +2547,9 @@ CPXPUBLIC static int cplex_callback(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
     CPXXcallbackgetinfoint(cplex_cb_ctx, CPXCALLBACKINFO_THREADID, &threadid);
     assert(threadid >= 0 && threadid < numthreads);
 
-    log_debug("%s :: numthreads = %d, numcores = %d", __func__, numthreads,
-              ctx->solver->data->numcores);
-    assert(numthreads <= ctx->solver->data->numcores);
+    log_debug("%s :: numthreads = %d, num_threads = %d", __func__,
+              numthreads, ctx->num_threads);
+    assert(numthreads <= ctx->num_threads);
 
     // NOTE:
     //      Look at
@@ -1092,8 +2588,7 @@ CPXPUBLIC static int cplex_callback(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
         // NOTE: Global progress is inherently thread safe
         //            See:
         //            https://www.ibm.com/docs/en/cofz/12.10.0?topic=callbacks-multithreading-generic
-        result =
-            cplex_on_global_progress(cplex_cb_ctx, ctx->solver, ctx->instance);
+        result = cplex_on_global_progress(cplex_cb_ctx, ctx);
         break;
     case CPX_CALLBACKCONTEXT_THREAD_UP:
     case CPX_CALLBACKCONTEXT_THREAD_DOWN: {
@@ -1128,15 +2623,109 @@ CPXPUBLIC static int cplex_callback(CPXCALLBACKCONTEXTptr cplex_cb_ctx,
     return result;
 }
 
+/// Moves the cuts separated by each thread into `SolverData::user_cuts`,
+/// where they remain available to the next solves. All the separated cuts
+/// depend only on the demands and on the vehicle capacity: they stay valid
+/// when the profits change.
+static void flush_cut_pools(Solver *self, CplexCallbackCtx *callback_ctx) {
+    for (int32_t i = 0; i < callback_ctx->num_threads; i++) {
+        CallbackThreadLocalData *tld = callback_ctx->thread_local_data[i];
+        if (!tld || !tld->valid || arrlen(tld->cut_pool.rhs) == 0) {
+            continue;
+        }
+
+        log_info("%s :: thread %d saved %td cuts", __func__, i,
+                 arrlen(tld->cut_pool.rhs));
+        cut_pool_append(&self->data->user_cuts, &tld->cut_pool);
+        cut_pool_clear(&tld->cut_pool);
+    }
+}
+
+/// Rewrites the cuts of `src` (expressed in terms of MIP variables) in terms
+/// of the current CPLEX columns, into `dest`. Pruned variables are dropped,
+/// and so are the cuts left without any column.
+static void cut_pool_to_cols(const SolverData *data, const CutPool *src,
+                             CutPool *dest) {
+    cut_pool_clear(dest);
+    for (ptrdiff_t r = 0; r < arrlen(src->rhs); r++) {
+        CPXNNZ beg = src->rmatbeg[r];
+        CPXNNZ end = r + 1 < arrlen(src->rhs) ? src->rmatbeg[r + 1]
+                                              : (CPXNNZ)arrlen(src->rmatind);
+        CPXNNZ row_beg = (CPXNNZ)arrlen(dest->rmatind);
+        for (CPXNNZ k = beg; k < end; k++) {
+            CPXDIM col = mip_var_to_col(data, (size_t)src->rmatind[k]);
+            if (col >= 0) {
+                arrput(dest->rmatind, col);
+                arrput(dest->rmatval, src->rmatval[k]);
+            }
+        }
+        if ((CPXNNZ)arrlen(dest->rmatind) > row_beg) {
+            arrput(dest->rmatbeg, row_beg);
+            arrput(dest->rhs, src->rhs[r]);
+            arrput(dest->sense, src->sense[r]);
+        }
+    }
+}
+
+/// Replaces the content of the CPLEX user cut pool with
+/// `SolverData::user_cuts`.
+/// NOTE(dparo):
+///      The columns of a sparse formulation change between the solves (see
+///      update_profits() and price_forced_edges()). A cut submitted before a
+///      column was added lacks its coefficient and may cut off feasible
+///      tours: the pool is always rebuilt from the MIP variables.
+static bool install_user_cuts(Solver *self) {
+    SolverData *data = self->data;
+    if (arrlen(data->user_cuts.rhs) == 0) {
+        return true;
+    }
+
+    bool result = true;
+    CutPool rows = {0};
+    cut_pool_to_cols(data, &data->user_cuts, &rows);
+
+    if (0 != CPXXdelusercuts(data->env, data->lp)) {
+        log_fatal("%s :: CPXXdelusercuts failed", __func__);
+        result = false;
+        goto terminate;
+    }
+
+    CPXDIM rcnt = (CPXDIM)arrlen(rows.rhs);
+    if (rcnt > 0 &&
+        0 != CPXXaddusercuts(data->env, data->lp, rcnt,
+                             (CPXNNZ)arrlen(rows.rmatind), rows.rhs,
+                             rows.sense, rows.rmatbeg, rows.rmatind,
+                             rows.rmatval, NULL)) {
+        log_fatal("%s :: CPXXaddusercuts failed", __func__);
+        result = false;
+        goto terminate;
+    }
+
+    log_info("%s :: installed %d cuts in the user cut pool", __func__, rcnt);
+
+terminate:
+    cut_pool_destroy(&rows);
+    return result;
+}
+
 static bool on_solve_start(Solver *self, const Instance *instance,
                            CplexCallbackCtx *callback_ctx) {
     UNUSED_PARAM(instance);
 
-    CPXLONG contextmask =
-        CPX_CALLBACKCONTEXT_BRANCHING | CPX_CALLBACKCONTEXT_CANDIDATE |
-        CPX_CALLBACKCONTEXT_THREAD_UP | CPX_CALLBACKCONTEXT_THREAD_DOWN;
+    CPXLONG contextmask = CPX_CALLBACKCONTEXT_CANDIDATE |
+                          CPX_CALLBACKCONTEXT_THREAD_UP |
+                          CPX_CALLBACKCONTEXT_THREAD_DOWN;
+
+    // NOTE(dparo):
+    //      The branching callback fetches the relaxation point at every node:
+    //      do not pay for it when CPLEX takes all the branching decisions.
+    if (self->data->branching.strategy != BRANCHING_STRATEGY_CPLEX) {
+        contextmask |= CPX_CALLBACKCONTEXT_BRANCHING;
+    }
 
-    if (self->data->fractional_separation_enabled) {
+    if (self->data->fractional_separation_enabled ||
+        self->data->rcfix.enabled || self->data->relax_heur_freq > 0 ||
+        self->data->portfolio.shared) {
         contextmask |= CPX_CALLBACKCONTEXT_RELAXATION;
     }
 
@@ -1144,6 +2733,35 @@ static bool on_solve_start(Solver *self, const Instance *instance,
     contextmask |= CPX_CALLBACKCONTEXT_GLOBAL_PROGRESS;
 #endif
 
+    // NOTE(dparo):
+    //      The pricer mode early termination happens from the progress
+    //      callback: it must be subscribed in release builds too.
+    if (self->data->heur_pricer_mode) {
+        contextmask |= CPX_CALLBACKCONTEXT_GLOBAL_PROGRESS;
+    }
+
+    // NOTE(dparo):
+    //      The members of a portfolio publish their incumbents from the
+    //      global progress callback, and import the ones of the others from
+    //      the relaxation callback.
+    if (self->data->portfolio.shared) {
+        contextmask |= CPX_CALLBACKCONTEXT_GLOBAL_PROGRESS;
+    }
+
+    if (self->data->rcfix.enabled) {
+        contextmask |= CPX_CALLBACKCONTEXT_GLOBAL_PROGRESS;
+
+        // NOTE(dparo):
+        //      The columns fixed before the branch and cut are already fixed
+        //      in the LP. The separation networks still need to drop them.
+        atomic_store(&callback_ctx->rcfix.num_published,
+                     self->data->rcfix.num_fixed);
+    }
+
+    if (self->persistent && !install_user_cuts(self)) {
+        goto fail;
+    }
+
     if (CPXXcallbacksetfunc(self->data->env, self->data->lp, contextmask,
                             cplex_callback, (void *)callback_ctx) != 0) {
         log_fatal(
@@ -1189,13 +2807,145 @@ static bool on_solve_end(Solver *self, const Instance *instance,
         goto fail;
     }
 
-    destroy_all_callback_thread_local_data(callback_ctx);
+    // Node ids are not preserved across solves
+    hmfree(self->data->branching.pending);
+    self->data->branching.pruned_bound = INFINITY;
+
+    if (self->persistent) {
+        flush_cut_pools(self, callback_ctx);
+    } else {
+        destroy_all_callback_thread_local_data(callback_ctx);
+    }
 
     return true;
 fail:
     return false;
 }
 
+/// Retrieves the MIP solution into `vstar`, expressed in terms of the
+/// (complete) MIP variables.
+static bool get_mip_solution(Solver *self, double *vstar) {
+    SolverData *data = self->data;
+    if (!data->sparse.enabled) {
+        return 0 == CPXXgetx(data->env, data->lp, vstar, 0,
+                             (CPXDIM)data->num_mip_vars - 1);
+    }
+
+    bool result = false;
+    double *cols = malloc(data->sparse.num_cols * sizeof(*cols));
+    if (cols && 0 == CPXXgetx(data->env, data->lp, cols, 0,
+                              data->sparse.num_cols - 1)) {
+        mip_scatter_cols(data, cols, vstar);
+        result = true;
+    }
+    free(cols);
+    return result;
+}
+
+/// Feeds the negative reduced cost tours stored in the CPLEX solution pool to
+/// the pricer collection (see mip_pricer_collect_tour()).
+static bool collect_solution_pool_tours(Solver *self, const Instance *instance,
+                                        double *vstar) {
+    SolverData *data = self->data;
+    bool result = true;
+    const int num_sols = CPXXgetsolnpoolnumsolns(data->env, data->lp);
+    const CPXDIM num_cols = mip_num_cols(data);
+
+    Tour tour = tour_create(instance);
+    double *cols = data->sparse.enabled ? malloc(num_cols * sizeof(*cols))
+                                        : vstar;
+    if (!cols || !tour_is_valid(&tour)) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        result = false;
+        goto terminate;
+    }
+
+    for (int k = 0; k < num_sols; k++) {
+        double obj = INFINITY;
+        if (0 != CPXXgetsolnpoolobjval(data->env, data->lp, k, &obj)) {
+            log_warn("%s :: CPXXgetsolnpoolobjval failed", __func__);
+            continue;
+        }
+        if (!is_valid_reduced_cost(obj)) {
+            continue;
+        }
+        if (0 != CPXXgetsolnpoolx(data->env, data->lp, k, cols, 0,
+                                  num_cols - 1)) {
+            log_warn("%s :: CPXXgetsolnpoolx failed", __func__);
+            continue;
+        }
+        if (data->sparse.enabled) {
+            mip_scatter_cols(data, cols, vstar);
+        }
+
+        unpack_mip_solution(instance, &tour, vstar);
+        if (tour.num_comps == 1) {
+            mip_pricer_collect_tour(data, &tour, obj);
+        }
+    }
+
+terminate:
+    if (cols != vstar) {
+        free(cols);
+    }
+    tour_destroy(&tour);
+    return result;
+}
+
+/// Copies the tours collected by the pricer into the solution.
+static void export_pricer_tours(SolverData *data, Solution *solution) {
+    solution_clear_tours(solution);
+
+    for (ptrdiff_t i = 0; i < arrlen(data->pricer.tours); i++) {
+        arrput(solution->tours, tour_copy(&data->pricer.tours[i]));
+        arrput(solution->tours_cost, data->pricer.costs[i]);
+    }
+}
+
+/// Size of the candidate lists of the final Lin-Kernighan polishing
+#define POLISH_NUM_NEIGHBORS 25
+
+/// Polishes the route of the final solution with ls_lin_kernighan(). See the
+/// `LIN_KERNIGHAN` param.
+static bool polish_solution_tour(SolverData *data, const Instance *instance,
+                                 Solution *solution) {
+    // NOTE(dparo):
+    //      The polishing never changes the set of visited customers: the
+    //      profits and the capacity usage stay the same, and only the
+    //      travelling distance can decrease.
+    bool result = false;
+    LsNeighborLists nl = {0};
+    Tour tour = tour_copy(&solution->tour);
+    if (!tour_is_valid(&tour) ||
+        !ls_neighbor_lists_create(&nl, instance, POLISH_NUM_NEIGHBORS)) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        goto terminate;
+    }
+
+    int64_t num_evals = 0;
+    double delta = ls_lin_kernighan(instance, &nl, &tour, &num_evals);
+    mip_add_work(data, 4 * num_evals);
+
+    if (delta < -COST_TOLERANCE &&
+        mip_tour_respects_edge_fixings(data, instance, &tour)) {
+        log_info("%s :: Improved the route of the final solution by %f",
+                 __func__, -delta);
+        mip_pricer_collect_tour(data, &tour, tour_eval(instance, &tour));
+        solution->primal_bound += delta;
+
+        // The original route is released on termination
+        Tour tmp = solution->tour;
+        solution->tour = tour;
+        tour = tmp;
+    }
+
+    result = true;
+terminate:
+    ls_neighbor_lists_destroy(&nl);
+    tour_destroy(&tour);
+    return result;
+}
+
 static bool process_cplex_output(Solver *self, const Instance *instance,
                                  Solution *solution, double *vstar, int lpstat,
                                  SolveStatus status) {
@@ -1215,8 +2965,7 @@ static bool process_cplex_output(Solver *self, const Instance *instance,
         }
 
         if (found_primal_solution) {
-            if (0 != CPXXgetx(self->data->env, self->data->lp, vstar, 0,
-                              self->data->num_mip_vars - 1)) {
+            if (!get_mip_solution(self, vstar)) {
                 log_fatal(
                     "%s :: Failed to access MIP solution, even though primal "
                     "solution should be available",
@@ -1288,8 +3037,20 @@ static bool process_cplex_output(Solver *self, const Instance *instance,
         }
 
         unpack_mip_solution(instance, &solution->tour, vstar);
+
+        if (!collect_solution_pool_tours(self, instance, vstar)) {
+            goto failure;
+        }
+
+        if (self->data->lin_kernighan &&
+            !BOOL(status & SOLVE_STATUS_CLOSED_PROBLEM) &&
+            !polish_solution_tour(self->data, instance, solution)) {
+            goto failure;
+        }
     }
 
+    export_pricer_tours(self->data, solution);
+
     return true;
 failure:
     return false;
@@ -1368,26 +3129,417 @@ SolveStatus convert_mip_lpstat_to_solvestatus(int lpstat,
     return status;
 }
 
-SolveStatus solve(Solver *self, const Instance *instance, Solution *solution,
-                  int64_t begin_time) {
+/// Values below this threshold are reported as zero in the relaxation point
+static const double LP_BOUND_EPS = 1e-6;
+
+/// Records in `solution->relaxation` the fractional point `vstar`
+static void export_relaxation_point(const Instance *instance,
+                                    Solution *solution, const double *vstar) {
+    const int32_t n = instance->num_customers + 1;
+
+    arrsetlen(solution->relaxation.node_values, 0);
+    arrsetlen(solution->relaxation.edge_values, 0);
+    for (int32_t i = 0; i < n; i++) {
+        arrput(solution->relaxation.node_values,
+               vstar[get_y_mip_var_idx(instance, i)]);
+    }
+    for (int32_t i = 0; i < n; i++) {
+        for (int32_t j = i + 1; j < n; j++) {
+            double v = vstar[get_x_mip_var_idx(instance, i, j)];
+            if (v > LP_BOUND_EPS) {
+                EdgeValue e = {i, j, v};
+                arrput(solution->relaxation.edge_values, e);
+            }
+        }
+    }
+}
+
+static bool is_integral_point(const SolverData *data, const double *vstar) {
+    for (size_t k = 0; k < data->num_mip_vars; k++) {
+        if (fabs(vstar[k] - round(vstar[k])) > LP_BOUND_EPS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Prepares `tld` for the separation of the fractional cuts driven by our own
+/// cutting plane loop: the cuts are recorded in `tld->cut_pool`.
+static bool create_lp_separation_data(CallbackThreadLocalData *tld,
+                                      const Instance *instance, Solver *self) {
+    if (!create_callback_thread_local_data(tld, NULL, instance, self)) {
+        return false;
+    }
+    for (int32_t cut_id = 0; cut_id < (int32_t)NUM_CUTS; cut_id++) {
+        if (is_active_cut(cut_id)) {
+            tld->functors[cut_id].internal.cut_pool = &tld->cut_pool;
+        }
+    }
+    return true;
+}
+
+/// One round of our own cutting plane loop: solves the continuous problem
+/// `lp`, and separates into `tld->cut_pool` the fractional cuts violated by its
+/// optimum. The optimum is left in `tld->vstar`, and its value in `*bound`.
+/// Nothing is separated unless `*lpstat` is CPX_STAT_OPTIMAL.
+static bool solve_and_separate_lp(Solver *self, const Instance *instance,
+                                  CPXLPptr lp, CallbackThreadLocalData *tld,
+                                  double *cols, int *lpstat, double *bound) {
+    SolverData *data = self->data;
+    const CPXDIM num_cols = mip_num_cols(data);
+
+    cut_pool_clear(&tld->cut_pool);
+
+    if (CPXXlpopt(data->env, lp) != 0) {
+        log_fatal("%s :: CPXXlpopt failed", __func__);
+        return false;
+    }
+
+    *lpstat = CPXXgetstat(data->env, lp);
+    if (*lpstat != CPX_STAT_OPTIMAL) {
+        return true;
+    }
+
+    if (CPXXgetobjval(data->env, lp, bound) != 0 ||
+        CPXXgetx(data->env, lp, cols, 0, num_cols - 1) != 0) {
+        log_fatal("%s :: Failed to retrieve the LP solution", __func__);
+        return false;
+    }
+
+    if (data->sparse.enabled) {
+        mip_scatter_cols(data, cols, tld->vstar);
+    } else {
+        memcpy(tld->vstar, cols, num_cols * sizeof(*cols));
+    }
+
+    return !data->fractional_separation_enabled ||
+           separate_fractional_point(NULL, data, tld, instance, *bound);
+}
+
+/// Adds the cuts of `cuts` to `lp`. `rows` is used as scratch space.
+static bool add_lp_cuts(const SolverData *data, CPXLPptr lp,
+                        const CutPool *cuts, CutPool *rows) {
+    cut_pool_to_cols(data, cuts, rows);
+    if (CPXXaddrows(data->env, lp, 0, (CPXDIM)arrlen(rows->rhs),
+                    (CPXNNZ)arrlen(rows->rmatind), rows->rhs, rows->sense,
+                    rows->rmatbeg, rows->rmatind, rows->rmatval, NULL,
+                    NULL) != 0) {
+        log_fatal("%s :: CPXXaddrows failed", __func__);
+        return false;
+    }
+    return true;
+}
+
+/// Relaxation only solve (see the `LP_BOUND_MODE` param). Iterates the LP
+/// relaxation of the model with the separation of the fractional cuts, until
+/// no violated cut is found, or the round or time limits are reached. No
+/// branching takes place: the resulting dual bound, per round bounds and
+/// fractional point are reported in `solution`.
+static SolveStatus solve_lp_bound(Solver *self, const Instance *instance,
+                                  Solution *solution) {
+    SolverData *data = self->data;
+    const CPXDIM num_cols = mip_num_cols(data);
+    const int64_t begin_time = os_get_usecs();
+    SolveStatus status = SOLVE_STATUS_ERR;
+    CallbackThreadLocalData tld = {0};
+    CutPool rows = {0};
+    double *cols = NULL;
+    double bound = -INFINITY;
+    SolveStatus abortion = SOLVE_STATUS_NULL;
+    int cpx_status = 0;
+
+    double timelimit = INFINITY;
+    if (CPXXgetdblparam(data->env, CPX_PARAM_TILIM, &timelimit) != 0) {
+        log_warn("%s :: Failed to retrieve CPX_PARAM_TILIM", __func__);
+    }
+
+    CPXLPptr lp = CPXXcloneprob(data->env, data->lp, &cpx_status);
+    if (cpx_status != 0 || !lp) {
+        log_fatal("%s :: CPXXcloneprob failed", __func__);
+        return SOLVE_STATUS_ERR;
+    }
+
+    if (CPXXchgprobtype(data->env, lp, CPXPROB_LP) != 0) {
+        log_fatal("%s :: CPXXchgprobtype failed", __func__);
+        goto terminate;
+    }
+
+    cols = malloc(num_cols * sizeof(*cols));
+    if (!cols || !create_lp_separation_data(&tld, instance, self)) {
+        log_fatal("%s :: Failed to allocate the separation data", __func__);
+        goto terminate;
+    }
+
+    arrsetlen(solution->relaxation.round_bounds, 0);
+
+    for (int32_t round = 0; round < data->lp_bound.max_rounds; round++) {
+        int lpstat = 0;
+        if (!solve_and_separate_lp(self, instance, lp, &tld, cols, &lpstat,
+                                   &bound)) {
+            goto terminate;
+        }
+
+        if (lpstat == CPX_STAT_INFEASIBLE) {
+            solution->dual_bound = INFINITY;
+            solution->primal_bound = INFINITY;
+            status = SOLVE_STATUS_CLOSED_PROBLEM;
+            goto terminate;
+        } else if (lpstat != CPX_STAT_OPTIMAL) {
+            log_fatal("%s :: Unexpected LP status (lpstat = %d)", __func__,
+                      lpstat);
+            goto terminate;
+        }
+
+        arrput(solution->relaxation.round_bounds, bound);
+
+        CPXDIM rcnt = (CPXDIM)arrlen(tld.cut_pool.rhs);
+        log_info("%s :: round %d, bound = %f, separated cuts = %d", __func__,
+                 round, bound, rcnt);
+
+        if (rcnt == 0) {
+            break;
+        }
+
+        if (!add_lp_cuts(data, lp, &tld.cut_pool, &rows)) {
+            goto terminate;
+        }
+
+        double elapsed = (double)(os_get_usecs() - begin_time) * USECS_TO_SECS;
+        if (self->sigterm_occured) {
+            abortion = SOLVE_STATUS_ABORTION_SIGTERM;
+            break;
+        } else if (elapsed >= timelimit) {
+            abortion = SOLVE_STATUS_ABORTION_RES_EXHAUSTED;
+            break;
+        }
+    }
+
+    if (arrlen(solution->relaxation.round_bounds) == 0) {
+        // NOTE(dparo): Only possible with LP_BOUND_MAX_ROUNDS <= 0
+        log_fatal("%s :: No LP relaxation was solved", __func__);
+        goto terminate;
+    }
+
+    export_relaxation_point(instance, solution, tld.vstar);
+    solution->dual_bound = bound;
+    solution->primal_bound = INFINITY;
+    status = SOLVE_STATUS_RELAXATION_ONLY;
+
+    if (arrlen(tld.cut_pool.rhs) == 0 && is_integral_point(data, tld.vstar)) {
+        // NOTE(dparo):
+        //      An integral point violating none of the cuts is a tour: the
+        //      relaxation closes the problem.
+        unpack_mip_solution(instance, &solution->tour, tld.vstar);
+        if (solution->tour.num_comps == 1) {
+            solution->primal_bound = bound;
+            status = SOLVE_STATUS_PRIMAL_SOLUTION_AVAIL |
+                     SOLVE_STATUS_CLOSED_PROBLEM;
+        } else {
+            tour_clear(&solution->tour);
+        }
+    }
+
+    status |= abortion;
+
+    log_info("%s :: LP bound = %f after %td rounds", __func__, bound,
+             arrlen(solution->relaxation.round_bounds));
+
+terminate:
+    destroy_callback_thread_local_data(&tld);
+    cut_pool_destroy(&rows);
+    free(cols);
+    CPXXfreeprob(data->env, &lp);
+    return status;
+}
+
+/// Cutting plane rounds over the root LP relaxation, before its reduced costs
+/// are taken for the reduced cost fixing
+static const int32_t RCFIX_ROOT_MAX_ROUNDS = 100;
+/// The root cutting plane loop stops when a round improves the bound by less
+/// than this fraction of its value
+static const double RCFIX_ROOT_TAILING_OFF = 1e-4;
+
+/// Solves the root LP relaxation of the current formulation, on a copy of the
+/// problem, strengthened by our own cutting plane loop over the fractional
+/// cuts (see solve_lp_bound()). The objective value and the reduced costs of
+/// the last LP solved to optimality are recorded for the reduced cost fixing.
+/// NOTE(dparo):
+///      The generic callbacks have no access to the reduced costs of the
+///      node LPs, thus the root node of the branch and cut cannot be used.
+static bool solve_root_lp_relaxation(Solver *self, const Instance *instance) {
+    bool result = false;
+    SolverData *data = self->data;
+    const CPXDIM num_cols = mip_num_cols(data);
+    CallbackThreadLocalData tld = {0};
+    CutPool rows = {0};
+    double *cols = NULL;
+    int lpstat = 0;
+    int status = 0;
+
+    data->rcfix.root_bound = -INFINITY;
+
+    CPXLPptr lp = CPXXcloneprob(data->env, data->lp, &status);
+    if (status != 0 || !lp) {
+        log_fatal("%s :: CPXXcloneprob failed", __func__);
+        return false;
+    }
+
+    if (CPXXchgprobtype(data->env, lp, CPXPROB_LP) != 0) {
+        log_fatal("%s :: CPXXchgprobtype failed", __func__);
+        goto terminate;
+    }
+
+    cols = malloc(num_cols * sizeof(*cols));
+    if (!cols || !create_lp_separation_data(&tld, instance, self)) {
+        log_fatal("%s :: Failed to allocate the separation data", __func__);
+        goto terminate;
+    }
+
+    int32_t num_rounds = 0;
+    for (int32_t round = 0; round < RCFIX_ROOT_MAX_ROUNDS; round++) {
+        const double prev_bound = data->rcfix.root_bound;
+        double bound = -INFINITY;
+        if (!solve_and_separate_lp(self, instance, lp, &tld, cols, &lpstat,
+                                   &bound)) {
+            goto terminate;
+        }
+
+        // NOTE(dparo):
+        //      Not an error: the MIP may be infeasible as well. The reduced
+        //      costs of the previous round, if any, are still valid.
+        if (lpstat != CPX_STAT_OPTIMAL) {
+            break;
+        }
+
+        // NOTE(dparo): Taken before adding the cuts, which discard the solution
+        if (CPXXgetdj(data->env, lp, data->rcfix.dj, 0, num_cols - 1) != 0) {
+            log_fatal("%s :: CPXXgetdj failed", __func__);
+            goto terminate;
+        }
+        data->rcfix.root_bound = bound;
+        ++num_rounds;
+
+        const bool tailing_off =
+            bound - prev_bound < RCFIX_ROOT_TAILING_OFF * MAX(1.0, fabs(bound));
+        if (arrlen(tld.cut_pool.rhs) == 0 || tailing_off ||
+            self->sigterm_occured) {
+            break;
+        }
+
+        if (!add_lp_cuts(data, lp, &tld.cut_pool, &rows)) {
+            goto terminate;
+        }
+    }
+
+    if (isfinite(data->rcfix.root_bound)) {
+        log_info("%s :: root LP relaxation bound = %f after %d cutting plane "
+                 "rounds",
+                 __func__, data->rcfix.root_bound, num_rounds);
+    } else {
+        log_warn("%s :: root LP relaxation not solved to optimality (lpstat = "
+                 "%d). Reduced cost fixing is disabled",
+                 __func__, lpstat);
+    }
+    result = true;
+
+terminate:
+    destroy_callback_thread_local_data(&tld);
+    cut_pool_destroy(&rows);
+    free(cols);
+    CPXXfreeprob(data->env, &lp);
+    return result;
+}
+
+/// Computes the root reduced costs and fixes to zero (CPXXchgbds), before the
+/// branch and cut starts, the columns that cannot improve over `primal_bound`.
+/// The columns that become fixable when the incumbent improves are later
+/// dropped from the separation networks only (see reduced_cost_fixing()).
+static bool init_reduced_cost_fixing(Solver *self, const Instance *instance,
+                                     double primal_bound) {
+    SolverData *data = self->data;
+    const CPXDIM num_cols = mip_num_cols(data);
+
+    free(data->rcfix.dj);
+    free(data->rcfix.fixed_cols);
+    free(data->rcfix.is_fixed);
+    data->rcfix.dj = malloc(num_cols * sizeof(*data->rcfix.dj));
+    data->rcfix.fixed_cols = malloc(num_cols * sizeof(*data->rcfix.fixed_cols));
+    data->rcfix.is_fixed = calloc(num_cols, sizeof(*data->rcfix.is_fixed));
+    data->rcfix.num_fixed = 0;
+    data->rcfix.num_presolve_fixed = 0;
+    data->rcfix.primal_bound = INFINITY;
+    if (!data->rcfix.dj || !data->rcfix.fixed_cols || !data->rcfix.is_fixed) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        return false;
+    }
+
+    if (!solve_root_lp_relaxation(self, instance)) {
+        return false;
+    }
+
+    CPXDIM cnt = mark_reduced_cost_fixable_cols(data, instance, primal_bound);
+    data->rcfix.num_presolve_fixed = cnt;
+
+    log_info("%s :: primal_bound = %f, root_bound = %f -- fixing %d of the "
+             "%d columns to zero",
+             __func__, primal_bound, data->rcfix.root_bound, cnt, num_cols);
+
+    if (cnt > 0) {
+        char *lu = malloc(cnt * sizeof(*lu));
+        double *bd = malloc(cnt * sizeof(*bd));
+        bool success = lu && bd;
+
+        for (CPXDIM k = 0; success && k < cnt; k++) {
+            lu[k] = 'U';
+            bd[k] = 0.0;
+        }
+
+        success = success && 0 == CPXXchgbds(data->env, data->lp, cnt,
+                                             data->rcfix.fixed_cols, lu, bd);
+        free(lu);
+        free(bd);
+
+        if (!success) {
+            log_fatal("%s :: CPXXchgbds failed", __func__);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static SolveStatus solve_model(Solver *self, const Instance *instance,
+                               Solution *solution, int64_t begin_time) {
     self->data->begin_time = begin_time;
 
     SolveStatus status = SOLVE_STATUS_ERR;
 
-    CplexCallbackCtx callback_ctx = {0};
-    callback_ctx.solver = self;
-    callback_ctx.instance = instance;
+    CplexCallbackCtx *callback_ctx = self->data->callback_ctx;
+    callback_ctx->solver = self;
+    callback_ctx->instance = instance;
+
+    if (self->data->lp_bound.enabled) {
+        return solve_lp_bound(self, instance, solution);
+    }
 
-    if (!on_solve_start(self, instance, &callback_ctx)) {
+    if (!on_solve_start(self, instance, callback_ctx)) {
         return SOLVE_STATUS_ERR;
     }
 
-    if (CPXXmipopt(self->data->env, self->data->lp) != 0) {
+    if (self->data->heur_thread.enabled &&
+        !mip_heur_thread_start(self, instance)) {
+        log_warn("%s :: Failed to start the heuristic thread", __func__);
+    }
+
+    int mipopt_status = CPXXmipopt(self->data->env, self->data->lp);
+    mip_heur_thread_stop(self);
+
+    if (mipopt_status != 0) {
         log_fatal("%s :: CPXmipopt() error", __func__);
         return SOLVE_STATUS_ERR;
     }
 
-    if (!on_solve_end(self, instance, &callback_ctx)) {
+    if (!on_solve_end(self, instance, callback_ctx)) {
         return SOLVE_STATUS_ERR;
     }
 
@@ -1419,11 +3571,213 @@ terminate:
     return status;
 }
 
+/// Maps the relaxation point of `reduced`, a solution of the presolved
+/// instance, into `solution`. The removed customers take a zero value.
+static void presolve_map_relaxation(const InstancePresolve *ps,
+                                    const Solution *reduced,
+                                    Solution *solution) {
+    const int32_t n = solution->tour.num_customers + 1;
+
+    arrsetlen(solution->relaxation.round_bounds, 0);
+    for (ptrdiff_t k = 0; k < arrlen(reduced->relaxation.round_bounds); k++) {
+        arrput(solution->relaxation.round_bounds,
+               reduced->relaxation.round_bounds[k]);
+    }
+
+    arrsetlen(solution->relaxation.node_values, 0);
+    arrsetlen(solution->relaxation.edge_values, 0);
+    if (arrlen(reduced->relaxation.node_values) == 0) {
+        return;
+    }
+
+    for (int32_t i = 0; i < n; i++) {
+        arrput(solution->relaxation.node_values, 0.0);
+    }
+    for (ptrdiff_t k = 0; k < arrlen(reduced->relaxation.node_values); k++) {
+        solution->relaxation.node_values[ps->orig_index[k]] =
+            reduced->relaxation.node_values[k];
+    }
+    for (ptrdiff_t k = 0; k < arrlen(reduced->relaxation.edge_values); k++) {
+        EdgeValue e = reduced->relaxation.edge_values[k];
+        e.i = ps->orig_index[e.i];
+        e.j = ps->orig_index[e.j];
+        arrput(solution->relaxation.edge_values, e);
+    }
+}
+
+/// Publishes the incumbents of `self` to `shared`, and imports the ones
+/// published by the others (see import_shared_incumbent()).
+static bool attach_shared_incumbent(Solver *self, const Instance *instance,
+                                    MipSharedIncumbent *shared,
+                                    int32_t member_id) {
+    SolverData *data = self->data;
+
+    data->portfolio.member_id = member_id;
+    if (!data->portfolio.cols) {
+        data->portfolio.cols =
+            malloc(mip_num_cols(data) * sizeof(*data->portfolio.cols));
+    }
+    if (!data->portfolio.vstar) {
+        data->portfolio.vstar =
+            malloc(data->num_mip_vars * sizeof(*data->portfolio.vstar));
+    }
+    if (!tour_is_valid(&data->portfolio.tour)) {
+        data->portfolio.tour = tour_create(instance);
+    }
+    if (!data->portfolio.cols || !data->portfolio.vstar ||
+        !tour_is_valid(&data->portfolio.tour)) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        return false;
+    }
+
+    atomic_store(&data->portfolio.seen_version, 0);
+    data->portfolio.shared = shared;
+    return true;
+}
+
+bool mip_join_portfolio(Solver *self, const Instance *instance,
+                        MipSharedIncumbent *shared, int32_t member_id) {
+    if (self->data->presolve.enabled) {
+        // NOTE(dparo):
+        //      The tours of a presolved model live in the reduced instance,
+        //      which may differ from the one of the other members.
+        log_info("%s :: member %d is presolved, its incumbents are not shared",
+                 __func__, member_id);
+        return true;
+    }
+
+    return attach_shared_incumbent(self, instance, shared, member_id);
+}
+
+/// Deterministic ticks spent since `det.last_stamp`: the ones measured by
+/// CPLEX, plus our own work units
+static double peek_det_ticks(SolverData *data) {
+    double stamp = data->det.last_stamp;
+    if (0 != CPXXgetdettime(data->env, &stamp)) {
+        log_warn("%s :: CPXXgetdettime failed", __func__);
+    }
+    int64_t work_units = atomic_load(&data->det.work_units);
+    return (stamp - data->det.last_stamp) +
+           (double)work_units / MIP_WORK_UNITS_PER_TICK;
+}
+
+/// Reports into `solution` the deterministic ticks spent since the previous
+/// solve (or since the creation of the solver), and restarts the accounting.
+static void record_det_ticks(SolverData *data, Solution *solution) {
+    solution->det_ticks = peek_det_ticks(data);
+    CPXXgetdettime(data->env, &data->det.last_stamp);
+    atomic_store(&data->det.work_units, 0);
+    log_info("%s :: solve took %f deterministic ticks", __func__,
+             solution->det_ticks);
+}
+
+/// Solves the model, mapping the solution of the presolved instance back to
+/// `instance`, when the presolve is enabled.
+SolveStatus solve(Solver *self, const Instance *instance, Solution *solution,
+                  int64_t begin_time) {
+    if (!self->data->presolve.enabled) {
+        SolveStatus status = solve_model(self, instance, solution, begin_time);
+        record_det_ticks(self->data, solution);
+        return status;
+    }
+
+    const InstancePresolve *ps = &self->data->presolve.ps;
+    Solution reduced = solution_create(&ps->reduced);
+    SolveStatus status = solve_model(self, &ps->reduced, &reduced, begin_time);
+
+    solution->primal_bound = reduced.primal_bound;
+    solution->dual_bound = reduced.dual_bound;
+    record_det_ticks(self->data, solution);
+    presolve_map_tour(ps, &reduced.tour, &solution->tour);
+    presolve_map_relaxation(ps, &reduced, solution);
+
+    solution_clear_tours(solution);
+    for (ptrdiff_t i = 0; i < arrlen(reduced.tours); i++) {
+        Tour t = tour_create(instance);
+        presolve_map_tour(ps, &reduced.tours[i], &t);
+        arrput(solution->tours, t);
+        arrput(solution->tours_cost, reduced.tours_cost[i]);
+    }
+
+    solution_destroy(&reduced);
+    return status;
+}
+
+/// Fixes to zero the edges forbidden by the presolve
+static bool fix_presolve_forbidden_edges(Solver *self,
+                                         const Instance *instance) {
+    const InstancePresolve *ps = &self->data->presolve.ps;
+    const ptrdiff_t num_edges = arrlen(ps->forbidden_edges) / 2;
+    bool result = true;
+
+    CPXDIM *indices = malloc(MAX(1, num_edges) * sizeof(*indices));
+    char *lu = malloc(MAX(1, num_edges) * sizeof(*lu));
+    double *bd = malloc(MAX(1, num_edges) * sizeof(*bd));
+    if (!indices || !lu || !bd) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        result = false;
+        goto terminate;
+    }
+
+    CPXDIM cnt = 0;
+    for (ptrdiff_t k = 0; k < num_edges; k++) {
+        CPXDIM col = mip_var_to_col(
+            self->data,
+            get_x_mip_var_idx(instance, ps->forbidden_edges[2 * k],
+                              ps->forbidden_edges[2 * k + 1]));
+        if (col >= 0) {
+            indices[cnt] = col;
+            lu[cnt] = 'U';
+            bd[cnt] = 0.0;
+            ++cnt;
+        }
+    }
+
+    if (cnt > 0 && 0 != CPXXchgbds(self->data->env, self->data->lp, cnt,
+                                   indices, lu, bd)) {
+        log_fatal("%s :: CPXXchgbds failed", __func__);
+        result = false;
+    }
+
+terminate:
+    free(indices);
+    free(lu);
+    free(bd);
+    return result;
+}
+
+/// Presolves the instance, and enables the presolve only if the reduced
+/// instance can still host a MIP feasible tour.
+static bool presolve_instance(Solver *self, const Instance *instance,
+                              SolverTypedParams *tparams) {
+    double upper_bound = INFINITY;
+    if (solver_params_get_bool(tparams, "APPLY_UPPER_CUTOFF")) {
+        upper_bound = 0.0;
+    }
+
+    if (!instance_presolve(instance, upper_bound, MIP_MIN_NUM_VISITED,
+                           &self->data->presolve.ps)) {
+        return false;
+    }
+
+    if (self->data->presolve.ps.reduced.num_customers + 1 <
+        MIP_MIN_NUM_VISITED) {
+        log_info("%s :: Too few customers left, solving the original instance",
+                 __func__);
+        instance_presolve_destroy(&self->data->presolve.ps);
+        return true;
+    }
+
+    self->data->presolve.enabled = true;
+    return true;
+}
+
 // NOTE: Not thread safe
 static void enable_cuts(SolverTypedParams *tparams) {
     G_cuts[GSEC_CUT_ID].enabled = solver_params_get_bool(tparams, "GSEC_CUTS");
     G_cuts[GLM_CUT_ID].enabled = solver_params_get_bool(tparams, "GLM_CUTS");
     G_cuts[RCI_CUT_ID].enabled = solver_params_get_bool(tparams, "RCI_CUTS");
+    G_cuts[COMB_CUT_ID].enabled = solver_params_get_bool(tparams, "COMB_CUTS");
 
     G_cuts[GSEC_CUT_ID].fractional_sep_enabled =
         G_cuts[GSEC_CUT_ID].enabled &&
@@ -1434,6 +3788,9 @@ static void enable_cuts(SolverTypedParams *tparams) {
     G_cuts[RCI_CUT_ID].fractional_sep_enabled =
         G_cuts[RCI_CUT_ID].enabled &&
         solver_params_get_bool(tparams, "RCI_FRAC_CUTS");
+    G_cuts[COMB_CUT_ID].fractional_sep_enabled =
+        G_cuts[COMB_CUT_ID].enabled &&
+        solver_params_get_bool(tparams, "COMB_FRAC_CUTS");
 }
 
 static inline double compute_trivial_lower_cutoff(const Instance *instance) {
@@ -1484,12 +3841,106 @@ bool cplex_setup(Solver *solver, const Instance *instance,
         }
     }
 
+    solver->data->var_names = solver_params_get_bool(tparams, "VAR_NAMES");
+    solver->data->pricer.num_tours =
+        solver_params_get_int32(tparams, "PRICER_NUM_TOURS");
+
+    solver->data->sparse.knn =
+        solver_params_get_int32(tparams, "SPARSE_FORMULATION_KNN");
+    solver->data->sparse.enabled = solver->data->sparse.knn > 0;
+
+    solver->data->rcfix.enabled =
+        solver_params_get_bool(tparams, "REDUCED_COST_FIXING");
+    solver->data->relax_heur_freq =
+        solver_params_get_int32(tparams, "RELAXATION_HEUR_FREQ");
+    solver->data->lin_kernighan =
+        solver_params_get_bool(tparams, "LIN_KERNIGHAN");
+    solver->data->lp_bound.enabled =
+        solver_params_get_bool(tparams, "LP_BOUND_MODE");
+    solver->data->lp_bound.max_rounds =
+        solver_params_get_int32(tparams, "LP_BOUND_MAX_ROUNDS");
+    solver->data->det.timelimit =
+        solver_params_get_double(tparams, "DET_TIMELIMIT");
+    solver->data->heur_thread.enabled =
+        solver_params_get_bool(tparams, "HEUR_THREAD") &&
+        !solver->data->lp_bound.enabled;
+
+    if (solver->data->det.timelimit > 0.0) {
+        // NOTE(dparo):
+        //      The heuristic thread runs for as long as the wall clock allows,
+        //      which defeats the purpose of a deterministic solve.
+        if (solver->data->heur_thread.enabled) {
+            log_warn("%s :: HEUR_THREAD is ignored with a DET_TIMELIMIT",
+                     __func__);
+            solver->data->heur_thread.enabled = false;
+        }
+
+        log_info("%s :: CPXXsetintparam -- Setting CPX_PARAM_PARALLELMODE to "
+                 "CPX_PARALLEL_DETERMINISTIC",
+                 __func__);
+        if (0 != CPXXsetintparam(solver->data->env, CPX_PARAM_PARALLELMODE,
+                                 CPX_PARALLEL_DETERMINISTIC)) {
+            log_fatal("%s :: CPXXsetintparam -- Failed to setup "
+                      "CPX_PARAM_PARALLELMODE",
+                      __func__);
+            goto fail;
+        }
+    }
+
+    if (0 != CPXXgetdettime(solver->data->env, &solver->data->det.last_stamp)) {
+        log_fatal("%s :: CPXXgetdettime failed", __func__);
+        goto fail;
+    }
+
+    solver->data->warm_start_pool.effort =
+        solver_params_get_int32(tparams, "WARM_START_EFFORT");
+    if (solver->data->warm_start_pool.effort < CPX_MIPSTART_AUTO ||
+        solver->data->warm_start_pool.effort > CPX_MIPSTART_NOCHECK) {
+        log_fatal("%s :: Invalid WARM_START_EFFORT (%d)", __func__,
+                  solver->data->warm_start_pool.effort);
+        goto fail;
+    }
+
+    solver->data->warm_start_pool.num_tours =
+        solver_params_get_int32(tparams, "WARM_START_NUM_TOURS");
+    if (solver->data->warm_start_pool.num_tours <= 0) {
+        log_fatal("%s :: Invalid WARM_START_NUM_TOURS (%d)", __func__,
+                  solver->data->warm_start_pool.num_tours);
+        goto fail;
+    }
+
+    solver->data->branching.strategy =
+        solver_params_get_int32(tparams, "BRANCHING_STRATEGY");
+    if (solver->data->branching.strategy < BRANCHING_STRATEGY_CPLEX ||
+        solver->data->branching.strategy >
+            BRANCHING_STRATEGY_CARDINALITY_PSEUDOCOST) {
+        log_fatal("%s :: Invalid BRANCHING_STRATEGY (%d)", __func__,
+                  solver->data->branching.strategy);
+        goto fail;
+    }
+    solver->data->branching.pruned_bound = INFINITY;
+    for (int32_t dir = 0; dir < 2; dir++) {
+        solver->data->branching.pc_sum[dir] =
+            calloc(instance->num_customers + 1, sizeof(double));
+        solver->data->branching.pc_cnt[dir] =
+            calloc(instance->num_customers + 1, sizeof(int64_t));
+        if (!solver->data->branching.pc_sum[dir] ||
+            !solver->data->branching.pc_cnt[dir]) {
+            log_fatal("%s :: Failed memory allocation", __func__);
+            goto fail;
+        }
+    }
+
     if (solver_params_get_bool(tparams, "SCRIND")) {
         CPXXsetintparam(solver->data->env, CPX_PARAM_SCRIND, 1);
         CPXXsetintparam(solver->data->env, CPX_PARAM_MIPDISPLAY, 4);
     }
 
-    // Clamp the number of available cores to MAX_NUM_CORES
+    // NOTE(dparo):
+    //      At its default setting 0, CPX_PARAM_THREADS lets CPLEX use at most
+    //      32 threads. Set it explicitly, such that all the cores of the
+    //      machine are used (or the `NUM_THREADS` requested ones).
+    //      See https://www.ibm.com/docs/en/icos/12.10.0?topic=threads-parameter
     {
         if (CPXXgetnumcores(solver->data->env, &solver->data->numcores) != 0) {
             log_fatal("CPXXgetnumcores failed");
@@ -1499,7 +3950,7 @@ bool cplex_setup(Solver *solver, const Instance *instance,
         log_info("%s :: CPXXgetnumcores returned numcores = %d", __func__,
                  solver->data->numcores);
 
-        int32_t num_threads = MIN(MAX_NUM_CORES, solver->data->numcores);
+        int32_t num_threads = solver->data->numcores;
         int32_t user_requested_num_threads =
             solver_params_get_int32(tparams, "NUM_THREADS");
 
@@ -1507,6 +3958,14 @@ bool cplex_setup(Solver *solver, const Instance *instance,
             num_threads = MIN(num_threads, user_requested_num_threads);
         }
 
+        // The warm start runs before the heuristic thread is started
+        solver->data->warm_start_pool.num_threads = num_threads;
+
+        if (solver->data->heur_thread.enabled && num_threads > 1) {
+            // Leave a core to the heuristic thread
+            num_threads -= 1;
+        }
+
         log_info("%s :: Setting the maximum number of threads that CPLEX can "
                  "use to %d",
                  __func__, num_threads);
@@ -1516,6 +3975,15 @@ bool cplex_setup(Solver *solver, const Instance *instance,
                       __func__);
             goto fail;
         }
+
+        CplexCallbackCtx *callback_ctx = solver->data->callback_ctx;
+        callback_ctx->num_threads = num_threads;
+        callback_ctx->thread_local_data =
+            calloc(num_threads, sizeof(*callback_ctx->thread_local_data));
+        if (!callback_ctx->thread_local_data) {
+            log_fatal("%s :: Failed memory allocation", __func__);
+            goto fail;
+        }
     }
 
     if (solver_params_get_bool(tparams, "HEUR_PRICER_MODE")) {
@@ -1541,6 +4009,7 @@ bool cplex_setup(Solver *solver, const Instance *instance,
         // (MIP). It does not have the expected effect when branch and bound
         // is not invoked.
         const double upper_cutoff_value = 0.0;
+        solver->data->upper_cutoff = upper_cutoff_value;
 
         log_info("%s :: Setting UPPER_CUTOFF to %f", __func__,
                  upper_cutoff_value);
@@ -1613,6 +4082,298 @@ fail:
     return false;
 }
 
+/// Only the objective coefficients of the Y variables depend on the profits:
+/// the rows, the user cut pool and the MIP starts fed so far remain valid.
+static bool update_profits(Solver *self, const Instance *instance) {
+    SolverData *data = self->data;
+    const int32_t n = instance->num_customers + 1;
+    bool result = true;
+
+    if (data->presolve.enabled) {
+        // NOTE(dparo):
+        //      The eliminations depend on the profits: the presolved
+        //      instance must be rebuilt from scratch.
+        log_info("%s :: The presolve depends on the profits", __func__);
+        return false;
+    }
+
+    CPXDIM *indices = malloc(n * sizeof(*indices));
+    double *values = malloc(n * sizeof(*values));
+    if (!indices || !values) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        result = false;
+        goto terminate;
+    }
+
+    for (int32_t i = 0; i < n; i++) {
+        indices[i] = mip_var_to_col(data, get_y_mip_var_idx(instance, i));
+        values[i] = -1.0 * profit(instance, i);
+    }
+
+    if (0 != CPXXchgobj(data->env, data->lp, n, indices, values)) {
+        log_fatal("%s :: CPXXchgobj failed", __func__);
+        result = false;
+        goto terminate;
+    }
+
+    // NOTE(dparo):
+    //      The warm start tours, and the tours collected by the pricer, were
+    //      evaluated with the old profits
+    data->warm_start_primal_bound = INFINITY;
+    pricer_clear_tours(data);
+
+    if (data->sparse.enabled &&
+        (size_t)data->sparse.num_cols < data->num_mip_vars) {
+        // NOTE(dparo):
+        //      The edges were pruned according to the old profits. Without
+        //      an up to date pricing, the only safe choice is adding back all
+        //      of them. The thread local buffers are sized on the number of
+        //      columns, and must be recreated.
+        if (!complete_sparse_formulation(self, instance, INFINITY)) {
+            result = false;
+            goto terminate;
+        }
+        destroy_all_callback_thread_local_data(data->callback_ctx);
+    }
+
+    if (data->rcfix.enabled) {
+        if (!undo_reduced_cost_fixing(self) ||
+            !init_reduced_cost_fixing(self, instance, data->upper_cutoff)) {
+            log_fatal("%s :: Failed to redo the reduced cost fixing",
+                      __func__);
+            result = false;
+            goto terminate;
+        }
+    }
+
+terminate:
+    free(indices);
+    free(values);
+    return result;
+}
+
+/// Adds back to the sparse formulation the pruned edges that are forced by
+/// `fixes`
+static bool price_forced_edges(Solver *self, const Instance *instance,
+                               const MipEdgeFix *fixes) {
+    SolverData *data = self->data;
+    SparseEdge *edges = NULL;
+
+    for (ptrdiff_t k = 0; k < arrlen(fixes); k++) {
+        if (fixes[k].fix.fixing == EDGE_FIXING_FORCED &&
+            mip_var_to_col(data, fixes[k].var_idx) < 0) {
+            SparseEdge e = {.i = MIN(fixes[k].fix.i, fixes[k].fix.j),
+                            .j = MAX(fixes[k].fix.i, fixes[k].fix.j)};
+            arrput(edges, e);
+        }
+    }
+
+    bool result = true;
+    if (arrlen(edges) > 0) {
+        result = add_sparse_edges(self, instance, edges, (CPXDIM)arrlen(edges));
+        // NOTE(dparo):
+        //      The thread local buffers are sized on the number of columns.
+        //      The user cuts of the previous solves lack the new columns: they
+        //      are rebuilt by install_user_cuts() before the next solve.
+        destroy_all_callback_thread_local_data(data->callback_ctx);
+    }
+
+    arrfree(edges);
+    return result;
+}
+
+static int cmp_edge_fixes(const void *a, const void *b) {
+    const MipEdgeFix *fa = a;
+    const MipEdgeFix *fb = b;
+    if (fa->var_idx != fb->var_idx) {
+        return fa->var_idx < fb->var_idx ? -1 : 1;
+    }
+    // Latest fixing first
+    return (fa->pos < fb->pos) - (fa->pos > fb->pos);
+}
+
+/// Sorts the `fixings` by X variable, keeping only the last fixing of each
+/// edge. Returns an stb_ds array.
+static MipEdgeFix *sort_edge_fixings(const Instance *instance,
+                                     const EdgeFix *fixings,
+                                     int32_t num_fixings) {
+    MipEdgeFix *fixes = NULL;
+    for (int32_t k = 0; k < num_fixings; k++) {
+        MipEdgeFix f = {
+            .var_idx = get_x_mip_var_idx(instance, fixings[k].i, fixings[k].j),
+            .fix = fixings[k],
+            .pos = k,
+        };
+        arrput(fixes, f);
+    }
+    qsort(fixes, arrlenu(fixes), sizeof(*fixes), cmp_edge_fixes);
+
+    ptrdiff_t len = 0;
+    for (ptrdiff_t k = 0; k < arrlen(fixes); k++) {
+        if (len > 0 && fixes[len - 1].var_idx == fixes[k].var_idx) {
+            if (fixes[len - 1].fix.fixing != fixes[k].fix.fixing) {
+                log_warn("%s :: Conflicting fixings for the edge (%d, %d)",
+                         __func__, fixes[k].fix.i, fixes[k].fix.j);
+            }
+            continue;
+        }
+        fixes[len++] = fixes[k];
+    }
+    arrsetlen(fixes, len);
+    return fixes;
+}
+
+/// Appends to `indices`, `lu` and `bd` the bounds implementing `fixing` on
+/// the X column `col`
+static CPXDIM push_edge_fixing_bounds(CPXDIM *indices, char *lu, double *bd,
+                                      CPXDIM cnt, CPXDIM col,
+                                      EdgeFixing fixing) {
+    indices[cnt] = col;
+    lu[cnt] = 'L';
+    bd[cnt] = fixing == EDGE_FIXING_FORCED ? 1.0 : 0.0;
+    ++cnt;
+    indices[cnt] = col;
+    lu[cnt] = 'U';
+    bd[cnt] = fixing == EDGE_FIXING_FORBIDDEN ? 0.0 : 1.0;
+    ++cnt;
+    return cnt;
+}
+
+/// Applies the edge fixings in place, through the bounds of the X columns.
+/// The fixings previously applied and not listed anymore are undone. Only the
+/// columns whose fixing changed are touched.
+static bool set_edge_fixings(Solver *self, const Instance *instance,
+                             const EdgeFix *fixings, int32_t num_fixings) {
+    SolverData *data = self->data;
+    bool result = true;
+
+    if (data->presolve.enabled) {
+        // NOTE(dparo):
+        //      The presolved model lives in the reduced instance, and some of
+        //      the fixed edges may not exist anymore.
+        log_fatal("%s :: Edge fixings are not supported with the presolve",
+                  __func__);
+        return false;
+    }
+
+    MipEdgeFix *fixes = sort_edge_fixings(instance, fixings, num_fixings);
+    MipEdgeFix *applied = data->edge_fixing.applied;
+    const ptrdiff_t num_fixes = arrlen(fixes);
+    const ptrdiff_t num_applied = arrlen(applied);
+    const size_t max_cnt = 2 * (size_t)(num_fixes + num_applied);
+
+    CPXDIM *indices = malloc(MAX(1, max_cnt) * sizeof(*indices));
+    char *lu = malloc(MAX(1, max_cnt) * sizeof(*lu));
+    double *bd = malloc(MAX(1, max_cnt) * sizeof(*bd));
+    if (!data->edge_fixing.state) {
+        data->edge_fixing.state =
+            calloc(data->num_mip_vars, sizeof(*data->edge_fixing.state));
+    }
+    if (!indices || !lu || !bd || !data->edge_fixing.state) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        result = false;
+        goto terminate;
+    }
+
+    int32_t num_forced = 0;
+    for (ptrdiff_t k = 0; k < num_fixes; k++) {
+        num_forced += fixes[k].fix.fixing == EDGE_FIXING_FORCED;
+    }
+
+    // NOTE(dparo):
+    //      Restore the bounds changed by the reduced cost fixing first: it is
+    //      redone below, once the fixings are in place.
+    if (data->rcfix.enabled && !undo_reduced_cost_fixing(self)) {
+        log_fatal("%s :: Failed to undo the reduced cost fixing", __func__);
+        result = false;
+        goto terminate;
+    }
+
+    if (data->sparse.enabled && !price_forced_edges(self, instance, fixes)) {
+        result = false;
+        goto terminate;
+    }
+
+    // Merge the two lists, both sorted by X variable
+    uint8_t *state = data->edge_fixing.state;
+    CPXDIM cnt = 0;
+    ptrdiff_t a = 0;
+    ptrdiff_t f = 0;
+    while (a < num_applied || f < num_fixes) {
+        size_t var_idx;
+        EdgeFixing fixing;
+        if (f >= num_fixes ||
+            (a < num_applied && applied[a].var_idx < fixes[f].var_idx)) {
+            // No longer fixed
+            var_idx = applied[a++].var_idx;
+            fixing = EDGE_FIXING_NONE;
+        } else {
+            if (a < num_applied && applied[a].var_idx == fixes[f].var_idx) {
+                ++a;
+            }
+            var_idx = fixes[f].var_idx;
+            fixing = fixes[f++].fix.fixing;
+        }
+
+        CPXDIM col = mip_var_to_col(data, var_idx);
+        if (state[var_idx] != fixing && col >= 0) {
+            cnt = push_edge_fixing_bounds(indices, lu, bd, cnt, col, fixing);
+        }
+    }
+
+    if (cnt > 0 &&
+        0 != CPXXchgbds(data->env, data->lp, cnt, indices, lu, bd)) {
+        log_fatal("%s :: CPXXchgbds failed", __func__);
+        result = false;
+        goto terminate;
+    }
+
+    for (ptrdiff_t k = 0; k < num_applied; k++) {
+        state[applied[k].var_idx] = EDGE_FIXING_NONE;
+    }
+    for (ptrdiff_t k = 0; k < num_fixes; k++) {
+        state[fixes[k].var_idx] = (uint8_t)fixes[k].fix.fixing;
+    }
+    arrfree(data->edge_fixing.applied);
+    data->edge_fixing.applied = fixes;
+    data->edge_fixing.num_forced = num_forced;
+    fixes = NULL;
+
+    // NOTE(dparo):
+    //      The shared incumbent may violate the new fixings, too. When this
+    //      solver is a member of a portfolio, every member resets it.
+    if (data->portfolio.shared) {
+        MipSharedIncumbent *shared = data->portfolio.shared;
+        mip_spin_lock(&shared->lock);
+        shared->cost = INFINITY;
+        shared->owner = -1;
+        mip_spin_unlock(&shared->lock);
+    }
+
+    log_info("%s :: %d fixings applied (%d forced edges), %d bounds changed",
+             __func__, num_fixings, num_forced, cnt);
+
+    // NOTE(dparo):
+    //      The warm start tours, and the tours collected by the pricer, may
+    //      violate the new fixings.
+    data->warm_start_primal_bound = INFINITY;
+    pricer_clear_tours(data);
+
+    if (data->rcfix.enabled &&
+        !init_reduced_cost_fixing(self, instance, data->upper_cutoff)) {
+        log_fatal("%s :: Failed to redo the reduced cost fixing", __func__);
+        result = false;
+        goto terminate;
+    }
+
+terminate:
+    arrfree(fixes);
+    free(indices);
+    free(lu);
+    free(bd);
+    return result;
+}
+
 static void mip_solver_destroy(Solver *self) {
 
     if (self->data) {
@@ -1624,6 +4385,42 @@ static void mip_solver_destroy(Solver *self) {
             CPXXcloseCPLEX(&self->data->env);
         }
 
+        for (ptrdiff_t i = 0;
+             i < arrlen(self->data->sparse.deferred_warm_starts); i++) {
+            tour_destroy(&self->data->sparse.deferred_warm_starts[i]);
+        }
+        arrfree(self->data->sparse.deferred_warm_starts);
+        arrfree(self->data->warm_start_pool.beg);
+        arrfree(self->data->warm_start_pool.ind);
+        arrfree(self->data->warm_start_pool.val);
+        cut_pool_destroy(&self->data->user_cuts);
+        free(self->data->sparse.var_to_col);
+        arrfree(self->data->sparse.col_to_var);
+        free(self->data->sparse.duals);
+        free(self->data->rcfix.dj);
+        free(self->data->rcfix.fixed_cols);
+        free(self->data->rcfix.is_fixed);
+        for (int32_t dir = 0; dir < 2; dir++) {
+            free(self->data->branching.pc_sum[dir]);
+            free(self->data->branching.pc_cnt[dir]);
+        }
+        hmfree(self->data->branching.pending);
+
+        pricer_clear_tours(self->data);
+        instance_presolve_destroy(&self->data->presolve.ps);
+        free(self->data->edge_fixing.state);
+        arrfree(self->data->edge_fixing.applied);
+        free(self->data->portfolio.cols);
+        free(self->data->portfolio.vstar);
+        tour_destroy(&self->data->portfolio.tour);
+        tour_destroy(&self->data->heur_thread.slot.tour);
+
+        if (self->data->callback_ctx) {
+            destroy_all_callback_thread_local_data(self->data->callback_ctx);
+            free(self->data->callback_ctx->thread_local_data);
+            free(self->data->callback_ctx);
+        }
+
         free(self->data);
     }
 
@@ -1636,14 +4433,52 @@ Solver mip_solver_create(const Instance *instance, SolverTypedParams *tparams,
     UNUSED_PARAM(tparams);
     log_trace("%s", __func__);
 
+    const int32_t portfolio_size =
+        solver_params_get_int32(tparams, "PORTFOLIO_SIZE");
+    if (portfolio_size > 1) {
+        return mip_portfolio_create(instance, tparams, timelimit, randomseed,
+                                    portfolio_size);
+    }
+
     Solver solver = {0};
     solver.solve = solve;
+    solver.update_profits = update_profits;
+    solver.set_edge_fixings = set_edge_fixings;
     solver.destroy = mip_solver_destroy;
     solver.data = calloc(1, sizeof(*solver.data));
     if (!solver.data) {
         goto fail;
     }
 
+    solver.data->warm_start_primal_bound = INFINITY;
+    solver.data->rcfix.primal_bound = INFINITY;
+    solver.data->upper_cutoff = INFINITY;
+    atomic_flag_clear(&solver.data->pricer.lock);
+    atomic_flag_clear(&solver.data->branching.lock);
+    atomic_flag_clear(&solver.data->heur_thread.slot.lock);
+    solver.data->heur_thread.rng_state =
+        ((uint64_t)(uint32_t)randomseed << 1) | 1;
+    solver.data->callback_ctx = calloc(1, sizeof(*solver.data->callback_ctx));
+    if (!solver.data->callback_ctx) {
+        goto fail;
+    }
+
+    if (solver_params_get_bool(tparams, "PRESOLVE")) {
+        int64_t begin_time = os_get_usecs();
+        if (!presolve_instance(&solver, instance, tparams)) {
+            log_fatal("%s : Failed to presolve the instance", __func__);
+            goto fail;
+        }
+        timelimit -= (double)(os_get_usecs() - begin_time) * USECS_TO_SECS;
+
+        // NOTE(dparo):
+        //      From now on the model is built upon the presolved instance.
+        //      solve() maps the solutions back to the original one.
+        if (solver.data->presolve.enabled) {
+            instance = &solver.data->presolve.ps.reduced;
+        }
+    }
+
     if (!cplex_setup(&solver, instance, tparams, timelimit, randomseed)) {
         log_fatal("%s : Failed to initialize cplex", __func__);
         goto fail;
@@ -1654,13 +4489,34 @@ Solver mip_solver_create(const Instance *instance, SolverTypedParams *tparams,
         goto fail;
     }
 
-    solver.data->num_mip_vars =
-        CPXXgetnumcols(solver.data->env, solver.data->lp);
+    assert(solver.data->sparse.enabled ||
+           solver.data->num_mip_vars ==
+               (size_t)CPXXgetnumcols(solver.data->env, solver.data->lp));
     solver.data->num_mip_constraints =
         CPXXgetnumrows(solver.data->env, solver.data->lp);
 
+    if (solver.data->sparse.enabled) {
+        if (!price_sparse_formulation(&solver, instance)) {
+            log_fatal("%s : Failed to price the sparse formulation", __func__);
+            goto fail;
+        }
+    }
+
     // WARM start
     if (solver_params_get_bool(tparams, "INS_HEUR_WARM_START")) {
+        double fraction =
+            solver_params_get_double(tparams, "WARM_START_TIME_FRACTION");
+        double max_time =
+            solver_params_get_double(tparams, "WARM_START_MAX_TIME");
+        solver.data->warm_start_pool.time_budget =
+            fraction > 0.0 ? fraction * timelimit : INFINITY;
+        if (max_time > 0.0) {
+            solver.data->warm_start_pool.time_budget =
+                MIN(solver.data->warm_start_pool.time_budget, max_time);
+        }
+        solver.data->warm_start_pool.det_budget =
+            fraction > 0.0 ? fraction * solver.data->det.timelimit : 0.0;
+
         int64_t begin_time = os_get_usecs();
         if (!mip_ins_heur_warm_start(&solver, instance,
                                      solver.data->heur_pricer_mode)) {
@@ -1692,6 +4548,68 @@ Solver mip_solver_create(const Instance *instance, SolverTypedParams *tparams,
         }
     }
 
+    // NOTE(dparo):
+    //      Solutions not cheaper than the warm start tours (or not below
+    //      the upper cutoff, see interesting_primal_bound()) are not
+    //      interesting. The sparse formulation and the reduced cost fixing
+    //      can drop the variables that cannot take part in any interesting
+    //      solution.
+    double primal_bound = interesting_primal_bound(
+        solver.data, solver.data->warm_start_primal_bound);
+
+    if (solver.data->sparse.enabled) {
+        if (!complete_sparse_formulation(&solver, instance, primal_bound) ||
+            !finalize_sparse_formulation(&solver) ||
+            !mip_flush_deferred_warm_starts(&solver, instance)) {
+            log_fatal("%s : Failed to finalize the sparse formulation",
+                      __func__);
+            goto fail;
+        }
+
+        log_info("%s :: sparse formulation has %d columns out of %zu",
+                 __func__, solver.data->sparse.num_cols,
+                 solver.data->num_mip_vars);
+    }
+
+    // NOTE(dparo):
+    //      Fixed after the sparse formulation is finalized, since its pricing
+    //      may add the forbidden edges back.
+    if (solver.data->presolve.enabled &&
+        !fix_presolve_forbidden_edges(&solver, instance)) {
+        log_fatal("%s : Failed to fix the presolve forbidden edges", __func__);
+        goto fail;
+    }
+
+    if (solver.data->rcfix.enabled) {
+        int64_t begin_time = os_get_usecs();
+        if (!init_reduced_cost_fixing(&solver, instance, primal_bound)) {
+            log_fatal("%s : Failed to initialize the reduced cost fixing",
+                      __func__);
+            goto fail;
+        }
+        double diff_secs =
+            (double)(os_get_usecs() - begin_time) * USECS_TO_SECS;
+        log_info("%s :: init_reduced_cost_fixing took %f secs", __func__,
+                 diff_secs);
+        timelimit = timelimit - diff_secs;
+    }
+
+    if (solver.data->heur_thread.enabled) {
+        // NOTE(dparo):
+        //      Outside of a portfolio, the incumbents are exchanged with the
+        //      heuristic thread through a private slot. mip_join_portfolio()
+        //      replaces it with the one of the portfolio.
+        MipSharedIncumbent *slot = &solver.data->heur_thread.slot;
+        slot->cost = INFINITY;
+        slot->owner = -1;
+        slot->tour = tour_create(instance);
+        if (!tour_is_valid(&slot->tour) ||
+            !attach_shared_incumbent(&solver, instance, slot, 0)) {
+            log_fatal("%s : Failed to setup the heuristic thread", __func__);
+            goto fail;
+        }
+    }
+
     log_info("%s :: CPXXsetdblparam -- Setting TIMELIMIT to %f", __func__,
              timelimit);
     if (CPXXsetdblparam(solver.data->env, CPX_PARAM_TILIM, timelimit) != 0) {
@@ -1701,6 +4619,24 @@ Solver mip_solver_create(const Instance *instance, SolverTypedParams *tparams,
         goto fail;
     }
 
+    if (solver.data->det.timelimit > 0.0) {
+        // NOTE(dparo):
+        //      As for the wall clock time limit, the work spent building the
+        //      model and warm starting it is charged to the budget.
+        double spent = peek_det_ticks(solver.data);
+        double det_timelimit = MAX(0.0, solver.data->det.timelimit - spent);
+        log_info("%s :: CPXXsetdblparam -- Setting DETTILIM to %f (%f ticks "
+                 "already spent)",
+                 __func__, det_timelimit, spent);
+        if (CPXXsetdblparam(solver.data->env, CPX_PARAM_DETTILIM,
+                            det_timelimit) != 0) {
+            log_fatal("%s :: CPXXsetdbparam -- Failed to setup "
+                      "CPX_PARAM_DETTILIM to value %f",
+                      __func__, det_timelimit);
+            goto fail;
+        }
+    }
+
     return solver;
 
 fail:
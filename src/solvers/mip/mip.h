@@ -30,6 +30,9 @@ extern "C" {
 #include "core.h"
 #include "core-utils.h"
 #include "maxflow.h"
+#include "presolve.h"
+#include <stdatomic.h>
+#include <pthread.h>
 
 #ifdef COMPILED_WITH_CPLEX
 
@@ -39,8 +42,86 @@ extern "C" {
 #include <ilcplex/cplexx.h>
 #include <ilcplex/cpxconst.h>
 
+/// The MIP formulation does not accept tours visiting less than 3 nodes
+#define MIP_MIN_NUM_VISITED 3
+
+/// Number of our own deterministic work units (see mip_add_work()) making up
+/// a CPLEX deterministic tick
+#define MIP_WORK_UNITS_PER_TICK (1000000.0)
+
+/// Maximum length (including the NUL terminator) of the optional row/column
+/// names (eg `x(1024,2048)`) that are attached to the MIP model.
+#define MIP_NAME_MAX_LEN 32
+
 struct CutSeparationPrivCtx;
 typedef struct CutSeparationPrivCtx CutSeparationPrivCtx;
+struct CplexCallbackCtx;
+
+/// Owner of the shared incumbents published by the heuristic thread (see the
+/// `HEUR_THREAD` param)
+#define MIP_SHARED_OWNER_HEURISTIC (-2)
+
+/// Best incumbent found among the members of a portfolio (see the
+/// `PORTFOLIO_SIZE` param) and by the heuristic thread, from which the other
+/// members import it
+typedef struct MipSharedIncumbent {
+    /// Guards `cost`, `tour` and `owner`
+    atomic_flag lock;
+    /// Bumped at every improvement of the incumbent
+    _Atomic int64_t version;
+    double cost;
+    Tour tour;
+    /// Member which published the incumbent, or MIP_SHARED_OWNER_HEURISTIC
+    int32_t owner;
+} MipSharedIncumbent;
+
+typedef enum {
+    /// Let CPLEX take all the branching decisions
+    BRANCHING_STRATEGY_CPLEX = 0,
+    /// Branch on the number of visited customers, sum(y) <= floor or
+    /// sum(y) >= ceil, when it is fractional
+    BRANCHING_STRATEGY_CARDINALITY = 1,
+    /// Branch on the fractional Y variable having the best pseudo-cost score
+    BRANCHING_STRATEGY_PSEUDOCOST = 2,
+    /// Cardinality branching first, then pseudo-cost branching
+    BRANCHING_STRATEGY_CARDINALITY_PSEUDOCOST = 3,
+} BranchingStrategy;
+
+/// A branching on a Y variable, whose child node is still waiting to be
+/// processed. Used for updating the pseudo-costs.
+typedef struct {
+    int32_t node;
+    /// 0 for the down branch, 1 for the up branch
+    int32_t dir;
+    double parent_obj;
+    /// Change of the branching variable w.r.t. the parent relaxation point
+    double delta;
+} PendingBranch;
+
+typedef struct {
+    CPXLONG key;
+    PendingBranch value;
+} PendingBranchEntry;
+
+/// An edge fixing applied to the model. See SolverData::edge_fixing.
+typedef struct {
+    size_t var_idx;
+    EdgeFix fix;
+    /// Position in the list given to Solver::set_edge_fixings
+    int32_t pos;
+} MipEdgeFix;
+
+/// Globally valid cuts separated during a solve, expressed in terms of MIP
+/// variables (see get_x_mip_var_idx() and get_y_mip_var_idx()). They are
+/// mapped to the CPLEX columns only when submitted: the columns of a sparse
+/// formulation change between the solves. (stb_ds arrays)
+typedef struct {
+    double *rhs;
+    char *sense;
+    CPXNNZ *rmatbeg;
+    CPXDIM *rmatind;
+    double *rmatval;
+} CutPool;
 
 typedef struct SolverData {
     int64_t begin_time;
@@ -48,10 +129,220 @@ typedef struct SolverData {
     CPXLPptr lp;
     int numcores;
     bool heur_pricer_mode;
-    CPXDIM num_mip_vars;
+    size_t num_mip_vars;
     CPXDIM num_mip_constraints;
     bool fractional_separation_enabled;
     bool amortized_fractional_labeling;
+    bool var_names;
+    /// The model is built upon the presolved instance, when enabled. See the
+    /// `PRESOLVE` param.
+    struct {
+        bool enabled;
+        InstancePresolve ps;
+    } presolve;
+    /// Relaxation only solve: a cutting plane loop over the LP relaxation,
+    /// without any branching. See the `LP_BOUND_MODE` param.
+    struct {
+        bool enabled;
+        int32_t max_rounds;
+    } lp_bound;
+    /// See the `RELAXATION_HEUR_FREQ` param. 0 if disabled.
+    int32_t relax_heur_freq;
+    /// Incumbent improving tours found by the relaxation heuristic, over all
+    /// the solves
+    _Atomic int64_t relax_heur_num_posted;
+    /// See the `LIN_KERNIGHAN` param.
+    bool lin_kernighan;
+    /// Deterministic time accounting. See the `DET_TIMELIMIT` param.
+    struct {
+        /// Limit in ticks, or 0 if only the wall clock time limit applies
+        double timelimit;
+        /// CPLEX deterministic time stamp (CPXXgetdettime) taken at the
+        /// creation of the solver, and at the end of every solve
+        double last_stamp;
+        /// Work spent by our own phases since `last_stamp`
+        _Atomic int64_t work_units;
+    } det;
+    /// Value of the upper cutoff (CPX_PARAM_CUTUP), or INFINITY if not
+    /// applied. See the `APPLY_UPPER_CUTOFF` param.
+    double upper_cutoff;
+
+    /// Cuts separated by the previous solves of a persistent solver. They are
+    /// installed in the CPLEX user cut pool at the start of every solve.
+    CutPool user_cuts;
+
+    /// Generic callback state, which outlives a single solve when the solver
+    /// is persistent (see Solver::persistent)
+    struct CplexCallbackCtx *callback_ctx;
+
+    /// Custom branching. See the `BRANCHING_STRATEGY` param.
+    struct {
+        BranchingStrategy strategy;
+        /// Branchings created by the cardinality and by the pseudo-cost
+        /// rules, over all the solves
+        _Atomic int64_t num_cardinality_branches;
+        _Atomic int64_t num_pseudocost_branches;
+        /// Guards the fields below, which are updated from concurrent
+        /// branching callbacks
+        atomic_flag lock;
+        /// Sum and number of observations of the per unit objective change of
+        /// each Y variable, for the down (index 0) and up (index 1) branches.
+        /// They are kept across the solves of a persistent solver.
+        double *pc_sum[2];
+        int64_t *pc_cnt[2];
+        /// Keyed by the unique id of the child node (stb_ds hashmap). An
+        /// entry is dropped as soon as its node is processed or pruned.
+        PendingBranchEntry *pending;
+        /// Incumbent value the pending branches were last pruned against
+        double pruned_bound;
+    } branching;
+
+    /// Best distinct negative reduced cost tours found during a solve. See
+    /// the `PRICER_NUM_TOURS` param and mip_pricer_collect_tour().
+    struct {
+        int32_t num_tours;
+        /// Guards `tours` and `costs`, which are written from concurrent
+        /// candidate callbacks
+        atomic_flag lock;
+        /// Sorted by increasing cost (stb_ds arrays)
+        Tour *tours;
+        double *costs;
+    } pricer;
+
+    /// Best (lowest) objective value among the warm start solutions fed to
+    /// CPLEX, or INFINITY if none was fed.
+    double warm_start_primal_bound;
+
+    /// Distinct warm start tours, encoded as sparse MIP starts, waiting to
+    /// be submitted to CPLEX with a single CPXXaddmipstarts() call. See
+    /// mip_flush_warm_start_pool() and the `WARM_START_EFFORT` param.
+    struct {
+        /// CPX_MIPSTART_* effort level
+        int effort;
+        /// Max number of tours fed by mip_ins_heur_warm_start()
+        int32_t num_tours;
+        /// Number of threads running the multi-start insertion heuristic
+        int32_t num_threads;
+        /// Wall clock budget (secs) of mip_ins_heur_warm_start(), or
+        /// INFINITY if unbounded
+        double time_budget;
+        /// Deterministic budget (ticks) of mip_ins_heur_warm_start(), or
+        /// 0 if unbounded. When given, the wall clock budget is ignored.
+        double det_budget;
+        /// Rounds of starts run, starts run, and distinct tours fed by the
+        /// last mip_ins_heur_warm_start()
+        int32_t num_rounds;
+        int32_t num_starts;
+        int32_t num_fed;
+        /// Layout expected by CPXXaddmipstarts() (stb_ds arrays)
+        CPXNNZ *beg;
+        CPXDIM *ind;
+        double *val;
+    } warm_start_pool;
+
+    /// Concurrent portfolio of MIP solvers. See the `PORTFOLIO_SIZE` param.
+    struct {
+        /// Members, when this solver is the portfolio itself
+        int32_t num_members;
+        struct Solver *members;
+        /// Incumbent shared among the members. NULL if this solver is not a
+        /// member of a portfolio, or if it does not share its incumbents.
+        MipSharedIncumbent *shared;
+        int32_t member_id;
+        /// Last `shared->version` imported by this member
+        _Atomic int64_t seen_version;
+        /// Buffers used for publishing the incumbent, from the (serialized)
+        /// global progress callback
+        double *cols;
+        double *vstar;
+        Tour tour;
+    } portfolio;
+
+    /// Iterated local search run concurrently with the Branch&Cut. See the
+    /// `HEUR_THREAD` param and heur-thread.h.
+    struct {
+        bool enabled;
+        /// Incumbent slot shared with the callbacks, when this solver is not
+        /// a member of a portfolio (which provides its own)
+        MipSharedIncumbent slot;
+        pthread_t thread;
+        bool running;
+        _Atomic bool stop;
+        uint64_t rng_state;
+        const Instance *instance;
+        /// Iterations run, and tours published into the shared incumbent
+        /// slot, by the last run of the thread
+        int64_t num_iters;
+        int64_t num_published;
+    } heur_thread;
+
+    /// Edges fixed by the branching decisions of a branch and price master.
+    /// See Solver::set_edge_fixings.
+    struct {
+        /// EdgeFixing of each X variable. NULL until the first fixing.
+        /// Has `num_mip_vars` entries
+        uint8_t *state;
+        /// The fixings in `state`, one per edge, sorted by X variable
+        /// (stb_ds array)
+        MipEdgeFix *applied;
+        int32_t num_forced;
+    } edge_fixing;
+
+    /// Sparse (edge pruned) formulation. See the `SPARSE_FORMULATION_KNN`
+    /// param. MIP variables are always indexed according to the complete
+    /// formulation (see get_x_mip_var_idx() and get_y_mip_var_idx()): this
+    /// struct holds the mapping between the complete variable index and the
+    /// CPLEX columns that are actually part of the LP.
+    /// NOTE(dparo):
+    ///      Only the LP is sparse. `var_to_col`, the fractional point of each
+    ///      thread and the separation networks still take O(n^2) memory, and
+    ///      each pricing round scans every pruned edge: the solver memory is
+    ///      not bounded by the number of columns.
+    struct {
+        bool enabled;
+        /// Number of nearest neighbours used for selecting the initial edges
+        int32_t knn;
+        /// Set to true once the pricing phase is over and the LP is converted
+        /// to a MIP.
+        bool finalized;
+        /// For each MIP variable the associated CPLEX column, or -1 if the
+        /// variable is pruned from the formulation. Has `num_mip_vars` entries
+        CPXDIM *var_to_col;
+        /// Inverse mapping of `var_to_col`. Has `num_cols` entries
+        /// (stb_ds array)
+        size_t *col_to_var;
+        CPXDIM num_cols;
+        /// Duals of the degree constraints found by the last pricing round
+        double *duals;
+        /// Lagrangian lower bound computed from the `duals`
+        double lagrangian_bound;
+        /// Warm start tours collected while the formulation is not finalized
+        /// yet. (stb_ds array)
+        Tour *deferred_warm_starts;
+    } sparse;
+
+    /// Reduced cost fixing. See the `REDUCED_COST_FIXING` param.
+    /// Columns are fixed to zero when the reduced cost computed from the root
+    /// LP relaxation exceeds the gap between the incumbent and the root bound.
+    struct {
+        bool enabled;
+        /// Objective value of the root LP relaxation, with the cuts
+        double root_bound;
+        /// Reduced costs of the root LP relaxation. Has `mip_num_cols()`
+        /// entries
+        double *dj;
+        /// Primal bound used by the last fixing pass
+        double primal_bound;
+        /// Fixed columns, in the order they were fixed. The first
+        /// `num_presolve_fixed` ones are fixed (CPXXchgbds) before the
+        /// branch and cut starts, the others are only dropped from the
+        /// separation networks. Has `mip_num_cols()` capacity
+        CPXDIM *fixed_cols;
+        CPXDIM num_fixed;
+        CPXDIM num_presolve_fixed;
+        /// Non zero for the columns listed in `fixed_cols`
+        uint8_t *is_fixed;
+    } rcfix;
 } SolverData;
 
 struct CutSeparationIface;
@@ -70,6 +361,12 @@ typedef struct {
     /// User cuts should not bother modifying and/or reading these fields.
     struct {
         CPXCALLBACKCONTEXTptr cplex_cb_ctx;
+        /// Scratch buffers used for translating the cuts to CPLEX column
+        /// indices when the sparse formulation is enabled
+        CPXDIM *col_index;
+        double *col_value;
+        /// Where to record the separated cuts. NULL if not needed
+        CutPool *cut_pool;
         CutSeparationStatistics fractional_stats;
         CutSeparationStatistics integral_stats;
     } internal;
@@ -137,12 +434,129 @@ static inline size_t get_y_mip_var_idx(const Instance *instance, int32_t i) {
     return (size_t)i + get_y_mip_var_idx_offset(instance);
 }
 
+/// Returns the CPLEX column associated to the MIP variable `var_idx`, or -1
+/// if the variable is pruned away from the (sparse) formulation.
+static inline CPXDIM mip_var_to_col(const SolverData *data, size_t var_idx) {
+    if (data->sparse.enabled) {
+        return data->sparse.var_to_col[var_idx];
+    }
+    return (CPXDIM)var_idx;
+}
+
+/// Number of CPLEX columns actually present in the LP.
+static inline CPXDIM mip_num_cols(const SolverData *data) {
+    return data->sparse.enabled ? data->sparse.num_cols
+                                : (CPXDIM)data->num_mip_vars;
+}
+
+/// Scatters the values of the CPLEX columns `cols` into the complete MIP
+/// variable vector `vstar`. Pruned variables are set to zero.
+static inline void mip_scatter_cols(const SolverData *data, const double *cols,
+                                    double *vstar) {
+    assert(data->sparse.enabled);
+    memset(vstar, 0, data->num_mip_vars * sizeof(*vstar));
+    for (CPXDIM c = 0; c < data->sparse.num_cols; c++) {
+        vstar[data->sparse.col_to_var[c]] = cols[c];
+    }
+}
+
+/// Rewrites the cut (expressed in terms of MIP variables) in terms of CPLEX
+/// columns. Pruned variables are dropped: they are not part of the LP, which
+/// is equivalent to them being fixed to zero.
+static inline CPXNNZ mip_cut_to_cols(CutSeparationFunctor *ctx, CPXNNZ nnz,
+                                     CPXDIM **index, double **value) {
+    const SolverData *data = ctx->solver->data;
+    if (!data->sparse.enabled) {
+        return nnz;
+    }
+
+    CPXNNZ cnt = 0;
+    for (CPXNNZ k = 0; k < nnz; k++) {
+        CPXDIM col = data->sparse.var_to_col[(*index)[k]];
+        if (col >= 0) {
+            ctx->internal.col_index[cnt] = col;
+            ctx->internal.col_value[cnt] = (*value)[k];
+            ++cnt;
+        }
+    }
+
+    *index = ctx->internal.col_index;
+    *value = ctx->internal.col_value;
+    return cnt;
+}
+
+/// Accounts `units` of deterministic work (eg distance evaluations or arc
+/// scans) done by our own code, which CPLEX does not measure.
+static inline void mip_add_work(SolverData *data, int64_t units) {
+    atomic_fetch_add_explicit(&data->det.work_units, units,
+                              memory_order_relaxed);
+}
+
+static inline void mip_spin_lock(atomic_flag *lock) {
+    while (atomic_flag_test_and_set(lock)) {
+        // Spin. Only used for short, seldom contended, critical sections
+    }
+}
+
+static inline void mip_spin_unlock(atomic_flag *lock) {
+    atomic_flag_clear(lock);
+}
+
+static inline void cut_pool_push(CutPool *pool, CPXNNZ nnz, double rhs,
+                                 char sense, const CPXDIM *index,
+                                 const double *value) {
+    arrput(pool->rmatbeg, (CPXNNZ)arrlen(pool->rmatind));
+    arrput(pool->rhs, rhs);
+    arrput(pool->sense, sense);
+    for (CPXNNZ k = 0; k < nnz; k++) {
+        arrput(pool->rmatind, index[k]);
+        arrput(pool->rmatval, value[k]);
+    }
+}
+
+static inline void cut_pool_append(CutPool *dest, const CutPool *src) {
+    for (ptrdiff_t r = 0; r < arrlen(src->rhs); r++) {
+        CPXNNZ beg = src->rmatbeg[r];
+        CPXNNZ end = r + 1 < arrlen(src->rhs) ? src->rmatbeg[r + 1]
+                                              : (CPXNNZ)arrlen(src->rmatind);
+        cut_pool_push(dest, end - beg, src->rhs[r], src->sense[r],
+                      &src->rmatind[beg], &src->rmatval[beg]);
+    }
+}
+
+static inline void cut_pool_clear(CutPool *pool) {
+    arrsetlen(pool->rhs, 0);
+    arrsetlen(pool->sense, 0);
+    arrsetlen(pool->rmatbeg, 0);
+    arrsetlen(pool->rmatind, 0);
+    arrsetlen(pool->rmatval, 0);
+}
+
+static inline void cut_pool_destroy(CutPool *pool) {
+    arrfree(pool->rhs);
+    arrfree(pool->sense);
+    arrfree(pool->rmatbeg);
+    arrfree(pool->rmatind);
+    arrfree(pool->rmatval);
+    memset(pool, 0, sizeof(*pool));
+}
+
 static inline bool mip_cut_integral_sol(CutSeparationFunctor *ctx, CPXNNZ nnz,
                                         double rhs, char sense, CPXDIM *index,
                                         double *value) {
     CPXNNZ rmatbeg[] = {0};
     ctx->internal.integral_stats.num_cuts += 1;
 
+    if (ctx->internal.cut_pool) {
+        cut_pool_push(ctx->internal.cut_pool, nnz, rhs, sense, index, value);
+    }
+    nnz = mip_cut_to_cols(ctx, nnz, &index, &value);
+
+    if (!ctx->internal.cplex_cb_ctx) {
+        // Separation driven by our own cutting plane loop
+        return true;
+    }
+
     // NOTE::
     //      https://www.ibm.com/docs/en/icos/12.10.0?topic=c-cpxxcallbackrejectcandidate-cpxcallbackrejectcandidate
     //  You can call this routine more than once in the same
@@ -164,6 +578,16 @@ static inline bool mip_cut_fractional_sol(CutSeparationFunctor *ctx, CPXNNZ nnz,
     CPXNNZ rmatbeg[] = {0};
     ctx->internal.fractional_stats.num_cuts += 1;
 
+    if (ctx->internal.cut_pool && local_validity == 0) {
+        cut_pool_push(ctx->internal.cut_pool, nnz, rhs, sense, index, value);
+    }
+    nnz = mip_cut_to_cols(ctx, nnz, &index, &value);
+
+    if (!ctx->internal.cplex_cb_ctx) {
+        // Separation driven by our own cutting plane loop
+        return true;
+    }
+
     // NOTE::
     //      https://www.ibm.com/docs/en/icos/12.9.0?topic=c-cpxxcallbackaddusercuts-cpxcallbackaddusercuts
     //  You can call this routine more than once in the same
@@ -181,7 +605,23 @@ static inline bool mip_cut_fractional_sol(CutSeparationFunctor *ctx, CPXNNZ nnz,
     return true;
 }
 
+static inline EdgeFixing mip_edge_fixing(const SolverData *data,
+                                         const Instance *instance, int32_t i,
+                                         int32_t j) {
+    if (!data->edge_fixing.state) {
+        return EDGE_FIXING_NONE;
+    }
+    return (EdgeFixing)
+        data->edge_fixing.state[get_x_mip_var_idx(instance, i, j)];
+}
+
 void unpack_mip_solution(const Instance *instance, Tour *t, double *vstar);
+bool mip_tour_respects_edge_fixings(const SolverData *data,
+                                    const Instance *instance,
+                                    const Tour *tour);
+CPXDIM mip_rcfix_num_published(const SolverData *data);
+void mip_pricer_collect_tour(SolverData *data, const Tour *tour, double cost);
+bool mip_pricer_is_done(SolverData *data, double primal_bound);
 
 #endif
 
@@ -0,0 +1,413 @@
+/*
+ * Copyright (c) 2022 Davide Paro
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "portfolio.h"
+#include <pthread.h>
+#include "log.h"
+#include "solvers.h"
+
+/// How often the portfolio checks for terminated members
+#define PORTFOLIO_POLL_USECS (INT64_C(10000))
+
+/// Number of member profiles, see apply_member_profile()
+#define NUM_MEMBER_PROFILES 4
+
+/// Frequency of the relaxation heuristic in the profiles enabling it
+#define PROFILE_RELAXATION_HEUR_FREQ 10
+
+typedef struct {
+    Solver *member;
+    const Instance *instance;
+    int64_t begin_time;
+    Solution solution;
+    SolveStatus status;
+    _Atomic bool done;
+} PortfolioJob;
+
+static void set_param(SolverTypedParams *tparams, char *key, TypedParam value) {
+    value.count = 1;
+    shput(tparams->entries, key, value);
+}
+
+static void set_int32_param(SolverTypedParams *tparams, char *key,
+                            int32_t value) {
+    TypedParam p = {0};
+    p.type = TYPED_PARAM_INT32;
+    p.ival = value;
+    set_param(tparams, key, p);
+}
+
+static void set_bool_param(SolverTypedParams *tparams, char *key, bool value) {
+    TypedParam p = {0};
+    p.type = TYPED_PARAM_BOOL;
+    p.bval = value;
+    set_param(tparams, key, p);
+}
+
+static void copy_params(SolverTypedParams *src, SolverTypedParams *dest) {
+    for (ptrdiff_t i = 0; i < shlen(src->entries); i++) {
+        shput(dest->entries, src->entries[i].key, src->entries[i].value);
+    }
+}
+
+/// Varies the search settings of the member `member_id`, on top of its random
+/// seed. Member 0 keeps the user supplied settings.
+static void apply_member_profile(SolverTypedParams *tparams,
+                                 int32_t member_id) {
+    // NOTE(dparo):
+    //      The enabled cut families are global to the process (see
+    //      enable_cuts()), and therefore are shared by all the members. The
+    //      profiles vary how often the fractional points are separated, the
+    //      branching strategy and the relaxation heuristic instead.
+    const bool amortized =
+        solver_params_get_bool(tparams, "AMORTIZED_FRACTIONAL_LABELING");
+
+    switch (member_id % NUM_MEMBER_PROFILES) {
+    case 1:
+        set_bool_param(tparams, "AMORTIZED_FRACTIONAL_LABELING", !amortized);
+        break;
+    case 2:
+        set_int32_param(tparams, "BRANCHING_STRATEGY",
+                        BRANCHING_STRATEGY_CARDINALITY_PSEUDOCOST);
+        break;
+    case 3:
+        set_bool_param(tparams, "AMORTIZED_FRACTIONAL_LABELING", !amortized);
+        set_int32_param(tparams, "RELAXATION_HEUR_FREQ",
+                        PROFILE_RELAXATION_HEUR_FREQ);
+        break;
+    default:
+        break;
+    }
+}
+
+static int32_t get_num_cores(void) {
+    int status = 0;
+    int numcores = 1;
+    CPXENVptr env = CPXXopenCPLEX(&status);
+    if (status != 0 || !env) {
+        log_warn("%s :: CPXXopenCPLEX failed", __func__);
+        return 1;
+    }
+    if (CPXXgetnumcores(env, &numcores) != 0) {
+        log_warn("%s :: CPXXgetnumcores failed", __func__);
+        numcores = 1;
+    }
+    CPXXcloseCPLEX(&env);
+    return MAX(1, numcores);
+}
+
+/// Formats the CPX_PARAM_CPUMASK hexadecimal mask of the cores in [lo, hi)
+static void format_cpu_mask(char *buf, size_t size, int32_t lo, int32_t hi) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    const int32_t num_digits = MIN((int32_t)size - 1, (hi + 3) / 4);
+
+    for (int32_t d = 0; d < num_digits; d++) {
+        int32_t nibble = 0;
+        for (int32_t b = 0; b < 4; b++) {
+            int32_t core = 4 * d + b;
+            if (core >= lo && core < hi) {
+                nibble |= 1 << b;
+            }
+        }
+        buf[num_digits - 1 - d] = HEX_DIGITS[nibble];
+    }
+    buf[num_digits] = '\0';
+}
+
+static void terminate_members(Solver *self) {
+    SolverData *data = self->data;
+    for (int32_t k = 0; k < data->portfolio.num_members; k++) {
+        data->portfolio.members[k].sigterm_occured = true;
+        data->portfolio.members[k].sigterm_occured_int = 1;
+    }
+}
+
+static void *portfolio_job_main(void *arg) {
+    PortfolioJob *job = arg;
+    job->status = job->member->solve(job->member, job->instance,
+                                     &job->solution, job->begin_time);
+    atomic_store(&job->done, true);
+    return NULL;
+}
+
+/// Moves into `solution` the best tour found by the members, together with the
+/// best dual bound. The status is the one of the `winner`, the first member
+/// terminating without errors.
+static SolveStatus merge_member_solutions(PortfolioJob *jobs,
+                                          int32_t num_jobs, int32_t winner,
+                                          Solution *solution) {
+    int32_t best = -1;
+    double dual_bound = -INFINITY;
+    double det_ticks = 0.0;
+
+    for (int32_t k = 0; k < num_jobs; k++) {
+        // NOTE(dparo): The work of the members adds up, as for CPU time
+        det_ticks += MAX(0.0, jobs[k].solution.det_ticks);
+
+        SolveStatus st = jobs[k].status;
+        if (st == SOLVE_STATUS_NULL || BOOL(st & SOLVE_STATUS_ERR)) {
+            continue;
+        }
+        dual_bound = MAX(dual_bound, jobs[k].solution.dual_bound);
+        if (BOOL(st & SOLVE_STATUS_PRIMAL_SOLUTION_AVAIL) &&
+            (best < 0 || jobs[k].solution.primal_bound <
+                             jobs[best].solution.primal_bound)) {
+            best = k;
+        }
+    }
+
+    SolveStatus status = jobs[winner].status;
+    int32_t chosen = best >= 0 ? best : winner;
+
+    Solution tmp = *solution;
+    *solution = jobs[chosen].solution;
+    jobs[chosen].solution = tmp;
+
+    if (best >= 0) {
+        status |= SOLVE_STATUS_PRIMAL_SOLUTION_AVAIL;
+        dual_bound = MIN(dual_bound, solution->primal_bound);
+    }
+    solution->dual_bound = dual_bound;
+    solution->det_ticks = det_ticks;
+
+    log_info("%s :: member %d terminated first, best tour from member %d: "
+             "cost = [%f, %f]",
+             __func__, winner, chosen, solution->dual_bound,
+             solution->primal_bound);
+    return status;
+}
+
+static SolveStatus portfolio_solve(Solver *self, const Instance *instance,
+                                   Solution *solution, int64_t begin_time) {
+    SolverData *data = self->data;
+    const int32_t num_members = data->portfolio.num_members;
+    SolveStatus status = SOLVE_STATUS_ERR;
+    int32_t num_started = 0;
+    int32_t winner = -1;
+
+    PortfolioJob *jobs = calloc(num_members, sizeof(*jobs));
+    pthread_t *threads = malloc(num_members * sizeof(*threads));
+    if (!jobs || !threads) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        goto terminate;
+    }
+
+    for (int32_t k = 0; k < num_members; k++) {
+        Solver *member = &data->portfolio.members[k];
+        member->sigterm_occured = false;
+        member->sigterm_occured_int = 0;
+
+        jobs[k].member = member;
+        jobs[k].instance = instance;
+        jobs[k].begin_time = begin_time;
+        jobs[k].solution = solution_create(instance);
+        atomic_store(&jobs[k].done, false);
+
+        if (pthread_create(&threads[k], NULL, portfolio_job_main, &jobs[k]) !=
+            0) {
+            log_fatal("%s :: Failed to start member %d", __func__, k);
+            solution_destroy(&jobs[k].solution);
+            terminate_members(self);
+            break;
+        }
+        ++num_started;
+    }
+
+    // NOTE(dparo):
+    //      The first member terminating without errors, either because it
+    //      closed the problem, or because it collected enough pricing tours,
+    //      or because it ran out of time, stops all the others.
+    for (;;) {
+        if (self->sigterm_occured) {
+            terminate_members(self);
+        }
+
+        int32_t num_done = 0;
+        for (int32_t k = 0; k < num_started; k++) {
+            if (!atomic_load(&jobs[k].done)) {
+                continue;
+            }
+            ++num_done;
+            if (winner < 0 && jobs[k].status != SOLVE_STATUS_NULL &&
+                !BOOL(jobs[k].status & SOLVE_STATUS_ERR)) {
+                winner = k;
+                terminate_members(self);
+            }
+        }
+
+        if (num_done == num_started) {
+            break;
+        }
+        os_sleep(PORTFOLIO_POLL_USECS);
+    }
+
+    for (int32_t k = 0; k < num_started; k++) {
+        pthread_join(threads[k], NULL);
+    }
+
+    if (num_started == num_members && winner >= 0) {
+        status = merge_member_solutions(jobs, num_started, winner, solution);
+    }
+
+    for (int32_t k = 0; k < num_started; k++) {
+        solution_destroy(&jobs[k].solution);
+    }
+
+terminate:
+    free(jobs);
+    free(threads);
+    return status;
+}
+
+static bool portfolio_set_edge_fixings(Solver *self, const Instance *instance,
+                                       const EdgeFix *fixings,
+                                       int32_t num_fixings) {
+    for (int32_t k = 0; k < self->data->portfolio.num_members; k++) {
+        Solver *member = &self->data->portfolio.members[k];
+        if (!member->set_edge_fixings(member, instance, fixings,
+                                      num_fixings)) {
+            return false;
+        }
+    }
+
+    // NOTE(dparo): The shared incumbent may violate the new fixings
+    MipSharedIncumbent *shared = self->data->portfolio.shared;
+    shared->cost = INFINITY;
+    shared->owner = -1;
+    return true;
+}
+
+static void portfolio_destroy(Solver *self) {
+    if (self->data) {
+        for (int32_t k = 0; k < self->data->portfolio.num_members; k++) {
+            Solver *member = &self->data->portfolio.members[k];
+            if (member->destroy) {
+                member->destroy(member);
+            }
+        }
+        free(self->data->portfolio.members);
+
+        if (self->data->portfolio.shared) {
+            tour_destroy(&self->data->portfolio.shared->tour);
+            free(self->data->portfolio.shared);
+        }
+        free(self->data);
+    }
+
+    memset(self, 0, sizeof(*self));
+    self->destroy = portfolio_destroy;
+}
+
+Solver mip_portfolio_create(const Instance *instance,
+                            SolverTypedParams *tparams, double timelimit,
+                            int32_t randomseed, int32_t num_members) {
+    const int64_t begin_time = os_get_usecs();
+
+    Solver solver = {0};
+    solver.solve = portfolio_solve;
+    solver.destroy = portfolio_destroy;
+    solver.set_edge_fixings = portfolio_set_edge_fixings;
+    solver.data = calloc(1, sizeof(*solver.data));
+    if (!solver.data) {
+        goto fail;
+    }
+
+    SolverData *data = solver.data;
+    data->portfolio.members =
+        calloc(num_members, sizeof(*data->portfolio.members));
+    data->portfolio.shared = calloc(1, sizeof(*data->portfolio.shared));
+    if (!data->portfolio.members || !data->portfolio.shared) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        goto fail;
+    }
+
+    MipSharedIncumbent *shared = data->portfolio.shared;
+    atomic_flag_clear(&shared->lock);
+    atomic_store(&shared->version, 0);
+    shared->cost = INFINITY;
+    shared->owner = -1;
+    shared->tour = tour_create(instance);
+    if (!tour_is_valid(&shared->tour)) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        goto fail;
+    }
+
+    const int32_t numcores = get_num_cores();
+    int32_t num_threads = numcores;
+    if (solver_params_get_int32(tparams, "NUM_THREADS") > 0) {
+        num_threads =
+            MIN(num_threads, solver_params_get_int32(tparams, "NUM_THREADS"));
+    }
+    const int32_t member_threads = MAX(1, num_threads / num_members);
+    // NOTE(dparo):
+    //      With less cores than members the subsets cannot be disjoint: leave
+    //      the thread placement to the operating system.
+    const bool pin_threads = member_threads * num_members <= numcores;
+
+    log_info("%s :: %d members, %d threads each (pinned = %d)", __func__,
+             num_members, member_threads, pin_threads);
+
+    for (int32_t k = 0; k < num_members; k++) {
+        SolverTypedParams member_params = {0};
+        copy_params(tparams, &member_params);
+        set_int32_param(&member_params, "PORTFOLIO_SIZE", 1);
+        set_int32_param(&member_params, "NUM_THREADS", member_threads);
+        apply_member_profile(&member_params, k);
+
+        double elapsed = (double)(os_get_usecs() - begin_time) * USECS_TO_SECS;
+        Solver *member = &data->portfolio.members[k];
+        *member = mip_solver_create(instance, &member_params,
+                                    timelimit - elapsed, randomseed + k);
+        solver_typed_params_destroy(&member_params);
+        data->portfolio.num_members = k + 1;
+
+        if (!member->solve) {
+            log_fatal("%s :: Failed to create member %d", __func__, k);
+            goto fail;
+        }
+
+        if (!mip_join_portfolio(member, instance, shared, k)) {
+            goto fail;
+        }
+
+        if (pin_threads) {
+            char mask[CPX_STR_PARAM_MAX];
+            format_cpu_mask(mask, ARRAY_LEN(mask), k * member_threads,
+                            (k + 1) * member_threads);
+            if (CPXXsetstrparam(member->data->env, CPX_PARAM_CPUMASK, mask) !=
+                0) {
+                log_warn("%s :: Failed to set CPX_PARAM_CPUMASK to %s for "
+                         "member %d",
+                         __func__, mask, k);
+            }
+        }
+    }
+
+    return solver;
+
+fail:
+    if (solver.destroy) {
+        solver.destroy(&solver);
+    }
+
+    return (Solver){0};
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2022 Davide Paro
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#if __cplusplus
+extern "C" {
+#endif
+
+#include "mip.h"
+
+/// Creates a portfolio of `num_members` MIP solvers, which run concurrently
+/// on disjoint subsets of the threads, each one with its own random seed and
+/// search settings. See the `PORTFOLIO_SIZE` param.
+Solver mip_portfolio_create(const Instance *instance,
+                            SolverTypedParams *tparams, double timelimit,
+                            int32_t randomseed, int32_t num_members);
+
+/// Makes `self` the member `member_id` of a portfolio, publishing its
+/// incumbents to `shared` and importing the ones of the other members.
+bool mip_join_portfolio(Solver *self, const Instance *instance,
+                        MipSharedIncumbent *shared, int32_t member_id);
+
+#if __cplusplus
+}
+#endif
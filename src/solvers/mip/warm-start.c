@@ -22,105 +22,196 @@
 
 #include "warm-start.h"
 #include "validation.h"
+#include "local-search.h"
 
 #define WARM_START_MIN_NUM_CUSTOMERS_SERVED (2)
 
+/// Length of the candidate lists used by the 2-opt / Or-opt refinement.
+/// Warm start tours seldom visit all the customers, and the unvisited
+/// candidates are skipped: keep the lists reasonably long.
+#define WARM_START_NUM_NEIGHBORS (25)
+
 typedef struct InsHeurNodePair {
     int32_t u, v;
 } InsHeurNodePair;
 
+static int cmp_cpxdim(const void *a, const void *b) {
+    CPXDIM x = *(const CPXDIM *)a;
+    CPXDIM y = *(const CPXDIM *)b;
+    return (x > y) - (x < y);
+}
+
+/// Checks whether the MIP start `[first, end)` of the pool duplicates one of
+/// the MIP starts preceding it.
+static bool is_duplicate_mip_start(const SolverData *data, CPXNNZ first,
+                                   CPXNNZ end) {
+    const ptrdiff_t num_starts = arrlen(data->warm_start_pool.beg);
+    const CPXDIM *ind = data->warm_start_pool.ind;
+    const double *val = data->warm_start_pool.val;
+    const CPXNNZ nnz = end - first;
+
+    for (ptrdiff_t k = 0; k < num_starts; k++) {
+        CPXNNZ beg = data->warm_start_pool.beg[k];
+        CPXNNZ next = k + 1 < num_starts ? data->warm_start_pool.beg[k + 1]
+                                         : first;
+        if (next - beg == nnz &&
+            0 == memcmp(&ind[beg], &ind[first], nnz * sizeof(*ind)) &&
+            0 == memcmp(&val[beg], &val[first], nnz * sizeof(*val))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Appends the complete assignment of the CPLEX columns encoding `tour`
+/// (required by CPX_MIPSTART_NOCHECK).
+static void push_complete_mip_start(SolverData *data, const Instance *instance,
+                                    const Tour *tour) {
+    const int32_t n = instance->num_customers + 1;
+    const CPXDIM num_cols = mip_num_cols(data);
+    const CPXNNZ first = (CPXNNZ)arrlen(data->warm_start_pool.ind);
+
+    for (CPXDIM col = 0; col < num_cols; col++) {
+        arrput(data->warm_start_pool.ind, col);
+        arrput(data->warm_start_pool.val, 0.0);
+    }
+
+    double *val = &data->warm_start_pool.val[first];
+    for (int32_t i = 0; i < n; i++) {
+        if (tour->comp[i] != 0) {
+            continue;
+        }
+        CPXDIM y_col = mip_var_to_col(data, get_y_mip_var_idx(instance, i));
+        CPXDIM x_col =
+            mip_var_to_col(data, get_x_mip_var_idx(instance, i, tour->succ[i]));
+        assert(y_col >= 0 && x_col >= 0);
+        val[y_col] = 1.0;
+        val[x_col] = 1.0;
+    }
+}
+
+/// Appends the sparse encoding of `tour`: the X columns of its edges (sorted)
+/// and all the Y columns. The X columns left out are implied to be zero by
+/// the degree constraints.
+static void push_sparse_mip_start(SolverData *data, const Instance *instance,
+                                  const Tour *tour) {
+    const int32_t n = instance->num_customers + 1;
+
+    for (int32_t i = 0; i < n; i++) {
+        arrput(data->warm_start_pool.ind,
+               mip_var_to_col(data, get_y_mip_var_idx(instance, i)));
+        arrput(data->warm_start_pool.val, tour->comp[i] == 0 ? 1.0 : 0.0);
+    }
+
+    const CPXNNZ x_first = (CPXNNZ)arrlen(data->warm_start_pool.ind);
+    for (int32_t i = 0; i < n; i++) {
+        if (tour->comp[i] != 0) {
+            continue;
+        }
+        CPXDIM x_col =
+            mip_var_to_col(data, get_x_mip_var_idx(instance, i, tour->succ[i]));
+        assert(x_col >= 0);
+        arrput(data->warm_start_pool.ind, x_col);
+        arrput(data->warm_start_pool.val, 1.0);
+    }
+
+    qsort(&data->warm_start_pool.ind[x_first],
+          (size_t)(arrlen(data->warm_start_pool.ind) - x_first),
+          sizeof(*data->warm_start_pool.ind), cmp_cpxdim);
+}
+
+/// Adds the warm start `solution` to the pool of MIP starts, unless the same
+/// route is already there. The pool is submitted to CPLEX by
+/// mip_flush_warm_start_pool().
 static bool feed_warm_solution(Solver *solver, const Instance *instance,
                                const Solution *solution) {
-    bool result = true;
+    SolverData *data = solver->data;
     const int32_t n = instance->num_customers + 1;
-    CPXNNZ beg[] = {0};
 
-    // NOTE(dparo):
-    //         Technically, our warm start solutions should always be feasible,
-    //         therefore asking CPLEX to check for feasibility (i.e.
-    //         CPX_MIPSTART_CHECKFEAS), is technically a waste of time. We could
-    //         use instead the unsafe CPX_MIPSTART_NOCHECK parameter,
-    //         where CPLEX does not verify the feasibility.
-    //         In this case CPLEX assume the warm start solution is feasible
-    //         regardless. If for a bug in the code, the produced warm start
-    //         solution is not feasible, CPLEX may output a wrong
-    //         solution for the CPTP problem. Since checking for feasiblity
-    //         (CPX_MIPSTART_CHECKFEAS), does not constitute a major runtime
-    //         bottleneck, for safety reasons it is better to leave it enabled,
-    //         at least in DEBUG builds.
-    int effortlevel[] = {CPX_MIPSTART_CHECKFEAS};
-
-    CPXDIM *varindices =
-        malloc(solver->data->num_mip_vars * sizeof(*varindices));
-
-    double *vstar = malloc(solver->data->num_mip_vars * sizeof(*vstar));
 #ifndef NDEBUG
-    memset(vstar, 0xCD, solver->data->num_mip_vars * sizeof(*vstar));
+    validate_tour(instance, (Tour *)&solution->tour,
+                  WARM_START_MIN_NUM_CUSTOMERS_SERVED);
 #endif
 
-    for (int32_t i = 0; i < n; i++) {
-        bool i_is_visited = solution->tour.comp[i] == 0;
-        vstar[get_y_mip_var_idx(instance, i)] = i_is_visited ? 1.0 : 0.0;
+    data->warm_start_primal_bound =
+        MIN(data->warm_start_primal_bound, solution->primal_bound);
+    mip_pricer_collect_tour(data, &solution->tour, solution->primal_bound);
+
+    if (data->sparse.enabled && !data->sparse.finalized) {
+        // NOTE(dparo):
+        //      The sparse formulation is still an LP undergoing pricing, and
+        //      its columns may still change. Keep the tour around, it will
+        //      be fed to CPLEX once the formulation is finalized
+        //      (see mip_flush_deferred_warm_starts())
+        arrput(data->sparse.deferred_warm_starts, tour_copy(&solution->tour));
+        return true;
     }
 
+    // Skip the tours using an edge pruned by the sparse formulation
     for (int32_t i = 0; i < n; i++) {
-        for (int32_t j = i + 1; j < n; j++) {
-            int32_t succ_i = solution->tour.succ[i];
-            int32_t succ_j = solution->tour.succ[j];
-            int32_t comp_i = solution->tour.comp[i];
-            int32_t comp_j = solution->tour.comp[j];
-
-            if (comp_i == 0 && comp_j == 0) {
-                assert(succ_i >= 0 && succ_i < n);
-                assert(succ_j >= 0 && succ_j < n);
-
-                if (succ_i == j || succ_j == i) {
-                    vstar[get_x_mip_var_idx(instance, i, j)] = 1.0;
-                } else {
-                    vstar[get_x_mip_var_idx(instance, i, j)] = 0.0;
-                }
-            } else {
-                vstar[get_x_mip_var_idx(instance, i, j)] = 0.0;
-            }
+        if (solution->tour.comp[i] == 0 &&
+            mip_var_to_col(data, get_x_mip_var_idx(
+                                     instance, i, solution->tour.succ[i])) <
+                0) {
+            return true;
         }
     }
 
-#ifndef NDEBUG
-    for (CPXDIM i = 0; i < solver->data->num_mip_vars; i++) {
-        assert(vstar[i] == 0.0 || vstar[i] == 1.0);
+    const CPXNNZ first = (CPXNNZ)arrlen(data->warm_start_pool.ind);
+    if (data->warm_start_pool.effort == CPX_MIPSTART_NOCHECK) {
+        push_complete_mip_start(data, instance, &solution->tour);
+    } else {
+        push_sparse_mip_start(data, instance, &solution->tour);
     }
+    mip_add_work(data, (int64_t)arrlen(data->warm_start_pool.ind) - first);
 
-    {
-        Tour t = tour_create(instance);
-        unpack_mip_solution(instance, &t, vstar);
-        validate_tour(instance, &t, WARM_START_MIN_NUM_CUSTOMERS_SERVED);
-        assert(t.num_comps == 1);
-        for (int32_t i = 0; i < n; i++) {
-            assert(t.comp[i] == solution->tour.comp[i]);
-            // NOTE: Cannot perform this comparison since two tours
-            //       may express the same route, but not be bit, by bit
-            //       compatible. Eg the same route taken in reversed order
-            // assert(t.succ[i] == solution->tour.succ[i]);
-        }
-        tour_destroy(&t);
+    if (is_duplicate_mip_start(data, first,
+                               (CPXNNZ)arrlen(data->warm_start_pool.ind))) {
+        arrsetlen(data->warm_start_pool.ind, first);
+        arrsetlen(data->warm_start_pool.val, first);
+    } else {
+        arrput(data->warm_start_pool.beg, first);
     }
-#endif
 
-    for (CPXDIM i = 0; i < solver->data->num_mip_vars; i++) {
-        varindices[i] = i;
+    return true;
+}
+
+bool mip_flush_warm_start_pool(Solver *solver) {
+    SolverData *data = solver->data;
+    const int mcnt = (int)arrlen(data->warm_start_pool.beg);
+    const CPXNNZ nzcnt = (CPXNNZ)arrlen(data->warm_start_pool.ind);
+    bool result = true;
+
+    if (mcnt == 0) {
+        return true;
+    }
+
+    int *effortlevel = malloc(mcnt * sizeof(*effortlevel));
+    if (!effortlevel) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        result = false;
+        goto terminate;
+    }
+    for (int k = 0; k < mcnt; k++) {
+        effortlevel[k] = data->warm_start_pool.effort;
     }
 
-    if (0 != CPXXaddmipstarts(solver->data->env, solver->data->lp, 1,
-                              solver->data->num_mip_vars, beg, varindices,
-                              vstar, effortlevel, NULL)) {
+    log_info("%s :: submitting %d distinct MIP starts (%lld nonzeros)",
+             __func__, mcnt, (long long)nzcnt);
+    if (0 != CPXXaddmipstarts(data->env, data->lp, mcnt, nzcnt,
+                              data->warm_start_pool.beg,
+                              data->warm_start_pool.ind,
+                              data->warm_start_pool.val, effortlevel, NULL)) {
         log_fatal("%s :: Failed to call CPXXaddmipstarts()", __func__);
         result = false;
         goto terminate;
     }
 
 terminate:
-    free(vstar);
-    free(varindices);
+    free(effortlevel);
+    arrsetlen(data->warm_start_pool.beg, 0);
+    arrsetlen(data->warm_start_pool.ind, 0);
+    arrsetlen(data->warm_start_pool.val, 0);
     return result;
 }
 
@@ -177,8 +268,128 @@ static bool random_insheur_starting_pair(const Instance *instance,
     return true;
 }
 
-static void ins_heur(const Instance *instance, Solution *solution,
-                     InsHeurNodePair starting_pair) {
+/// Incremental best insertion engine for ins_heur(). Each unvisited customer
+/// `h` caches its cheapest insertion edge `(pred[h], succ[pred[h]])` and the
+/// associated cost variation `delta[h]`. The customers are kept in a binary
+/// min-heap keyed by `delta`, so that the best insertion is always on top.
+typedef struct InsHeurQueue {
+    int32_t size;
+    int32_t *heap;
+    /// Position of each customer in `heap`, or -1 when not queued
+    int32_t *pos;
+    double *delta;
+    int32_t *pred;
+} InsHeurQueue;
+
+static void ins_heur_queue_destroy(InsHeurQueue *q) {
+    free(q->heap);
+    free(q->pos);
+    free(q->delta);
+    free(q->pred);
+    memset(q, 0, sizeof(*q));
+}
+
+static bool ins_heur_queue_create(InsHeurQueue *q, const Instance *instance) {
+    const int32_t n = instance->num_customers + 1;
+    memset(q, 0, sizeof(*q));
+    q->heap = malloc(n * sizeof(*q->heap));
+    q->pos = malloc(n * sizeof(*q->pos));
+    q->delta = malloc(n * sizeof(*q->delta));
+    q->pred = malloc(n * sizeof(*q->pred));
+
+    if (!q->heap || !q->pos || !q->delta || !q->pred) {
+        ins_heur_queue_destroy(q);
+        return false;
+    }
+    return true;
+}
+
+static inline void ins_heur_queue_swap(InsHeurQueue *q, int32_t i,
+                                       int32_t j) {
+    int32_t hi = q->heap[i];
+    int32_t hj = q->heap[j];
+    q->heap[i] = hj;
+    q->heap[j] = hi;
+    q->pos[hj] = i;
+    q->pos[hi] = j;
+}
+
+static void ins_heur_queue_sift_up(InsHeurQueue *q, int32_t i) {
+    while (i > 0) {
+        int32_t parent = (i - 1) / 2;
+        if (q->delta[q->heap[parent]] <= q->delta[q->heap[i]]) {
+            break;
+        }
+        ins_heur_queue_swap(q, i, parent);
+        i = parent;
+    }
+}
+
+static void ins_heur_queue_sift_down(InsHeurQueue *q, int32_t i) {
+    while (true) {
+        int32_t smallest = i;
+        int32_t l = 2 * i + 1;
+        int32_t r = 2 * i + 2;
+        if (l < q->size && q->delta[q->heap[l]] < q->delta[q->heap[smallest]]) {
+            smallest = l;
+        }
+        if (r < q->size && q->delta[q->heap[r]] < q->delta[q->heap[smallest]]) {
+            smallest = r;
+        }
+        if (smallest == i) {
+            break;
+        }
+        ins_heur_queue_swap(q, i, smallest);
+        i = smallest;
+    }
+}
+
+static void ins_heur_queue_remove(InsHeurQueue *q, int32_t h) {
+    int32_t i = q->pos[h];
+    assert(i >= 0 && i < q->size);
+    q->pos[h] = -1;
+    --q->size;
+    if (i != q->size) {
+        int32_t last = q->heap[q->size];
+        q->heap[i] = last;
+        q->pos[last] = i;
+        ins_heur_queue_sift_up(q, i);
+        ins_heur_queue_sift_down(q, q->pos[last]);
+    }
+}
+
+static inline double ins_heur_delta(const Instance *instance, int32_t h,
+                                    int32_t a, int32_t b) {
+    return cptp_dist(instance, a, h) + cptp_dist(instance, h, b) -
+           cptp_dist(instance, a, b) - instance->profits[h];
+}
+
+/// Scans all the edges of the tour for the cheapest insertion of `h`.
+/// Returns the number of evaluated edges.
+static int32_t ins_heur_rescan(InsHeurQueue *q, const Instance *instance,
+                               const Tour *tour, int32_t h, int32_t first) {
+    int32_t num_evals = 0;
+    q->delta[h] = INFINITY;
+    q->pred[h] = first;
+
+    int32_t a = first;
+    do {
+        int32_t b = tour->succ[a];
+        double delta = ins_heur_delta(instance, h, a, b);
+        if (delta < q->delta[h]) {
+            q->delta[h] = delta;
+            q->pred[h] = a;
+        }
+        ++num_evals;
+        a = b;
+    } while (a != first);
+
+    return num_evals;
+}
+
+static void ins_heur(Solver *solver, const Instance *instance,
+                     Solution *solution, InsHeurNodePair starting_pair,
+                     InsHeurQueue *q) {
     Tour *const tour = &solution->tour;
 
     const int32_t n = instance->num_customers + 1;
@@ -204,102 +415,118 @@ static void ins_heur(const Instance *instance, Solution *solution,
     double sum_demands = instance->demands[start] + instance->demands[end];
 
     int32_t num_visited = 2;
+    int64_t num_evals = 0;
 
-    while (true) {
-        double best_delta_cost = -COST_TOLERANCE;
-        int32_t best_h = -1;
-        int32_t best_a = -1;
-        int32_t best_b = -1;
-
-        // Scan for nodes to be inserted
-        for (int32_t h = 0; h < n; h++) {
-            bool h_is_visited = tour->comp[h] == 0;
-            if (h_is_visited) {
-                continue;
-            }
-
-            for (int32_t a = 0; a < n; a++) {
-                bool a_is_visited = tour->comp[a] == 0;
-                if (!a_is_visited) {
-                    continue;
-                }
-
-                int32_t b = tour->succ[a];
-                assert(b >= 0 && b < n);
-                assert(tour->succ[a] == b);
-
-                const double rel_Q = Q - sum_demands;
-                double delta_cost = INFINITY;
-
-                if (instance->demands[h] <= rel_Q) {
-                    double c_ah = cptp_dist(instance, a, h);
-                    double c_hb = cptp_dist(instance, h, b);
-                    double c_ab = cptp_dist(instance, a, b);
-                    delta_cost = c_ah + c_hb - c_ab - instance->profits[h];
-                } else {
-                    // This city requires too much demand compared to what is
-                    // the remainder capacity of the truck
-                    delta_cost = INFINITY;
-                }
+    // NOTE(dparo):
+    //      Customers whose demand exceeds the residual capacity are never
+    //      queued: the residual capacity only decreases, so they can never
+    //      be inserted later on.
+    q->size = 0;
+    for (int32_t h = 0; h < n; h++) {
+        q->pos[h] = -1;
+        if (tour->comp[h] == 0 || instance->demands[h] > Q - sum_demands) {
+            continue;
+        }
+        num_evals += ins_heur_rescan(q, instance, tour, h, start);
+        q->heap[q->size] = h;
+        q->pos[h] = q->size;
+        ++q->size;
+        ins_heur_queue_sift_up(q, q->size - 1);
+    }
 
-                // NOTE(dparo):
-                //     A vertex is a good candidate for insertion, considering
-                //     it is not already visited, if it is the depot (must be
-                //     visited due to the formulation of the problem), only 2
-                //     nodes are visited in the current tour (the MIP
-                //     formulation accepts only tours having at least 3 nodes
-                //     visited) or if it improves the previous candidate
-                //     delta_cost. Recall that the best_delta_cost starts from
-                //     0.0, and therefore only improving vertices will be
-                //     inserted.
-
-                assert(!h_is_visited);
-
-                // NOTE(dparo):
-                //      Marking the depot node once (best_h = 0) as a
-                //      candidate raises the best_delta_cost above 0, therefore
-                //      allowing non improving vertices to now become valid
-                //      candidate for insertions. Therefore make a smarter check
-                //      if the delta_cost: if the best_h insertion candidate is
-                //      the depot then compare the delta cost using the `0.0 -
-                //      COST_TOLERANCE` threshold, otherwise do a conventional
-                //      comparison against the previous best_delta_cost
-                bool improving_delta_cost =
-                    best_h == 0
-                        ? delta_cost < -COST_TOLERANCE
-                        : delta_cost < (best_delta_cost - COST_TOLERANCE);
-
-                bool good_candidate_for_insertion =
-                    h == 0 || num_visited == 2 || improving_delta_cost;
-
-                if (good_candidate_for_insertion) {
-                    best_delta_cost = delta_cost;
-                    best_h = h;
-                    best_a = a;
-                    best_b = b;
+    while (q->size > 0) {
+        const double rel_Q = Q - sum_demands;
+
+        // NOTE(dparo):
+        //     The depot must be visited due to the formulation of the
+        //     problem, and the MIP formulation accepts only tours having at
+        //     least 3 nodes visited. In these two cases the insertion is
+        //     performed even if it is not improving.
+        //     The forced third node is the highest indexed insertable
+        //     customer, and not the cheapest one. This only preserves the
+        //     behavior of the original implementation, where every candidate
+        //     overrode the previous one while 2 nodes were visited, such that
+        //     the warm start tours do not change.
+        int32_t h = -1;
+        if (q->pos[0] >= 0) {
+            h = 0;
+        } else if (num_visited == 2) {
+            for (int32_t v = n - 1; v > 0 && h < 0; v--) {
+                if (q->pos[v] >= 0 && instance->demands[v] <= rel_Q &&
+                    isfinite(q->delta[v])) {
+                    h = v;
                 }
             }
+            if (h < 0) {
+                break;
+            }
+        } else {
+            h = q->heap[0];
+            if (instance->demands[h] > rel_Q) {
+                ins_heur_queue_remove(q, h);
+                continue;
+            }
+            if (!(q->delta[h] < -COST_TOLERANCE)) {
+                break;
+            }
         }
 
-        if (best_h < 0) {
-            assert(tour->comp[0] == 0);
-            break;
-        }
+        const double delta = q->delta[h];
 
-        assert(best_h >= 0 && best_h < n);
-        assert(best_a >= 0 && best_a < n);
-        assert(best_b >= 0 && best_b < n);
-        assert(tour->succ[best_a] == best_b);
+        const int32_t a = q->pred[h];
+        const int32_t b = tour->succ[a];
+        assert(tour->comp[a] == 0);
+        assert(feq(delta, ins_heur_delta(instance, h, a, b), 1e-9));
 
-        assert(best_delta_cost < 0.0 || num_visited == 2 || best_h == 0);
-        cost += best_delta_cost;
-        sum_demands += instance->demands[best_h];
+        ins_heur_queue_remove(q, h);
+        cost += delta;
+        sum_demands += instance->demands[h];
 
-        tour->comp[best_h] = 0;
-        tour->succ[best_a] = best_h;
-        tour->succ[best_h] = best_b;
+        tour->comp[h] = 0;
+        tour->succ[a] = h;
+        tour->succ[h] = b;
         ++num_visited;
 
+        // NOTE(dparo):
+        //      The insertion replaced the edge (a, b) with the edges (a, h)
+        //      and (h, b). The customers whose cheapest insertion was (a, b)
+        //      need a full rescan, all the others only have to consider the
+        //      two new edges.
+        const double c_ah = cptp_dist(instance, a, h);
+        const double c_hb = cptp_dist(instance, h, b);
+        for (int32_t v = 0; v < n; v++) {
+            if (q->pos[v] < 0) {
+                continue;
+            }
+            const double prev_delta = q->delta[v];
+
+            if (q->pred[v] == a) {
+                num_evals += ins_heur_rescan(q, instance, tour, v, a);
+            } else {
+                double c_hv = cptp_dist(instance, h, v);
+                double delta_ah = cptp_dist(instance, a, v) + c_hv - c_ah -
+                                  instance->profits[v];
+                double delta_hb = c_hv + cptp_dist(instance, v, b) - c_hb -
+                                  instance->profits[v];
+                // Three distance lookups, as a single insertion evaluation
+                ++num_evals;
+                if (delta_ah < q->delta[v]) {
+                    q->delta[v] = delta_ah;
+                    q->pred[v] = a;
+                }
+                if (delta_hb < q->delta[v]) {
+                    q->delta[v] = delta_hb;
+                    q->pred[v] = h;
+                }
+            }
+
+            if (q->delta[v] < prev_delta) {
+                ins_heur_queue_sift_up(q, q->pos[v]);
+            } else if (q->delta[v] > prev_delta) {
+                ins_heur_queue_sift_down(q, q->pos[v]);
+            }
+        }
+
 #ifndef NDEBUG
         if (tour->comp[0] == 0) {
             validate_tour(instance, tour, WARM_START_MIN_NUM_CUSTOMERS_SERVED);
@@ -308,6 +535,10 @@ static void ins_heur(const Instance *instance, Solution *solution,
 #endif
     }
 
+    // Each insertion evaluation takes three distance lookups
+    mip_add_work(solver->data, 3 * num_evals);
+
+    assert(tour->comp[0] == 0);
     solution->primal_bound = cost;
 
 #ifndef NDEBUG
@@ -330,182 +561,506 @@ static void ins_heur(const Instance *instance, Solution *solution,
 #endif
 }
 
-static void twoopt_exchange(Solver *solver, const Instance *instance,
-                            Tour *tour, int32_t a, int32_t b) {
-    const int32_t n = instance->num_customers + 1;
-    assert(a >= 0 && a < n);
-    assert(b >= 0 && b < n);
+static void twoopt_refine(Solver *solver, const Instance *instance,
+                          const LsNeighborLists *nl, Solution *solution) {
+    // NOTE(dparo):
+    //      Neither 2-opt, Or-opt nor Lin-Kernighan moves change the set of
+    //      visited vertices, therefore capacity constraints remain satisfied
+    //      and profits do not change. The only thing that changes is the cost
+    //      associated with the travelling distance.
+    int64_t num_evals = 0;
+    if (solver->data->lin_kernighan) {
+        solution->primal_bound +=
+            ls_lin_kernighan(instance, nl, &solution->tour, &num_evals);
+    } else {
+        solution->primal_bound +=
+            ls_twoopt_oropt(instance, nl, &solution->tour, &num_evals);
+    }
 
-    int32_t succ_a = tour->succ[a];
-    int32_t succ_b = tour->succ[b];
+    // Each move evaluation takes (about) four distance lookups
+    mip_add_work(solver->data, 4 * num_evals);
+
+#ifndef NDEBUG
+    validate_primal_solution(instance, solution, WARM_START_MIN_NUM_CUSTOMERS_SERVED);
+#endif
+}
 
-    assert(succ_a >= 0 && succ_a < n);
-    assert(succ_b >= 0 && succ_b < n);
+/// Rounds of customer selection refinement alternated with the 2-opt /
+/// Or-opt refinement. Each round only runs if the previous one improved.
+#define WARM_START_MAX_SELECTION_ROUNDS (4)
 
-    // Reverse part of the tour
-    {
-        int32_t prev = succ_a;
-        int32_t current = tour->succ[succ_a];
-        assert(current >= 0 && current < n);
+static void selection_refine(Solver *solver, const Instance *instance,
+                             const LsNeighborLists *nl, Solution *solution) {
+    // NOTE(dparo):
+    //      Adding, dropping or swapping customers changes the set of
+    //      visited vertices and opens up new 2-opt / Or-opt moves, and a
+    //      shorter route in turn leaves room for new insertions.
+    //      Alternate the two neighborhoods until neither improves.
+    for (int32_t r = 0; r < WARM_START_MAX_SELECTION_ROUNDS; r++) {
+        int64_t num_evals = 0;
+        double delta =
+            ls_add_drop_swap(instance, nl, &solution->tour,
+                             WARM_START_MIN_NUM_CUSTOMERS_SERVED, &num_evals);
+        solution->primal_bound += delta;
+
+        // Each insertion evaluation takes (about) three distance lookups
+        mip_add_work(solver->data, 3 * num_evals);
+
+#ifndef NDEBUG
+        validate_primal_solution(instance, solution,
+                                 WARM_START_MIN_NUM_CUSTOMERS_SERVED);
+#endif
 
-        while (current != succ_b) {
-            int32_t next = tour->succ[current];
-            assert(next >= 0 && next < n);
-            tour->succ[current] = prev;
-            prev = current;
-            current = next;
+        if (delta > -COST_TOLERANCE) {
+            break;
         }
+        twoopt_refine(solver, instance, nl, solution);
     }
+}
 
-    // Fix the edge crossing
-    tour->succ[a] = b;
-    tour->succ[succ_a] = succ_b;
+/// Starts handed to each thread per round of the multi-start warm start.
+/// After each round the results are merged in start order, which keeps the
+/// outcome independent of the thread scheduling.
+#define WARM_START_STARTS_PER_THREAD (4)
+
+typedef struct WarmStartRound {
+    const InsHeurNodePair *pairs;
+    Solution *results;
+    int32_t num_pairs;
+    _Atomic int32_t next;
+} WarmStartRound;
+
+typedef struct WarmStartWorker {
+    Solver *solver;
+    const Instance *instance;
+    const LsNeighborLists *nl;
+    bool heur_pricer_mode;
+    WarmStartRound *round;
+    /// Per thread scratch of ins_heur()
+    InsHeurQueue queue;
+    pthread_t thread;
+} WarmStartWorker;
+
+static void *warm_start_worker_main(void *arg) {
+    WarmStartWorker *w = arg;
+    WarmStartRound *round = w->round;
+    int32_t i;
+
+    while ((i = atomic_fetch_add(&round->next, 1)) < round->num_pairs) {
+        Solution *solution = &round->results[i];
+        ins_heur(w->solver, w->instance, solution, round->pairs[i],
+                 &w->queue);
+
+        // NOTE(dparo):
+        //       Since 2opt refinements are not cheap, and may cost us
+        //       computation time, try to do them only when absolutely
+        //       necessary. This will keep the main execution path as
+        //       fast as possible
+        if (!w->heur_pricer_mode ||
+            !is_valid_reduced_cost(solution->primal_bound)) {
+            twoopt_refine(w->solver, w->instance, w->nl, solution);
+            selection_refine(w->solver, w->instance, w->nl, solution);
+        }
+    }
 
-#ifndef NDEBUG
-    validate_tour(instance, tour, WARM_START_MIN_NUM_CUSTOMERS_SERVED);
-#endif
+    return NULL;
 }
 
-static void twoopt_refine(Solver *solver, const Instance *instance,
-                          Solution *solution) {
-    const int32_t n = instance->num_customers + 1;
+/// Keeps in `best` (sorted by increasing cost) the `k` best distinct tours
+/// seen so far. Ties are broken in favor of the tours seen first. Returns
+/// whether `solution` made it into `best`.
+static bool keep_best_tour(Solution **best, int32_t k,
+                           const Solution *solution) {
+    ptrdiff_t len = arrlen(*best);
+
+    for (ptrdiff_t i = 0; i < len; i++) {
+        if (tour_same_route(&(*best)[i].tour, &solution->tour)) {
+            return false;
+        }
+    }
+
+    if (len >= k) {
+        if (!(solution->primal_bound < (*best)[len - 1].primal_bound)) {
+            return false;
+        }
+        // Evict the worst tour
+        tour_destroy(&(*best)[len - 1].tour);
+        arrsetlen(*best, len - 1);
+        --len;
+    }
+
+    Solution copy = {0};
+    copy.tour = tour_copy(&solution->tour);
+    copy.primal_bound = solution->primal_bound;
+    copy.dual_bound = -INFINITY;
+    arrput(*best, copy);
+
+    // Insertion sort by increasing cost
+    for (ptrdiff_t i = len; i > 0; i--) {
+        if ((*best)[i - 1].primal_bound <= (*best)[i].primal_bound) {
+            break;
+        }
+        SWAP(Solution, (*best)[i - 1], (*best)[i]);
+    }
+    return true;
+}
+
+/// Priority driven sampling of the starting pairs. Each candidate customer
+/// has a static priority, based on the rank of its profit / demand ratio,
+/// scaled by its distance from the closest starting customer selected so
+/// far (the depot included), such that the starts are spread out.
+typedef struct StartSampler {
+    int32_t num_pairs;
+    InsHeurNodePair *pairs;
+    double *priority;
+    double *min_dist;
+    bool *taken;
+} StartSampler;
+
+static void start_sampler_destroy(StartSampler *sampler) {
+    free(sampler->priority);
+    free(sampler->min_dist);
+    free(sampler->taken);
+    memset(sampler, 0, sizeof(*sampler));
+}
+
+static int cmp_ratio_desc(const void *a, const void *b) {
+    const double *ra = a;
+    const double *rb = b;
+    // ra[0]: ratio, ra[1]: index (ties broken by increasing index)
+    if (ra[0] != rb[0]) {
+        return ra[0] > rb[0] ? -1 : 1;
+    }
+    return ra[1] < rb[1] ? -1 : (ra[1] > rb[1] ? 1 : 0);
+}
+
+static bool start_sampler_create(StartSampler *sampler,
+                                 const Instance *instance,
+                                 InsHeurNodePair *pairs, int32_t num_pairs) {
+    memset(sampler, 0, sizeof(*sampler));
+    sampler->num_pairs = num_pairs;
+    sampler->pairs = pairs;
+    sampler->priority = malloc(num_pairs * sizeof(*sampler->priority));
+    sampler->min_dist = malloc(num_pairs * sizeof(*sampler->min_dist));
+    sampler->taken = calloc(num_pairs, sizeof(*sampler->taken));
+    double(*ratios)[2] = malloc(num_pairs * sizeof(*ratios));
+
+    if (!sampler->priority || !sampler->min_dist || !sampler->taken ||
+        !ratios) {
+        free(ratios);
+        start_sampler_destroy(sampler);
+        return false;
+    }
+
+    for (int32_t i = 0; i < num_pairs; i++) {
+        int32_t v = pairs[i].v;
+        double profit = instance->profits[v];
+        double demand = MAX(instance->demands[v], 1e-6);
+        ratios[i][0] = isfinite(profit) ? profit / demand : -INFINITY;
+        ratios[i][1] = i;
+        sampler->min_dist[i] = cptp_dist(instance, pairs[i].u, v);
+    }
+
+    qsort(ratios, num_pairs, sizeof(*ratios), cmp_ratio_desc);
 
     // NOTE(dparo):
-    //      A two-opt exchange maintain feasibiliby of the original solution.
-    //      After a two-opt exchange the same set of vertices are visited,
-    //      and therefore capacity constraints remain satisfied.
-    //      On top of that profits do not change.
-    //      The only thing that changes is the cost associated with the
-    //      the travelling distance.
-
-    //
-    // While there are edges crossing (2-opt exchanges are available)
-    //
-    while (true) {
-        double best_delta_cost = -COST_TOLERANCE;
-        int32_t best_a = -1;
-        int32_t best_b = -1;
-
-        //
-        // Scan for the best NodePair to perform the 2-opt exchange
-        //
-        for (int32_t a = 0; a < n; a++) {
-            for (int32_t b = 0; b < n; b++) {
-                if (a == b) {
-                    continue;
-                }
+    //      Rank based, such that the scale of the profits (e.g. duals in
+    //      pricer mode) does not matter. The best ratio gets priority 1.0,
+    //      the worst 0.5: the distance term still dominates.
+    for (int32_t r = 0; r < num_pairs; r++) {
+        int32_t i = (int32_t)ratios[r][1];
+        sampler->priority[i] = 1.0 - 0.5 * (double)r / (double)num_pairs;
+    }
 
-                // Vertices a,b are valid 2opt exchange candidates only if they
-                // are visited in the tour
-                if (solution->tour.comp[a] < 0 || solution->tour.comp[b] < 0) {
-                    continue;
-                }
+    free(ratios);
+    return true;
+}
 
-                int32_t succ_a = solution->tour.succ[a];
-                int32_t succ_b = solution->tour.succ[b];
+/// Selects the next (at most) `max_num_pairs` starts into `out`. Returns the
+/// number of selected starts.
+static int32_t start_sampler_next(StartSampler *sampler,
+                                  const Instance *instance,
+                                  InsHeurNodePair *out, int32_t max_num_pairs) {
+    int32_t cnt = 0;
+
+    while (cnt < max_num_pairs) {
+        int32_t best = -1;
+        double best_score = -INFINITY;
+        for (int32_t i = 0; i < sampler->num_pairs; i++) {
+            double score = sampler->priority[i] * sampler->min_dist[i];
+            if (!sampler->taken[i] && (best < 0 || score > best_score)) {
+                best = i;
+                best_score = score;
+            }
+        }
 
-                assert(succ_a >= 0 && succ_a < n);
-                assert(succ_b >= 0 && succ_b < n);
-                assert(succ_a != succ_b);
+        if (best < 0) {
+            break;
+        }
 
-                // Compute delta_cost
-                double delta_cost = cptp_dist(instance, a, b) +
-                                    cptp_dist(instance, succ_a, succ_b) -
-                                    cptp_dist(instance, a, succ_a) -
-                                    cptp_dist(instance, b, succ_b);
+        sampler->taken[best] = true;
+        out[cnt++] = sampler->pairs[best];
 
-                if (delta_cost < best_delta_cost) {
-                    best_delta_cost = delta_cost;
-                    best_a = a;
-                    best_b = b;
-                }
+        const int32_t v = sampler->pairs[best].v;
+        for (int32_t i = 0; i < sampler->num_pairs; i++) {
+            if (!sampler->taken[i]) {
+                sampler->min_dist[i] =
+                    MIN(sampler->min_dist[i],
+                        cptp_dist(instance, v, sampler->pairs[i].v));
             }
         }
+    }
 
-        if (best_a >= 0) {
-            assert(best_delta_cost < 0.0);
-            assert(best_b >= 0);
+    return cnt;
+}
 
-            // Perform the two-opt exchange and reverse part of the tour
-            twoopt_exchange(solver, instance, &solution->tour, best_a, best_b);
-            solution->primal_bound += best_delta_cost;
-#ifndef NDEBUG
-            validate_primal_solution(instance, solution,
-                              WARM_START_MIN_NUM_CUSTOMERS_SERVED);
-#endif
-        } else {
-            // NOTE(dparo): No more 2-opt exchanges are available
+/// Runs the starts of `round` over the workers, the calling thread acting
+/// as the first one.
+static void run_warm_start_round(WarmStartWorker *workers,
+                                 int32_t num_workers, WarmStartRound *round) {
+    atomic_store(&round->next, 0);
+    num_workers = MAX(1, MIN(num_workers, round->num_pairs));
+
+    int32_t num_spawned = 0;
+    for (int32_t t = 1; t < num_workers; t++) {
+        if (0 != pthread_create(&workers[t].thread, NULL,
+                                warm_start_worker_main, &workers[t])) {
+            // The remaining starts are taken by the running workers
+            log_warn("%s :: pthread_create failed", __func__);
             break;
         }
+        ++num_spawned;
     }
 
-#ifndef NDEBUG
-    validate_primal_solution(instance, solution, WARM_START_MIN_NUM_CUSTOMERS_SERVED);
-#endif
+    warm_start_worker_main(&workers[0]);
+
+    for (int32_t t = 1; t <= num_spawned; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
 }
 
 bool mip_ins_heur_warm_start(Solver *solver, const Instance *instance,
                              bool heur_pricer_mode) {
     bool result = true;
     const int32_t n = instance->num_customers + 1;
+    const int32_t num_workers =
+        MAX(1, solver->data->warm_start_pool.num_threads);
+    const int32_t round_size = num_workers * WARM_START_STARTS_PER_THREAD;
 
     double min_ub_found = INFINITY;
-    Solution solution = solution_create(instance);
-    InsHeurNodePair starting_pair;
+    InsHeurNodePair *pairs = NULL;
+    Solution *best = NULL;
+    LsNeighborLists nl = {0};
+    StartSampler sampler = {0};
+    WarmStartRound round = {0};
+    InsHeurNodePair *round_pairs = malloc(round_size * sizeof(*round_pairs));
+    WarmStartWorker *workers = calloc(num_workers, sizeof(*workers));
+    round.results = calloc(round_size, sizeof(*round.results));
+
+    if (!workers || !round.results || !round_pairs ||
+        !ls_neighbor_lists_create(&nl, instance, WARM_START_NUM_NEIGHBORS)) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        result = false;
+        goto terminate;
+    }
+    mip_add_work(solver->data, (int64_t)n * n);
+
+    for (int32_t t = 0; t < num_workers; t++) {
+        workers[t].solver = solver;
+        workers[t].instance = instance;
+        workers[t].nl = &nl;
+        workers[t].heur_pricer_mode = heur_pricer_mode;
+        workers[t].round = &round;
+        if (!ins_heur_queue_create(&workers[t].queue, instance)) {
+            log_fatal("%s :: Failed memory allocation", __func__);
+            result = false;
+            goto terminate;
+        }
+    }
+    for (int32_t i = 0; i < round_size; i++) {
+        round.results[i] = solution_create(instance);
+    }
 
     //   ((Instance *)instance)->vehicle_cap += instance->vehicle_cap * 1.0;
 
-    starting_pair.u = 0;
-    for (starting_pair.v = 0; starting_pair.v < n; starting_pair.v++) {
-        if (starting_pair.v == starting_pair.u) {
-            continue;
+    for (int32_t v = 0; v < n; v++) {
+        InsHeurNodePair starting_pair = {.u = 0, .v = v};
+        if (v != starting_pair.u &&
+            valid_starting_pair(instance, &starting_pair)) {
+            arrput(pairs, starting_pair);
         }
-        if (valid_starting_pair(instance, &starting_pair)) {
-            ins_heur(instance, &solution, starting_pair);
-            log_info("%s :: ins_heur -- found a solution of cost %f, demand %f",
-                     __func__, solution.primal_bound,
-                     tour_demand(instance, &solution.tour));
-
-            // NOTE(dparo):
-            //       Since 2opt refinements are not cheap, and may cost us
-            //       computation time, try to do them only when absolutely
-            //       necessary. This will keep the main execution path as
-            //       fast as possible
-            if (!heur_pricer_mode ||
-                !is_valid_reduced_cost(solution.primal_bound)) {
-                // Try to improve the solution using 2opt
-                double prev_ub = solution.primal_bound;
-                twoopt_refine(solver, instance, &solution);
-                log_trace("%s :: two opt refine -- Improved solution from %f "
-                          "to %f (%f delta improvement)",
-                          __func__, prev_ub, solution.primal_bound,
-                          solution.primal_bound - prev_ub);
-            }
+    }
 
-            if (!feed_warm_solution(solver, instance, &solution)) {
-                log_fatal("%s :: register_warm_solution_failed", __func__);
-                result = false;
-                goto terminate;
-            }
+    const int32_t num_pairs = (int32_t)arrlen(pairs);
+    const SolverData *data = solver->data;
+    const bool det_budget = data->warm_start_pool.det_budget > 0.0;
+    // NOTE(dparo):
+    //      Diminishing returns: stop when the most recent starts did not
+    //      produce any tour making it into the pool of the best ones.
+    //      Not applied in pricer mode, which has its own termination, nor
+    //      without a budget, where every start runs to completion.
+    const bool stall_stop =
+        !heur_pricer_mode &&
+        (det_budget || isfinite(data->warm_start_pool.time_budget));
+    const int32_t stall_limit = MAX(round_size, num_pairs / 4);
+    int32_t num_stalled = 0;
+    int32_t num_rounds = 0;
+    int32_t num_done = 0;
+
+    if (num_pairs > 0 &&
+        !start_sampler_create(&sampler, instance, pairs, num_pairs)) {
+        log_fatal("%s :: Failed memory allocation", __func__);
+        result = false;
+        goto terminate;
+    }
 
-            // NOTE(dparo):
-            //     Whenever we find a reduced cost tour and we are in pricer
-            //     mode, there's no point in continuining feeding other warm
-            //     start solutions, we've already found what we are looking
-            //     for. Break out of the loop.
+    log_info("%s :: running up to %d starts over %d threads (budget: %f "
+             "secs, %f ticks)",
+             __func__, num_pairs, num_workers,
+             data->warm_start_pool.time_budget,
+             data->warm_start_pool.det_budget);
 
-            min_ub_found = MIN(min_ub_found, solution.primal_bound);
+    const int64_t begin_time = os_get_usecs();
+    const int64_t begin_work = atomic_load(&solver->data->det.work_units);
 
-            if (heur_pricer_mode && is_valid_reduced_cost(min_ub_found)) {
-                log_info("%s :: Found reduced_cost tour (%f), early "
-                         "terminating warm-start feeding\n",
-                         __func__, min_ub_found);
-                break;
+    while (true) {
+        round.pairs = round_pairs;
+        round.num_pairs =
+            start_sampler_next(&sampler, instance, round_pairs, round_size);
+        if (round.num_pairs == 0) {
+            break;
+        }
+        // Each selection scans (and updates) all the candidates
+        mip_add_work(solver->data, (int64_t)round.num_pairs * num_pairs);
+        run_warm_start_round(workers, num_workers, &round);
+        ++num_rounds;
+        num_done += round.num_pairs;
+
+        for (int32_t i = 0; i < round.num_pairs; i++) {
+            Solution *solution = &round.results[i];
+            log_info("%s :: ins_heur + refine -- found a solution of cost %f, "
+                     "demand %f",
+                     __func__, solution->primal_bound,
+                     tour_demand(instance, &solution->tour));
+
+            if (keep_best_tour(&best, data->warm_start_pool.num_tours,
+                               solution)) {
+                num_stalled = 0;
+            } else {
+                ++num_stalled;
             }
+            min_ub_found = MIN(min_ub_found, solution->primal_bound);
+            if (heur_pricer_mode) {
+                mip_pricer_collect_tour(solver->data, &solution->tour,
+                                        solution->primal_bound);
+            }
+        }
+
+        // NOTE(dparo):
+        //     Whenever we find enough reduced cost tours and we are in
+        //     pricer mode, there's no point in continuining with the other
+        //     starts, we've already found what we are looking for.
+        if (heur_pricer_mode &&
+            mip_pricer_is_done(solver->data, min_ub_found)) {
+            log_info("%s :: Found reduced_cost tour (%f), early "
+                     "terminating warm-start feeding\n",
+                     __func__, min_ub_found);
+            break;
+        }
+
+        if (stall_stop && num_stalled >= stall_limit) {
+            log_info("%s :: no improvement in the last %d starts, stopping",
+                     __func__, num_stalled);
+            break;
+        }
+
+        // NOTE(dparo):
+        //      With a deterministic time limit, only the deterministic budget
+        //      is checked, such that the outcome is reproducible.
+        bool out_of_budget = false;
+        if (det_budget) {
+            int64_t work =
+                atomic_load(&solver->data->det.work_units) - begin_work;
+            out_of_budget = (double)work / MIP_WORK_UNITS_PER_TICK >=
+                            data->warm_start_pool.det_budget;
+        } else {
+            out_of_budget = os_get_elapsed_secs(begin_time) >=
+                            data->warm_start_pool.time_budget;
+        }
+        if (out_of_budget) {
+            log_info("%s :: out of budget, stopping", __func__);
+            break;
+        }
+    }
+
+    log_info("%s :: ran %d starts out of %d, keeping %d distinct tours",
+             __func__, num_done, num_pairs, (int32_t)arrlen(best));
+    solver->data->warm_start_pool.num_rounds = num_rounds;
+    solver->data->warm_start_pool.num_starts = num_done;
+    solver->data->warm_start_pool.num_fed = (int32_t)arrlen(best);
+
+    for (ptrdiff_t i = 0; i < arrlen(best); i++) {
+        if (!feed_warm_solution(solver, instance, &best[i])) {
+            log_fatal("%s :: register_warm_solution_failed", __func__);
+            result = false;
+            goto terminate;
         }
     }
 
+    if (!mip_flush_warm_start_pool(solver)) {
+        log_fatal("%s :: mip_flush_warm_start_pool failed", __func__);
+        result = false;
+    }
+
 terminate:
-    solution_destroy(&solution);
+    for (ptrdiff_t i = 0; i < arrlen(best); i++) {
+        tour_destroy(&best[i].tour);
+    }
+    arrfree(best);
+    arrfree(pairs);
+    free(round_pairs);
+    start_sampler_destroy(&sampler);
+    if (round.results) {
+        for (int32_t i = 0; i < round_size; i++) {
+            solution_destroy(&round.results[i]);
+        }
+        free(round.results);
+    }
+    if (workers) {
+        for (int32_t t = 0; t < num_workers; t++) {
+            ins_heur_queue_destroy(&workers[t].queue);
+        }
+        free(workers);
+    }
+    ls_neighbor_lists_destroy(&nl);
+    return result;
+}
+
+bool mip_flush_deferred_warm_starts(Solver *solver, const Instance *instance) {
+    bool result = true;
+    Tour *tours = solver->data->sparse.deferred_warm_starts;
+
+    assert(!solver->data->sparse.enabled || solver->data->sparse.finalized);
+
+    for (ptrdiff_t i = 0; i < arrlen(tours); i++) {
+        Solution solution = {0};
+        solution.tour = tours[i];
+        solution.primal_bound = tour_eval(instance, &tours[i]);
+        solution.dual_bound = -INFINITY;
+
+        if (result && !feed_warm_solution(solver, instance, &solution)) {
+            log_fatal("%s :: feed_warm_solution failed", __func__);
+            result = false;
+        }
+
+        tour_destroy(&tours[i]);
+    }
+
+    arrfree(solver->data->sparse.deferred_warm_starts);
+
+    if (result && !mip_flush_warm_start_pool(solver)) {
+        log_fatal("%s :: mip_flush_warm_start_pool failed", __func__);
+        result = false;
+    }
     return result;
 }
@@ -30,6 +30,11 @@ extern "C" {
 
 bool mip_ins_heur_warm_start(Solver *solver, const Instance *instance,
                              bool pricer_mode_enabled);
+bool mip_flush_deferred_warm_starts(Solver *solver, const Instance *instance);
+
+/// Submits the pool of distinct warm start solutions gathered so far to CPLEX
+/// in a single batch of MIP starts, and empties it.
+bool mip_flush_warm_start_pool(Solver *solver);
 
 #if __cplusplus
 }
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2022 Davide Paro
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// NOTE(dparo):
+//      Benchmarks the neighbor list based 2-opt / Or-opt refinement
+//      (ls_twoopt_oropt()) against the full scan best improvement 2-opt
+//      (ls_twoopt(), same algorithm as the MIP warm start refinement it
+//      replaced) and the Lin-Kernighan style search (ls_lin_kernighan()).
+//      Each instance is given a random, capacity feasible, tour and all
+//      the refinements are applied on a copy of it.
+//      Typical usage:
+//              ls-bench data/CVRP/X/*.vrp
+
+#include <argtable3.h>
+#include "core.h"
+#include "core-utils.h"
+#include "local-search.h"
+#include "parser.h"
+
+enum {
+    MAX_NUMBER_OF_ERRORS_TO_DISPLAY = 16,
+    MAX_NUM_INPUT_FILES = 4096,
+};
+
+typedef struct {
+    int32_t num_neighbors;
+    int32_t seed;
+    bool skip_twoopt;
+} AppCtx;
+
+static void random_feasible_tour(const Instance *instance, Tour *tour) {
+    const int32_t n = instance->num_customers + 1;
+    int32_t *perm = malloc(n * sizeof(*perm));
+    if (!perm) {
+        return;
+    }
+
+    for (int32_t i = 0; i < n; i++) {
+        perm[i] = i;
+    }
+    for (int32_t i = n - 1; i > 1; i--) {
+        int32_t j = 1 + rand() % i;
+        int32_t tmp = perm[i];
+        perm[i] = perm[j];
+        perm[j] = tmp;
+    }
+
+    tour_clear(tour);
+    tour->num_comps = 1;
+    tour->comp[0] = 0;
+
+    int32_t last = 0;
+    double sum_demands = instance->demands[0];
+    for (int32_t k = 1; k < n; k++) {
+        int32_t i = perm[k];
+        if (sum_demands + instance->demands[i] <= instance->vehicle_cap) {
+            sum_demands += instance->demands[i];
+            tour->comp[i] = 0;
+            tour->succ[last] = i;
+            last = i;
+        }
+    }
+    tour->succ[last] = 0;
+
+    free(perm);
+}
+
+static int32_t num_visited(const Instance *instance, const Tour *tour) {
+    int32_t cnt = 0;
+    for (int32_t i = 0; i < instance->num_customers + 1; i++) {
+        cnt += tour->comp[i] == 0;
+    }
+    return cnt;
+}
+
+static bool bench(const char *filepath, const AppCtx *ctx) {
+    Instance instance = parse(filepath);
+    if (instance.num_customers <= 0 || !instance.demands) {
+        fprintf(stderr, "%s: failed to parse\n", filepath);
+        instance_destroy(&instance);
+        return false;
+    }
+
+    Tour initial = tour_create(&instance);
+    Tour tour = {0};
+    LsNeighborLists nl = {0};
+
+    random_feasible_tour(&instance, &initial);
+    const double initial_cost = tour_eval(&instance, &initial);
+
+    int64_t begin = os_get_usecs();
+    if (!ls_neighbor_lists_create(&nl, &instance, ctx->num_neighbors)) {
+        fprintf(stderr, "%s: failed memory allocation\n", filepath);
+        tour_destroy(&initial);
+        instance_destroy(&instance);
+        return false;
+    }
+    const double nl_build_time = os_get_elapsed_secs(begin);
+
+    tour = tour_copy(&initial);
+    int64_t num_evals = 0;
+    begin = os_get_usecs();
+    ls_twoopt_oropt(&instance, &nl, &tour, &num_evals);
+    const double nl_time = os_get_elapsed_secs(begin);
+    const double nl_cost = tour_eval(&instance, &tour);
+    tour_destroy(&tour);
+
+    tour = tour_copy(&initial);
+    begin = os_get_usecs();
+    ls_lin_kernighan(&instance, &nl, &tour, NULL);
+    const double lk_time = os_get_elapsed_secs(begin);
+    const double lk_cost = tour_eval(&instance, &tour);
+    tour_destroy(&tour);
+
+    double twoopt_time = NAN;
+    double twoopt_cost = NAN;
+    if (!ctx->skip_twoopt) {
+        tour = tour_copy(&initial);
+        begin = os_get_usecs();
+        ls_twoopt(&instance, &tour);
+        twoopt_time = os_get_elapsed_secs(begin);
+        twoopt_cost = tour_eval(&instance, &tour);
+        tour_destroy(&tour);
+    }
+
+    printf("%-24s %6d %6d %12.1f | %12.1f %10.4f %10.4f %10lld | %12.1f "
+           "%10.4f | %12.1f %10.4f\n",
+           instance.name ? instance.name : filepath,
+           instance.num_customers + 1, num_visited(&instance, &initial),
+           initial_cost, nl_cost, nl_time, nl_build_time,
+           (long long)num_evals, lk_cost, lk_time, twoopt_cost, twoopt_time);
+
+    ls_neighbor_lists_destroy(&nl);
+    tour_destroy(&initial);
+    instance_destroy(&instance);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    char *progname = argv[0];
+    int exitcode = EXIT_SUCCESS;
+    struct arg_lit *help = arg_lit0(NULL, "help", "print this help and exit");
+
+    struct arg_file *inputs = arg_filen(NULL, NULL, "<file>", 1,
+                                        MAX_NUM_INPUT_FILES,
+                                        "input instance files");
+
+    struct arg_int *num_neighbors =
+        arg_int0("k", "num-neighbors", NULL,
+                 "length of the candidate lists. Default 25");
+
+    struct arg_int *seed =
+        arg_int0("s", "seed", NULL, "seed of the random initial tours");
+
+    struct arg_lit *skip_twoopt =
+        arg_lit0(NULL, "skip-twoopt",
+                 "do not run the full scan 2-opt (slow on large instances)");
+
+    struct arg_end *end = arg_end(MAX_NUMBER_OF_ERRORS_TO_DISPLAY);
+
+    void *argtable[] = {help, inputs, num_neighbors, seed, skip_twoopt, end};
+
+    /* verify the argtable[] entries were allocated successfully */
+    if (arg_nullcheck(argtable) != 0) {
+        printf("%s: insufficient memory\n", progname);
+        exitcode = 1;
+        goto exit;
+    }
+
+    num_neighbors->ival[0] = 25;
+    seed->ival[0] = 0;
+
+    {
+        int nerrors = arg_parse(argc, argv, argtable);
+
+        /* special case: '--help' takes precedence over error reporting */
+        if (help->count > 0) {
+            printf("Usage: %s", progname);
+            arg_print_syntax(stdout, argtable, "\n");
+            arg_print_glossary(stdout, argtable, "  %-32s %s\n");
+            exitcode = 0;
+            goto exit;
+        }
+
+        if (nerrors > 0) {
+            arg_print_errors(stdout, end, progname);
+            exitcode = 1;
+            goto exit;
+        }
+    }
+
+    AppCtx ctx = {.num_neighbors = num_neighbors->ival[0],
+                  .seed = seed->ival[0],
+                  .skip_twoopt = skip_twoopt->count > 0};
+
+    printf("%-24s %6s %6s %12s | %12s %10s %10s %10s | %12s %10s | %12s "
+           "%10s\n",
+           "NAME", "N", "VISIT", "INITIAL", "NL COST", "NL TIME", "NL BUILD",
+           "NL EVALS", "LK COST", "LK TIME", "2OPT COST", "2OPT TIME");
+
+    for (int i = 0; i < inputs->count; i++) {
+        srand((unsigned)ctx.seed);
+        if (!bench(inputs->filename[i], &ctx)) {
+            exitcode = EXIT_FAILURE;
+        }
+    }
+
+exit:
+    arg_freetable(argtable, ARRAY_LEN(argtable));
+    return exitcode;
+}
@@ -206,6 +206,12 @@ typedef struct {
     int32_t max_num_procs;
     char *name;
     double timelimit;
+    /// If > 0, the cptp runs are also limited by this many deterministic
+    /// ticks (see the `DET_TIMELIMIT` param), and their time statistic is
+    /// measured in ticks rather than seconds: unlike the wall clock time, it
+    /// does not depend on `max_num_procs`. The wall clock `timelimit` still
+    /// bounds the runs.
+    double det_timelimit;
     int32_t nseeds;
     char *dirs[BATCH_MAX_NUM_DIRS];
     Filter filter;
@@ -225,6 +231,12 @@ typedef struct {
     PerfTbl perf_tbl;
 } AppCtx;
 
+/// Upper limit of the time statistic of the runs of `batch`
+static inline double get_time_stat_limit(const PerfProfBatch *batch) {
+    return batch->det_timelimit > 0.0 ? batch->det_timelimit
+                                      : batch->timelimit;
+}
+
 static inline double get_extended_timelimit(double timelimit) {
     return ceil(1.05 * timelimit + 2);
 }
@@ -41,7 +41,10 @@ cJSON *load_json(char *filepath) {
     return root;
 }
 
-void parse_cptp_solver_json_dump(PerfProfRun *run, cJSON *root) {
+/// When `use_det_ticks` is set, the time statistic is the deterministic ticks
+/// of the run, rather than its wall clock time.
+void parse_cptp_solver_json_dump(PerfProfRun *run, cJSON *root,
+                                 bool use_det_ticks) {
     cJSON *itm_solve_status = NULL;
     cJSON *itm_timing_info = NULL;
     cJSON *itm_bounds = NULL;
@@ -61,7 +64,8 @@ void parse_cptp_solver_json_dump(PerfProfRun *run, cJSON *root) {
     }
 
     if (itm_timing_info) {
-        itm_took = cJSON_GetObjectItemCaseSensitive(itm_timing_info, "took");
+        itm_took = cJSON_GetObjectItemCaseSensitive(
+            itm_timing_info, use_det_ticks ? "detTicks" : "took");
     }
 
     if (itm_bounds) {
@@ -29,7 +29,8 @@ extern "C" {
 #include <cJSON.h>
 
 cJSON *load_json(char *filepath);
-void parse_cptp_solver_json_dump(PerfProfRun *run, cJSON *root);
+void parse_cptp_solver_json_dump(PerfProfRun *run, cJSON *root,
+                                 bool use_det_ticks);
 void parse_bapcod_solver_json_dump(PerfProfRun *run, cJSON *root);
 
 #if __cplusplus
@@ -55,6 +55,8 @@
 static const Filter DEFAULT_FILTER = ((Filter){NULL, {0, 99999}, {0, 99999}});
 static const PerfProfSolver BAPCOD_SOLVER =
     ((PerfProfSolver){BAPCOD_SOLVER_NAME, {0}});
+static const PerfProfSolver DP_SOLVER =
+    ((PerfProfSolver){"DP ng-route Pricer", {"-S", "dp"}});
 
 // NOTE(dparo): Global variable.
 //    Unfortunately this global variable is necessary since some Unix APIs
@@ -68,7 +70,7 @@ make_invalidated_solver_solution(PerfProfBatch *batch) {
     solution.status = SOLVE_STATUS_ERR;
     solution.stats[PERFPROF_STAT_KIND_PRIMAL_BOUND] =
         CRASHED_SOLVER_DEFAULT_COST_VAL;
-    solution.stats[PERFPROF_STAT_KIND_TIME] = 2 * batch->timelimit;
+    solution.stats[PERFPROF_STAT_KIND_TIME] = 2 * get_time_stat_limit(batch);
     return solution;
 }
 
@@ -169,7 +171,8 @@ update_perf_tbl_with_cptp_json_perf_data(AppCtx *ctx,
     if (handle->json_output_path[0] != '\0') {
         cJSON *root = load_json(handle->json_output_path);
         if (root) {
-            parse_cptp_solver_json_dump(&run, root);
+            parse_cptp_solver_json_dump(
+                &run, root, ctx->current_batch->det_timelimit > 0.0);
             cJSON_Delete(root);
         }
     }
@@ -277,6 +280,17 @@ PerfProfRunHandle *new_perfprof_run_handle(const Hash *exe_hash,
     return handle;
 }
 
+/// Solvers not selecting another cptp solver (`-S`) run the MIP one
+static bool is_mip_solver(const PerfProfSolver *solver) {
+    for (int32_t i = 0; solver->args[i] != NULL; i++) {
+        if (0 == strcmp(solver->args[i], "-S") ||
+            0 == strcmp(solver->args[i], "--solver")) {
+            return 0 == strcmp(solver->args[i + 1], "mip");
+        }
+    }
+    return true;
+}
+
 static void handle_cptp_solver_run(AppCtx *ctx, PerfProfSolver *solver,
                                    PerfProfInput *input) {
     if (ctx->should_terminate) {
@@ -302,6 +316,10 @@ static void handle_cptp_solver_run(AppCtx *ctx, PerfProfSolver *solver,
     char seed_str[128];
     snprintf_safe(seed_str, ARRAY_LEN(seed_str), "%d", input->seed);
 
+    char det_timelimit[128];
+    snprintf_safe(det_timelimit, ARRAY_LEN(det_timelimit), "-DDET_TIMELIMIT=%g",
+                  ctx->current_batch->det_timelimit);
+
     args[argidx++] = "timeout";
     args[argidx++] = "-k";
     args[argidx++] = killafter;
@@ -312,8 +330,13 @@ static void handle_cptp_solver_run(AppCtx *ctx, PerfProfSolver *solver,
     args[argidx++] = timelimit;
     args[argidx++] = "--seed";
     args[argidx++] = seed_str;
-    args[argidx++] = "-DHEUR_PRICER_MODE=0";
-    args[argidx++] = "-DAPPLY_UPPER_CUTOFF=1";
+    if (is_mip_solver(solver)) {
+        args[argidx++] = "-DHEUR_PRICER_MODE=0";
+        args[argidx++] = "-DAPPLY_UPPER_CUTOFF=1";
+        if (ctx->current_batch->det_timelimit > 0.0) {
+            args[argidx++] = det_timelimit;
+        }
+    }
 
     for (int32_t i = 0; solver->args[i] != NULL; i++) {
         args[argidx++] = solver->args[i];
@@ -576,7 +599,8 @@ int32_t define_batches(PerfProfBatch *batches) {
     }
 
     //
-    // Compare the BAC MIP Pricer (AFL) against BapCod with DEFAULT_TIME_LIMIT
+    // Compare the BAC MIP Pricer (AFL) against BapCod and the in-tree DP
+    // pricer with DEFAULT_TIME_LIMIT
     //
     {
         for (int32_t fidx = 0; fidx < ARRAY_LEN_i32(FAMILIES); fidx++) {
@@ -612,6 +636,7 @@ int32_t define_batches(PerfProfBatch *batches) {
                         (PerfProfSolver){"BAC MIP Pricer (AFL)",
                                          {"-DAMORTIZED_FRACTIONAL_LABELING=1"}};
                     batches[num_batches].solvers[num_solvers++] = BAPCOD_SOLVER;
+                    batches[num_batches].solvers[num_solvers++] = DP_SOLVER;
                 }
                 ++num_batches;
             }
@@ -706,6 +731,10 @@ static void main_loop(AppCtx *ctx) {
         printf("            Batch max num concurrent procs: %d\n",
                batches[bidx].max_num_procs);
         printf("            Batch timelimit: %g\n", batches[bidx].timelimit);
+        if (batches[bidx].det_timelimit > 0.0) {
+            printf("            Batch det timelimit: %g ticks\n",
+                   batches[bidx].det_timelimit);
+        }
         printf("            Batch num seeds: %d\n", batches[bidx].nseeds);
         printf("            Batch dirs: [");
         for (int32_t dir_idx = 0;
@@ -79,7 +79,7 @@ static void invoke_plot_pyscript(const PerfProfBatch *batch,
     }
     case VALUE_PROCESSING_KIND_TIME: {
         snprintf_safe(x_raw_pper_limit, ARRAY_LEN(x_raw_pper_limit), "%g",
-                      batch->timelimit);
+                      get_time_stat_limit(batch));
 
         args[argidx++] = "--x-max";
         args[argidx++] = x_max;
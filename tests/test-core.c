@@ -34,6 +34,8 @@
 #include "parser.h"
 #include "core.h"
 #include "core-utils.h"
+#include "local-search.h"
+#include "instances.h"
 
 TEST tour_creation(void) {
     const char *filepath = "data/ESPPRC - Test Instances/vrps/E-n101-k14_a.vrp";
@@ -59,6 +61,180 @@ TEST calling_sxpos(void) {
     PASS();
 }
 
+TEST calling_sxpos_large_n(void) {
+    // 64 bit arithmetic is required for n > 46340
+    const int32_t n = 100000;
+    ASSERT(hm_nentries(n) == (int64_t)4999950000LL);
+    ASSERT(fm_nentries(n) == (int64_t)9999900000LL);
+    ASSERT(sxpos(n, 0, 1) == 0);
+    ASSERT(sxpos(n, n - 2, n - 1) == hm_nentries(n) - 1);
+    ASSERT(sxpos(n, n - 3, n - 2) == hm_nentries(n) - 3);
+    PASS();
+}
+
+TEST local_search_improves_tour(void) {
+    const char *filepath = "data/ESPPRC - Test Instances/vrps/E-n101-k14_a.vrp";
+    Instance instance = parse(filepath);
+    const int32_t n = instance.num_customers + 1;
+    Tour tour = tour_create(&instance);
+
+    // Visit the customers in index order, up to the vehicle capacity
+    double *score = malloc(n * sizeof(*score));
+    for (int32_t i = 0; i < n; i++) {
+        score[i] = (double)(n - i);
+    }
+    ls_build_tour_from_scores(&instance, &tour, score, 0.0);
+    const double initial_cost = tour_eval(&instance, &tour);
+    ASSERT(isfinite(initial_cost));
+
+    double delta = ls_optimize(&instance, &tour, 3);
+    double cost = tour_eval(&instance, &tour);
+    ASSERT(isfinite(cost));
+    ASSERT(delta <= 0.0);
+    ASSERT(feq(cost, initial_cost + delta, 1e-6));
+
+    // A local optimum stays put
+    ASSERT(feq(ls_optimize(&instance, &tour, 3), 0.0, 1e-9));
+
+    free(score);
+    tour_destroy(&tour);
+    instance_destroy(&instance);
+    PASS();
+}
+
+/// Number of random starting tours for each configuration of
+/// check_local_search_move()
+#define LS_NUM_RANDOM_TOURS (20)
+
+/// A local search over the candidate lists, with the signature of
+/// ls_twoopt_oropt()
+typedef double LsMoveFn(const Instance *instance, const LsNeighborLists *nl,
+                        Tour *tour, int64_t *num_evals);
+
+/// `min_num_visited` of the customer selection local searches
+#define LS_MIN_NUM_VISITED (3)
+
+static double add_drop_swap(const Instance *instance,
+                            const LsNeighborLists *nl, Tour *tour,
+                            int64_t *num_evals) {
+    return ls_add_drop_swap(instance, nl, tour, LS_MIN_NUM_VISITED, num_evals);
+}
+
+/// Checks the tour `after` returned by a local search, which started from a
+/// tour `before` of cost `before_cost` and returned `delta`.
+TEST check_local_search_result(const Instance *instance, const Tour *before,
+                               double before_cost, Tour *after, double delta,
+                               bool keeps_visited) {
+    const int32_t n = instance->num_customers + 1;
+
+    // A single cycle through the depot
+    ASSERT_EQ(1, after->num_comps);
+    ASSERT_EQ(0, after->comp[0]);
+    int32_t num_visited_before = 0;
+    int32_t num_visited = 0;
+    for (int32_t i = 0; i < n; i++) {
+        num_visited_before += before->comp[i] == 0;
+        num_visited += after->comp[i] == 0;
+        if (keeps_visited) {
+            ASSERT_EQ(before->comp[i] == 0, after->comp[i] == 0);
+        }
+    }
+    int32_t len = 0;
+    int32_t curr = 0;
+    do {
+        ASSERT_EQ(0, after->comp[curr]);
+        curr = after->succ[curr];
+        ASSERT(curr >= 0 && curr < n);
+        ++len;
+    } while (curr != 0 && len <= n);
+    ASSERT_EQ(0, curr);
+    ASSERT_EQ(num_visited, len);
+
+    ASSERT(tour_demand(instance, after) <= instance->vehicle_cap + 1e-6);
+    // NOTE: Tours shorter than LS_MIN_NUM_VISITED are grown even at a loss
+    if (num_visited_before >= LS_MIN_NUM_VISITED) {
+        ASSERT(delta <= 0.0);
+    }
+    ASSERT(feq(before_cost + delta, tour_eval(instance, after), 1e-6));
+    PASS();
+}
+
+/// Checks `move` on random capacity feasible tours of the test instances,
+/// under every distance rounding, with a few vehicle capacities and candidate
+/// list sizes. When `keeps_visited` is set, the move must not change the set
+/// of visited customers.
+TEST check_local_search_move(LsMoveFn *move, bool keeps_visited) {
+    const DistanceRounding roundings[] = {CPTP_DIST_ROUND, CPTP_DIST_NO_ROUND,
+                                          CPTP_DIST_CEIL, CPTP_DIST_FLOOR};
+    const double cap_factors[] = {0.25, 1.0, 4.0};
+    const int32_t nl_sizes[] = {5, 25};
+    uint64_t rng = UINT64_C(0x9E3779B97F4A7C15);
+
+    for (int32_t i = 0; i < ARRAY_LEN_i32(G_TEST_INSTANCES); i++) {
+        Instance instance = parse(G_TEST_INSTANCES[i].filepath);
+        ASSERT(is_valid_instance(&instance));
+        const int32_t n = instance.num_customers + 1;
+        const double vehicle_cap = instance.vehicle_cap;
+        double *score = malloc(n * sizeof(*score));
+        Tour before = tour_create(&instance);
+        Tour after = tour_create(&instance);
+        ASSERT(score && tour_is_valid(&before) && tour_is_valid(&after));
+
+        for (int32_t k = 0; k < ARRAY_LEN_i32(nl_sizes); k++) {
+            LsNeighborLists nl = {0};
+            ASSERT(ls_neighbor_lists_create(&nl, &instance, nl_sizes[k]));
+
+            for (int32_t r = 0; r < ARRAY_LEN_i32(roundings); r++) {
+                instance.rounding_strat = roundings[r];
+                for (int32_t c = 0; c < ARRAY_LEN_i32(cap_factors); c++) {
+                    instance.vehicle_cap = cap_factors[c] * vehicle_cap;
+
+                    for (int32_t t = 0; t < LS_NUM_RANDOM_TOURS; t++) {
+                        // Random customers, visited in a random order
+                        for (int32_t j = 0; j < n; j++) {
+                            score[j] = (double)(ls_rand(&rng) % 1000);
+                        }
+                        double threshold = (double)(ls_rand(&rng) % 1000);
+                        ls_build_tour_from_scores(&instance, &before, score,
+                                                  threshold);
+                        ls_perturb_segments(&instance, &before, n, &rng);
+                        double before_cost = tour_eval(&instance, &before);
+                        ASSERT(isfinite(before_cost));
+
+                        tour_copy_into(&after, &before);
+                        double delta = move(&instance, &nl, &after, NULL);
+                        CHECK_CALL(check_local_search_result(
+                            &instance, &before, before_cost, &after, delta,
+                            keeps_visited));
+                    }
+                }
+            }
+            ls_neighbor_lists_destroy(&nl);
+        }
+
+        free(score);
+        tour_destroy(&before);
+        tour_destroy(&after);
+        instance_destroy(&instance);
+    }
+    PASS();
+}
+
+TEST twoopt_oropt_deltas(void) {
+    CHECK_CALL(check_local_search_move(ls_twoopt_oropt, true));
+    PASS();
+}
+
+TEST lin_kernighan_deltas(void) {
+    CHECK_CALL(check_local_search_move(ls_lin_kernighan, true));
+    PASS();
+}
+
+TEST add_drop_swap_deltas(void) {
+    CHECK_CALL(check_local_search_move(add_drop_swap, false));
+    PASS();
+}
+
 /* Add all the definitions that need to be in the test runner's main file. */
 GREATEST_MAIN_DEFS();
 
@@ -68,6 +244,11 @@ int main(int argc, char **argv) {
     /* If tests are run outside of a suite, a default suite is used. */
     RUN_TEST(tour_creation);
     RUN_TEST(calling_sxpos);
+    RUN_TEST(calling_sxpos_large_n);
+    RUN_TEST(local_search_improves_tour);
+    RUN_TEST(twoopt_oropt_deltas);
+    RUN_TEST(lin_kernighan_deltas);
+    RUN_TEST(add_drop_swap_deltas);
 
     GREATEST_MAIN_END(); /* display results */
 }
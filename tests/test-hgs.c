@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2022 Davide Paro
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <greatest.h>
+
+#include "parser.h"
+#include "solvers.h"
+#include "core.h"
+#include "core-utils.h"
+#include "instances.h"
+#include "solvers/hgs/hgs.h"
+
+#define TIMELIMIT ((double)(60.0))
+#define RANDOMSEED ((int32_t)1)
+
+TEST solve_test_instances(void) {
+    for (int32_t i = 0; i < ARRAY_LEN_i32(G_TEST_INSTANCES); i++) {
+        Instance instance = parse(G_TEST_INSTANCES[i].filepath);
+        ASSERT(is_valid_instance(&instance));
+        SolverParams params = {0};
+        solver_params_append(&params, "NUM_THREADS", "2");
+        solver_params_append(&params, "MAX_ITERATIONS_NO_IMPROVEMENT", "500");
+        solver_params_append(&params, "MIGRATION_PERIOD", "50");
+        Solution solution = solution_create(&instance);
+        SolveStatus status = cptp_solve(&instance, "hgs", &params, &solution,
+                                        TIMELIMIT, RANDOMSEED);
+        ASSERT(BOOL(status & SOLVE_STATUS_PRIMAL_SOLUTION_AVAIL) &&
+               !BOOL(status & SOLVE_STATUS_CLOSED_PROBLEM) &&
+               !BOOL(status & SOLVE_STATUS_ERR));
+        ASSERT(solution.tour.num_comps == 1);
+        ASSERT(feq(solution.primal_bound,
+                   tour_eval(&instance, &solution.tour), 1e-6));
+
+        // A heuristic tour cannot beat the optimum
+        printf("%s :: Found primal_bound = %.17g,     Best primal_bound = "
+               "%.17g\n",
+               G_TEST_INSTANCES[i].filepath, solution.primal_bound,
+               G_TEST_INSTANCES[i].best_primal);
+        ASSERT(solution.primal_bound >= G_TEST_INSTANCES[i].best_primal - 1e-3);
+
+        instance_destroy(&instance);
+        solution_destroy(&solution);
+    }
+    PASS();
+}
+
+TEST collects_multiple_tours(void) {
+    const int32_t num_tours = 5;
+    Instance instance = parse(G_TEST_INSTANCES[0].filepath);
+    ASSERT(is_valid_instance(&instance));
+    SolverParams params = {0};
+    solver_params_append(&params, "NUM_THREADS", "2");
+    solver_params_append(&params, "MAX_ITERATIONS_NO_IMPROVEMENT", "200");
+    solver_params_append(&params, "PRICER_NUM_TOURS", "5");
+    Solution solution = solution_create(&instance);
+    SolveStatus status = cptp_solve(&instance, "hgs", &params, &solution,
+                                    TIMELIMIT, RANDOMSEED);
+    ASSERT(BOOL(status & SOLVE_STATUS_PRIMAL_SOLUTION_AVAIL));
+
+    const ptrdiff_t len = arrlen(solution.tours);
+    ASSERT(len >= 1 && len <= num_tours);
+    ASSERT(arrlen(solution.tours_cost) == len);
+    ASSERT(feq(solution.tours_cost[0], solution.primal_bound, 1e-6));
+    for (ptrdiff_t i = 0; i < len; i++) {
+        ASSERT(solution.tours[i].num_comps == 1);
+        ASSERT(is_valid_reduced_cost(solution.tours_cost[i]));
+        ASSERT(feq(solution.tours_cost[i],
+                   tour_eval(&instance, &solution.tours[i]), 1e-6));
+        if (i > 0) {
+            ASSERT(solution.tours_cost[i - 1] <= solution.tours_cost[i]);
+        }
+        for (ptrdiff_t j = 0; j < i; j++) {
+            ASSERT(!tour_same_route(&solution.tours[i], &solution.tours[j]));
+        }
+    }
+
+    instance_destroy(&instance);
+    solution_destroy(&solution);
+    PASS();
+}
+
+/// Solves the first test instance with a `hgs` solver created from `params`,
+/// and returns the statistics of the solve
+static HgsStats solve_for_stats(SolverParams *params, SolveStatus *status) {
+    HgsStats stats = {0};
+    Instance instance = parse(G_TEST_INSTANCES[0].filepath);
+    SolverTypedParams tparams = {0};
+    *status = SOLVE_STATUS_ERR;
+
+    if (is_valid_instance(&instance) &&
+        resolve_params(params, &HGS_SOLVER_DESCRIPTOR, &tparams)) {
+        Solver solver =
+            hgs_solver_create(&instance, &tparams, TIMELIMIT, RANDOMSEED);
+        if (solver.solve) {
+            Solution solution = solution_create(&instance);
+            *status =
+                solver.solve(&solver, &instance, &solution, os_get_usecs());
+            if (solution.tour.num_comps != 1 ||
+                !feq(solution.primal_bound,
+                     tour_eval(&instance, &solution.tour), 1e-6)) {
+                *status |= SOLVE_STATUS_ERR;
+            }
+            stats = hgs_solver_stats(&solver);
+            solution_destroy(&solution);
+            solver.destroy(&solver);
+        }
+    }
+
+    solver_typed_params_destroy(&tparams);
+    instance_destroy(&instance);
+    return stats;
+}
+
+TEST islands_exchange_tours(void) {
+    SolverParams params = {0};
+    solver_params_append(&params, "NUM_THREADS", "4");
+    solver_params_append(&params, "MAX_ITERATIONS_NO_IMPROVEMENT", "300");
+    solver_params_append(&params, "MIGRATION_PERIOD", "10");
+    SolveStatus status = SOLVE_STATUS_NULL;
+    HgsStats stats = solve_for_stats(&params, &status);
+    ASSERT(BOOL(status & SOLVE_STATUS_PRIMAL_SOLUTION_AVAIL) &&
+           !BOOL(status & SOLVE_STATUS_ERR));
+
+    // NOTE:
+    //      Each island runs at least MAX_ITERATIONS_NO_IMPROVEMENT
+    //      iterations, hence 30 migrations, and the first migration of an
+    //      island always publishes its best tour: the islands import the
+    //      tours of the previous island of the ring.
+    ASSERT_EQ(4, stats.num_islands);
+    ASSERT(stats.num_iters >= 4 * 300);
+    ASSERT(stats.num_migrations > 0);
+    PASS();
+}
+
+TEST migrations_disabled(void) {
+    SolveStatus status = SOLVE_STATUS_NULL;
+
+    SolverParams params = {0};
+    solver_params_append(&params, "NUM_THREADS", "4");
+    solver_params_append(&params, "MAX_ITERATIONS_NO_IMPROVEMENT", "200");
+    solver_params_append(&params, "MIGRATION_PERIOD", "0");
+    HgsStats stats = solve_for_stats(&params, &status);
+    ASSERT(BOOL(status & SOLVE_STATUS_PRIMAL_SOLUTION_AVAIL) &&
+           !BOOL(status & SOLVE_STATUS_ERR));
+    ASSERT_EQ(4, stats.num_islands);
+    ASSERT_EQ(0, stats.num_migrations);
+
+    // A single island has no neighbor to import from
+    SolverParams single_params = {0};
+    solver_params_append(&single_params, "NUM_THREADS", "1");
+    solver_params_append(&single_params, "MAX_ITERATIONS_NO_IMPROVEMENT",
+                         "200");
+    solver_params_append(&single_params, "MIGRATION_PERIOD", "10");
+    stats = solve_for_stats(&single_params, &status);
+    ASSERT(BOOL(status & SOLVE_STATUS_PRIMAL_SOLUTION_AVAIL) &&
+           !BOOL(status & SOLVE_STATUS_ERR));
+    ASSERT_EQ(1, stats.num_islands);
+    ASSERT(stats.num_iters >= 200);
+    ASSERT_EQ(0, stats.num_migrations);
+    PASS();
+}
+
+GREATEST_MAIN_DEFS();
+
+int main(int argc, char **argv) {
+    log_set_level(LOG_WARN);
+
+    GREATEST_MAIN_BEGIN(); /* command-line arguments, initialization. */
+    RUN_TEST(solve_test_instances);
+    RUN_TEST(collects_multiple_tours);
+    RUN_TEST(islands_exchange_tours);
+    RUN_TEST(migrations_disabled);
+    GREATEST_MAIN_END(); /* display results */
+}
@@ -37,10 +37,39 @@
 #include "core.h"
 #include "core-utils.h"
 #include "instances.h"
+#include "solvers/mip/cuts.h"
 
 #define TIMELIMIT ((double)(600.0))
 #define RANDOMSEED ((int32_t)0)
 
+/// A `mip` solver kept alive after its solve, such that the tests can inspect
+/// the state it is left in
+typedef struct {
+    SolverTypedParams tparams;
+    Solver solver;
+} MipTestSolver;
+
+static SolveStatus mip_test_solve(MipTestSolver *s, const Instance *instance,
+                                  const SolverParams *params,
+                                  Solution *solution) {
+    memset(s, 0, sizeof(*s));
+    if (!resolve_params(params, &MIP_SOLVER_DESCRIPTOR, &s->tparams)) {
+        return SOLVE_STATUS_ERR;
+    }
+    s->solver = mip_solver_create(instance, &s->tparams, TIMELIMIT, RANDOMSEED);
+    if (!s->solver.solve) {
+        return SOLVE_STATUS_ERR;
+    }
+    return s->solver.solve(&s->solver, instance, solution, os_get_usecs());
+}
+
+static void mip_test_solver_destroy(MipTestSolver *s) {
+    if (s->solver.destroy) {
+        s->solver.destroy(&s->solver);
+    }
+    solver_typed_params_destroy(&s->tparams);
+}
+
 TEST creation(void) {
     const char *filepath = G_TEST_INSTANCES[0].filepath;
     Instance instance = parse(filepath);
@@ -60,6 +89,79 @@ TEST creation(void) {
     PASS();
 }
 
+TEST comb_separation(void) {
+    Instance instance = parse(G_TEST_INSTANCES[0].filepath);
+    ASSERT(is_valid_instance(&instance));
+    const int32_t n = instance.num_customers + 1;
+    SolverParams params = {0};
+    SolverTypedParams tparams = {0};
+    ASSERT(resolve_params(&params, &MIP_SOLVER_DESCRIPTOR, &tparams));
+    Solver solver =
+        mip_solver_create(&instance, &tparams, TIMELIMIT, RANDOMSEED);
+    ASSERT(solver.data);
+
+    // NOTE:
+    //      Fractional 2-matching violating the comb having handle {1, 2, 3}
+    //      and teeth {1, 4}, {2, 5}, {3, 6}: the edges of the triangles
+    //      {1, 2, 3} and {4, 5, 6} take 0.5, the teeth take 1.0.
+    //      The comb reads x(delta(H) \ T) - x(T) >= 1 - |T|, i.e.
+    //      0 - 3 >= -2.
+    double *vstar = calloc(solver.data->num_mip_vars, sizeof(*vstar));
+    ASSERT(vstar);
+    const int32_t triangles[2][3] = {{1, 2, 3}, {4, 5, 6}};
+    for (int32_t t = 0; t < 2; t++) {
+        for (int32_t a = 0; a < 3; a++) {
+            int32_t i = triangles[t][a], j = triangles[t][(a + 1) % 3];
+            vstar[get_x_mip_var_idx(&instance, i, j)] = 0.5;
+        }
+    }
+    for (int32_t a = 0; a < 3; a++) {
+        vstar[get_x_mip_var_idx(&instance, triangles[0][a],
+                                triangles[1][a])] = 1.0;
+    }
+    for (int32_t i = 1; i <= 6; i++) {
+        vstar[get_y_mip_var_idx(&instance, i)] = 1.0;
+    }
+
+    MaxFlowResult mf = {0};
+    max_flow_result_create(&mf, n);
+    for (int32_t i = 0; i < n; i++) {
+        mf.colors[i] = (i >= 1 && i <= 3) ? WHITE : BLACK;
+    }
+
+    CutPool pool = {0};
+    CutSeparationFunctor functor = {0};
+    functor.instance = &instance;
+    functor.solver = &solver;
+    functor.internal.cut_pool = &pool;
+    functor.ctx = CUT_COMB_IFACE.activate(&instance, &solver);
+    ASSERT(functor.ctx);
+    ASSERT(CUT_COMB_IFACE.fractional_sep(&functor, 0.0, vstar, &mf, 0.0));
+
+    ASSERT_EQ(1, arrlen(pool.rhs));
+    ASSERT_EQ('G', pool.sense[0]);
+    ASSERT(feq(pool.rhs[0], -2.0, 1e-9));
+
+    double lhs = 0.0;
+    int32_t num_teeth = 0;
+    for (ptrdiff_t k = 0; k < arrlen(pool.rmatind); k++) {
+        lhs += pool.rmatval[k] * vstar[pool.rmatind[k]];
+        num_teeth += pool.rmatval[k] < 0.0;
+    }
+    ASSERT_EQ(3, num_teeth);
+    ASSERT(feq(lhs, -3.0, 1e-9));
+    ASSERT(lhs < pool.rhs[0]);
+
+    CUT_COMB_IFACE.deactivate(functor.ctx);
+    cut_pool_destroy(&pool);
+    max_flow_result_destroy(&mf);
+    free(vstar);
+    solver.destroy(&solver);
+    instance_destroy(&instance);
+    solver_typed_params_destroy(&tparams);
+    PASS();
+}
+
 TEST solve_test_instances(void) {
     for (int32_t i = 0; i < ARRAY_LEN_i32(G_TEST_INSTANCES); i++) {
 
@@ -92,6 +194,558 @@ TEST solve_test_instances(void) {
     PASS();
 }
 
+/// Solves `instance` with a `mip` solver kept alive in `s`, and checks that the
+/// problem is closed with a single tour of cost `best_primal`
+TEST check_closed_solve(MipTestSolver *s, const Instance *instance,
+                        const SolverParams *params, Solution *solution,
+                        double best_primal) {
+    SolveStatus status = mip_test_solve(s, instance, params, solution);
+    ASSERT(status != 0 && BOOL(status & SOLVE_STATUS_CLOSED_PROBLEM) &&
+           BOOL(status & SOLVE_STATUS_PRIMAL_SOLUTION_AVAIL) &&
+           !BOOL(status & SOLVE_STATUS_ERR));
+    ASSERT(solution->tour.num_comps == 1);
+    ASSERT(solution->tour.num_customers == instance->num_customers);
+    ASSERT(feq(tour_eval(instance, &solution->tour), solution->primal_bound,
+               1e-3));
+    ASSERT(feq(solution->primal_bound, best_primal, 1e-3));
+    PASS();
+}
+
+TEST check_sparse_formulation(MipTestSolver *s, const Instance *instance,
+                              const Solution *solution) {
+    // NOTE:
+    //      The pricing may add columns, but the finalized formulation stays
+    //      smaller than the dense one, and contains the optimal tour.
+    const SolverData *data = s->solver.data;
+    ASSERT(data->sparse.enabled && data->sparse.finalized);
+    ASSERT(data->sparse.num_cols < (CPXDIM)data->num_mip_vars);
+    for (int32_t i = 0; i < instance->num_customers + 1; i++) {
+        if (solution->tour.comp[i] != 0) {
+            continue;
+        }
+        size_t x = get_x_mip_var_idx(instance, i, solution->tour.succ[i]);
+        size_t y = get_y_mip_var_idx(instance, i);
+        ASSERT(mip_var_to_col(data, x) >= 0);
+        ASSERT(mip_var_to_col(data, y) >= 0);
+    }
+    PASS();
+}
+
+TEST check_reduced_cost_fixing(MipTestSolver *s, const Instance *instance,
+                               const Solution *solution) {
+    // NOTE:
+    //      A column is fixed only if it cannot be part of a solution better
+    //      than the incumbent: the optimal tour uses none of them.
+    const SolverData *data = s->solver.data;
+    ASSERT(data->rcfix.num_fixed > 0);
+    ASSERT(data->rcfix.num_presolve_fixed <= data->rcfix.num_fixed);
+    for (CPXDIM k = 0; k < data->rcfix.num_fixed; k++) {
+        ASSERT(data->rcfix.is_fixed[data->rcfix.fixed_cols[k]]);
+    }
+    for (int32_t i = 0; i < instance->num_customers + 1; i++) {
+        if (solution->tour.comp[i] != 0) {
+            continue;
+        }
+        size_t x = get_x_mip_var_idx(instance, i, solution->tour.succ[i]);
+        size_t y = get_y_mip_var_idx(instance, i);
+        ASSERT(!data->rcfix.is_fixed[mip_var_to_col(data, x)]);
+        ASSERT(!data->rcfix.is_fixed[mip_var_to_col(data, y)]);
+    }
+    PASS();
+}
+
+TEST check_custom_branching(MipTestSolver *s, const Instance *instance,
+                            const Solution *solution) {
+    const SolverData *data = s->solver.data;
+    const int64_t num_cardinality =
+        atomic_load(&data->branching.num_cardinality_branches);
+    const int64_t num_pseudocost =
+        atomic_load(&data->branching.num_pseudocost_branches);
+    ASSERT(num_cardinality + num_pseudocost > 0);
+    // No pending branch outlives the solve
+    ASSERT_EQ(0, hmlenu(data->branching.pending));
+    PASS();
+}
+
+TEST check_relaxation_heuristic(MipTestSolver *s, const Instance *instance,
+                                const Solution *solution) {
+    ASSERT(atomic_load(&s->solver.data->relax_heur_num_posted) > 0);
+    PASS();
+}
+
+TEST check_heur_thread(MipTestSolver *s, const Instance *instance,
+                       const Solution *solution) {
+    const SolverData *data = s->solver.data;
+    ASSERT(data->heur_thread.enabled && !data->heur_thread.running);
+    ASSERT(data->heur_thread.num_iters > 0);
+    ASSERT(data->heur_thread.num_published > 0);
+    PASS();
+}
+
+TEST check_det_timelimit(MipTestSolver *s, const Instance *instance,
+                         const Solution *solution) {
+    ASSERT(solution->det_ticks > 0.0);
+    PASS();
+}
+
+TEST check_warm_start_effort(MipTestSolver *s, const Instance *instance,
+                             const Solution *solution) {
+    // The warm start tours are submitted with the requested effort
+    const SolverData *data = s->solver.data;
+    const int32_t effort =
+        solver_params_get_int32(&s->tparams, "WARM_START_EFFORT");
+    ASSERT_EQ(effort, data->warm_start_pool.effort);
+    ASSERT(data->warm_start_pool.num_fed > 0);
+    ASSERT(isfinite(data->warm_start_primal_bound));
+    PASS();
+}
+
+typedef enum greatest_test_res MipTestCheckFn(MipTestSolver *s,
+                                              const Instance *instance,
+                                              const Solution *solution);
+
+/// A combination of `mip` params, solved on every test instance by
+/// solve_param_combinations()
+typedef struct {
+    /// Pairs of param name and value, NULL terminated
+    char *params[8];
+    /// Checks on the state the solver is left in, besides the optimum
+    MipTestCheckFn *check;
+} MipTestCombination;
+
+static const MipTestCombination MIP_TEST_COMBINATIONS[] = {
+    {{"SPARSE_FORMULATION_KNN", "5", "NUM_THREADS", "1"},
+     check_sparse_formulation},
+    {{"REDUCED_COST_FIXING", "true"}, check_reduced_cost_fixing},
+    // NOTE: Without the fractional cuts the root relaxation is weak, and
+    //       the problem cannot be closed without branching
+    {{"BRANCHING_STRATEGY", "3", "DISABLE_FRACTIONAL_SEPARATION", "true",
+      "NUM_THREADS", "1"},
+     check_custom_branching},
+    // NOTE: Without the warm start, the first relaxation point of the root is
+    //       rounded while CPLEX has no incumbent yet
+    {{"RELAXATION_HEUR_FREQ", "1", "INS_HEUR_WARM_START", "false"},
+     check_relaxation_heuristic},
+    {{"PRESOLVE", "true"}, NULL},
+    // NOTE: Without the warm start, the first tour found by the thread
+    //       improves the empty shared incumbent
+    {{"HEUR_THREAD", "true", "REDUCED_COST_FIXING", "true",
+      "INS_HEUR_WARM_START", "false"},
+     check_heur_thread},
+    {{"DET_TIMELIMIT", "1e6"}, check_det_timelimit},
+    {{"WARM_START_EFFORT", "0"}, check_warm_start_effort},
+    {{"WARM_START_EFFORT", "5"}, check_warm_start_effort},
+};
+
+TEST solve_param_combinations(void) {
+    for (int32_t i = 0; i < ARRAY_LEN_i32(G_TEST_INSTANCES); i++) {
+        Instance instance = parse(G_TEST_INSTANCES[i].filepath);
+        ASSERT(is_valid_instance(&instance));
+
+        for (int32_t c = 0; c < ARRAY_LEN_i32(MIP_TEST_COMBINATIONS); c++) {
+            const MipTestCombination *comb = &MIP_TEST_COMBINATIONS[c];
+            SolverParams params = {0};
+            for (int32_t k = 0; comb->params[k]; k += 2) {
+                solver_params_append(&params, comb->params[k],
+                                     comb->params[k + 1]);
+            }
+
+            printf("%s :: solving with %s = %s\n",
+                   G_TEST_INSTANCES[i].filepath, comb->params[0],
+                   comb->params[1]);
+
+            Solution solution = solution_create(&instance);
+            MipTestSolver s;
+            CHECK_CALL(check_closed_solve(&s, &instance, &params, &solution,
+                                          G_TEST_INSTANCES[i].best_primal));
+            if (comb->check) {
+                CHECK_CALL(comb->check(&s, &instance, &solution));
+            }
+            mip_test_solver_destroy(&s);
+            solution_destroy(&solution);
+        }
+
+        instance_destroy(&instance);
+    }
+    PASS();
+}
+
+TEST solve_lp_bound_mode(void) {
+    Instance instance = parse(G_TEST_INSTANCES[0].filepath);
+    ASSERT(is_valid_instance(&instance));
+    SolverParams params = {0};
+    solver_params_append(&params, "LP_BOUND_MODE", "true");
+    Solution solution = solution_create(&instance);
+    SolveStatus status = cptp_solve(&instance, "mip", &params, &solution,
+                                    TIMELIMIT, RANDOMSEED);
+    ASSERT(status != 0 && !BOOL(status & SOLVE_STATUS_ERR));
+    ASSERT(solution.dual_bound <= G_TEST_INSTANCES[0].best_primal + 1e-3);
+
+    double *bounds = solution.relaxation.round_bounds;
+    ASSERT(arrlen(bounds) > 0);
+    for (ptrdiff_t k = 1; k < arrlen(bounds); k++) {
+        ASSERT(bounds[k] >= bounds[k - 1] - 1e-6);
+    }
+    ASSERT(arrlen(solution.relaxation.node_values) ==
+           instance.num_customers + 1);
+    instance_destroy(&instance);
+    solution_destroy(&solution);
+    PASS();
+}
+
+TEST solve_with_portfolio(void) {
+    Instance instance = parse(G_TEST_INSTANCES[0].filepath);
+    ASSERT(is_valid_instance(&instance));
+    SolverParams params = {0};
+    solver_params_append(&params, "PORTFOLIO_SIZE", "2");
+    Solution solution = solution_create(&instance);
+    MipTestSolver s;
+    CHECK_CALL(check_closed_solve(&s, &instance, &params, &solution,
+                                  G_TEST_INSTANCES[0].best_primal));
+
+    // NOTE:
+    //      Both members share the incumbent of the portfolio. On such a small
+    //      instance a member may close the problem before publishing anything,
+    //      but a published tour cannot beat the optimum.
+    const SolverData *data = s.solver.data;
+    ASSERT_EQ(2, data->portfolio.num_members);
+    const MipSharedIncumbent *shared = data->portfolio.shared;
+    for (int32_t k = 0; k < data->portfolio.num_members; k++) {
+        const SolverData *member = data->portfolio.members[k].data;
+        ASSERT_EQ(shared, member->portfolio.shared);
+        ASSERT_EQ(k, member->portfolio.member_id);
+    }
+    if (isfinite(shared->cost)) {
+        ASSERT(shared->owner >= 0 && shared->owner < 2);
+        ASSERT(shared->cost >= G_TEST_INSTANCES[0].best_primal - 1e-3);
+    }
+
+    mip_test_solver_destroy(&s);
+    instance_destroy(&instance);
+    solution_destroy(&solution);
+    PASS();
+}
+
+TEST solve_with_multithreaded_warm_start(void) {
+    Instance instance = parse(G_TEST_INSTANCES[0].filepath);
+    ASSERT(is_valid_instance(&instance));
+    SolverParams params = {0};
+    solver_params_append(&params, "NUM_THREADS", "3");
+    solver_params_append(&params, "WARM_START_NUM_TOURS", "1");
+    Solution solution = solution_create(&instance);
+    MipTestSolver s;
+    CHECK_CALL(check_closed_solve(&s, &instance, &params, &solution,
+                                  G_TEST_INSTANCES[0].best_primal));
+
+    const SolverData *data = s.solver.data;
+    ASSERT_EQ(MIN(3, data->numcores), data->warm_start_pool.num_threads);
+    // Only the best of the distinct tours found by the starts is fed
+    ASSERT(data->warm_start_pool.num_starts > 1);
+    ASSERT_EQ(1, data->warm_start_pool.num_fed);
+    ASSERT(isfinite(data->warm_start_primal_bound));
+    ASSERT(data->warm_start_primal_bound >=
+           G_TEST_INSTANCES[0].best_primal - 1e-3);
+
+    mip_test_solver_destroy(&s);
+    instance_destroy(&instance);
+    solution_destroy(&solution);
+    PASS();
+}
+
+TEST solve_with_budgeted_warm_start(void) {
+    Instance instance = parse(G_TEST_INSTANCES[0].filepath);
+    ASSERT(is_valid_instance(&instance));
+    SolverParams params = {0};
+    solver_params_append(&params, "NUM_THREADS", "2");
+    // NOTE: A single round of starts is run
+    solver_params_append(&params, "WARM_START_MAX_TIME", "1e-9");
+    Solution solution = solution_create(&instance);
+    MipTestSolver s;
+    CHECK_CALL(check_closed_solve(&s, &instance, &params, &solution,
+                                  G_TEST_INSTANCES[0].best_primal));
+
+    const SolverData *data = s.solver.data;
+    ASSERT(feq(data->warm_start_pool.time_budget, 1e-9, 1e-12));
+    ASSERT_EQ(1, data->warm_start_pool.num_rounds);
+    ASSERT(data->warm_start_pool.num_starts > 0);
+    ASSERT(data->warm_start_pool.num_fed > 0);
+    const int32_t budgeted_num_starts = data->warm_start_pool.num_starts;
+    mip_test_solver_destroy(&s);
+
+    // Without the budget the starts go on up until they stop improving (the
+    // warm start runs at the creation of the solver)
+    SolverParams unbounded_params = {0};
+    solver_params_append(&unbounded_params, "NUM_THREADS", "2");
+    SolverTypedParams tparams = {0};
+    ASSERT(resolve_params(&unbounded_params, &MIP_SOLVER_DESCRIPTOR,
+                          &tparams));
+    Solver solver =
+        mip_solver_create(&instance, &tparams, TIMELIMIT, RANDOMSEED);
+    ASSERT(solver.data);
+    ASSERT(solver.data->warm_start_pool.num_rounds > 1);
+    ASSERT(solver.data->warm_start_pool.num_starts > budgeted_num_starts);
+    solver.destroy(&solver);
+    solver_typed_params_destroy(&tparams);
+
+    instance_destroy(&instance);
+    solution_destroy(&solution);
+    PASS();
+}
+
+TEST session_profit_updates(void) {
+    Instance instance = parse(G_TEST_INSTANCES[0].filepath);
+    ASSERT(is_valid_instance(&instance));
+    const int32_t n = instance.num_customers + 1;
+    SolverParams params = {0};
+    solver_params_append(&params, "NUM_THREADS", "1");
+
+    CptpSession *session =
+        cptp_session_create(&instance, "mip", &params, TIMELIMIT, RANDOMSEED);
+    ASSERT(session);
+
+    Solution solution = solution_create(&instance);
+    SolveStatus status = cptp_session_solve(session, &solution);
+    ASSERT(BOOL(status & SOLVE_STATUS_CLOSED_PROBLEM));
+    ASSERT(feq(solution.primal_bound, G_TEST_INSTANCES[0].best_primal, 1e-3));
+
+    // Halve the profits, and compare against a solver built from scratch
+    for (int32_t i = 0; i < n; i++) {
+        instance.profits[i] *= 0.5;
+    }
+
+    Solution expected = solution_create(&instance);
+    status = cptp_solve(&instance, "mip", &params, &expected, TIMELIMIT,
+                        RANDOMSEED);
+    ASSERT(BOOL(status & SOLVE_STATUS_CLOSED_PROBLEM));
+
+    ASSERT(cptp_session_update_profits(session, instance.profits));
+    status = cptp_session_solve(session, &solution);
+    ASSERT(BOOL(status & SOLVE_STATUS_CLOSED_PROBLEM) &&
+           !BOOL(status & SOLVE_STATUS_ERR));
+    ASSERT(solution.tour.num_comps == 1);
+    ASSERT(feq(solution.primal_bound, expected.primal_bound, 1e-3));
+
+    cptp_session_destroy(session);
+    instance_destroy(&instance);
+    solution_destroy(&solution);
+    solution_destroy(&expected);
+    PASS();
+}
+
+TEST session_sparse_profit_updates(void) {
+    Instance instance = parse(G_TEST_INSTANCES[0].filepath);
+    ASSERT(is_valid_instance(&instance));
+    const int32_t n = instance.num_customers + 1;
+    const double scales[] = {0.5, 3.0, 1.5};
+    SolverParams params = {0};
+    solver_params_append(&params, "SPARSE_FORMULATION_KNN", "3");
+    solver_params_append(&params, "NUM_THREADS", "1");
+
+    CptpSession *session =
+        cptp_session_create(&instance, "mip", &params, TIMELIMIT, RANDOMSEED);
+    ASSERT(session);
+
+    Solution solution = solution_create(&instance);
+    SolveStatus status = cptp_session_solve(session, &solution);
+    ASSERT(BOOL(status & SOLVE_STATUS_CLOSED_PROBLEM));
+    ASSERT(feq(solution.primal_bound, G_TEST_INSTANCES[0].best_primal, 1e-3));
+
+    // NOTE:
+    //      Every update adds back the pruned edges, while the user cut pool
+    //      holds the cuts separated by the previous solves: they must not cut
+    //      off the tours using the new edges.
+    for (int32_t k = 0; k < ARRAY_LEN_i32(scales); k++) {
+        for (int32_t i = 0; i < n; i++) {
+            instance.profits[i] *= scales[k];
+        }
+
+        Solution expected = solution_create(&instance);
+        status = cptp_solve(&instance, "mip", &params, &expected, TIMELIMIT,
+                            RANDOMSEED);
+        ASSERT(BOOL(status & SOLVE_STATUS_CLOSED_PROBLEM));
+
+        ASSERT(cptp_session_update_profits(session, instance.profits));
+        status = cptp_session_solve(session, &solution);
+        ASSERT(BOOL(status & SOLVE_STATUS_CLOSED_PROBLEM) &&
+               !BOOL(status & SOLVE_STATUS_ERR));
+        ASSERT(feq(solution.primal_bound, expected.primal_bound, 1e-3));
+        solution_destroy(&expected);
+    }
+
+    cptp_session_destroy(session);
+    instance_destroy(&instance);
+    solution_destroy(&solution);
+    PASS();
+}
+
+/// Whether the (single component) `tour` traverses the edge `{i, j}`
+static bool tour_uses_edge(const Tour *tour, int32_t i, int32_t j) {
+    return tour->comp[i] == 0 && tour->comp[j] == 0 &&
+           (tour->succ[i] == j || tour->succ[j] == i);
+}
+
+TEST session_edge_fixings(void) {
+    Instance instance = parse(G_TEST_INSTANCES[0].filepath);
+    ASSERT(is_valid_instance(&instance));
+    const int32_t n = instance.num_customers + 1;
+    SolverParams params = {0};
+    solver_params_append(&params, "NUM_THREADS", "1");
+
+    CptpSession *session =
+        cptp_session_create(&instance, "mip", &params, TIMELIMIT, RANDOMSEED);
+    ASSERT(session);
+
+    Solution solution = solution_create(&instance);
+    SolveStatus status = cptp_session_solve(session, &solution);
+    ASSERT(BOOL(status & SOLVE_STATUS_CLOSED_PROBLEM));
+    ASSERT(solution.tour.num_comps == 1);
+    const double optimum = solution.primal_bound;
+
+    // Forbid the first edge of the optimal tour leaving the depot
+    const int32_t succ = solution.tour.succ[0];
+    ASSERT(cptp_session_push_edge_fixing(session, 0, succ,
+                                         EDGE_FIXING_FORBIDDEN));
+    status = cptp_session_solve(session, &solution);
+    ASSERT(BOOL(status & SOLVE_STATUS_CLOSED_PROBLEM) &&
+           BOOL(status & SOLVE_STATUS_PRIMAL_SOLUTION_AVAIL) &&
+           !BOOL(status & SOLVE_STATUS_ERR));
+    ASSERT(solution.tour.num_comps == 1);
+    ASSERT(!tour_uses_edge(&solution.tour, 0, succ));
+    ASSERT(solution.primal_bound >= optimum - 1e-3);
+    const double forbidden_optimum = solution.primal_bound;
+
+    // On top of it, force an edge from the depot which is not used yet
+    int32_t other = -1;
+    for (int32_t j = 1; j < n && other < 0; j++) {
+        if (j != succ && !tour_uses_edge(&solution.tour, 0, j) &&
+            instance.demands[0] + instance.demands[j] <=
+                instance.vehicle_cap) {
+            other = j;
+        }
+    }
+    ASSERT(other > 0);
+    ASSERT(cptp_session_push_edge_fixing(session, 0, other,
+                                         EDGE_FIXING_FORCED));
+    status = cptp_session_solve(session, &solution);
+    ASSERT(BOOL(status & SOLVE_STATUS_CLOSED_PROBLEM) &&
+           BOOL(status & SOLVE_STATUS_PRIMAL_SOLUTION_AVAIL) &&
+           !BOOL(status & SOLVE_STATUS_ERR));
+    ASSERT(solution.tour.num_comps == 1);
+    ASSERT(tour_uses_edge(&solution.tour, 0, other));
+    ASSERT(!tour_uses_edge(&solution.tour, 0, succ));
+    ASSERT(solution.primal_bound >= forbidden_optimum - 1e-3);
+    ASSERT(feq(tour_eval(&instance, &solution.tour), solution.primal_bound,
+               1e-3));
+
+    // Undoing the fixings restores the optimum
+    ASSERT(cptp_session_pop_edge_fixing(session));
+    ASSERT(cptp_session_pop_edge_fixing(session));
+    ASSERT(!cptp_session_pop_edge_fixing(session));
+    status = cptp_session_solve(session, &solution);
+    ASSERT(BOOL(status & SOLVE_STATUS_CLOSED_PROBLEM) &&
+           !BOOL(status & SOLVE_STATUS_ERR));
+    ASSERT(feq(solution.primal_bound, optimum, 1e-3));
+
+    cptp_session_destroy(session);
+    instance_destroy(&instance);
+    solution_destroy(&solution);
+    PASS();
+}
+
+TEST session_sparse_forced_edge(void) {
+    Instance instance = parse(G_TEST_INSTANCES[0].filepath);
+    ASSERT(is_valid_instance(&instance));
+    const int32_t n = instance.num_customers + 1;
+    SolverParams params = {0};
+    solver_params_append(&params, "SPARSE_FORMULATION_KNN", "3");
+    solver_params_append(&params, "NUM_THREADS", "1");
+
+    CptpSession *session =
+        cptp_session_create(&instance, "mip", &params, TIMELIMIT, RANDOMSEED);
+    ASSERT(session);
+
+    Solution solution = solution_create(&instance);
+    SolveStatus status = cptp_session_solve(session, &solution);
+    ASSERT(BOOL(status & SOLVE_STATUS_CLOSED_PROBLEM));
+    const double optimum = solution.primal_bound;
+
+    // The farthest pair of customers fitting in the vehicle is pruned by the
+    // sparse formulation
+    int32_t fi = -1, fj = -1;
+    for (int32_t i = 1; i < n; i++) {
+        for (int32_t j = i + 1; j < n; j++) {
+            if (instance.demands[0] + instance.demands[i] +
+                        instance.demands[j] <=
+                    instance.vehicle_cap &&
+                (fi < 0 ||
+                 cptp_dist(&instance, i, j) > cptp_dist(&instance, fi, fj))) {
+                fi = i;
+                fj = j;
+            }
+        }
+    }
+    ASSERT(fi > 0);
+
+    // NOTE:
+    //      Forcing the edge prices its column back in, after the first solve
+    //      filled the user cut pool
+    ASSERT(cptp_session_push_edge_fixing(session, fi, fj,
+                                         EDGE_FIXING_FORCED));
+    status = cptp_session_solve(session, &solution);
+    ASSERT(BOOL(status & SOLVE_STATUS_CLOSED_PROBLEM) &&
+           BOOL(status & SOLVE_STATUS_PRIMAL_SOLUTION_AVAIL) &&
+           !BOOL(status & SOLVE_STATUS_ERR));
+    ASSERT(solution.tour.num_comps == 1);
+    ASSERT(tour_uses_edge(&solution.tour, fi, fj));
+    ASSERT(solution.primal_bound >= optimum - 1e-3);
+    ASSERT(feq(tour_eval(&instance, &solution.tour), solution.primal_bound,
+               1e-3));
+
+    ASSERT(cptp_session_pop_edge_fixing(session));
+    status = cptp_session_solve(session, &solution);
+    ASSERT(BOOL(status & SOLVE_STATUS_CLOSED_PROBLEM) &&
+           !BOOL(status & SOLVE_STATUS_ERR));
+    ASSERT(feq(solution.primal_bound, optimum, 1e-3));
+
+    cptp_session_destroy(session);
+    instance_destroy(&instance);
+    solution_destroy(&solution);
+    PASS();
+}
+
+TEST pricer_collects_multiple_tours(void) {
+    const int32_t num_tours = 5;
+    Instance instance = parse(G_TEST_INSTANCES[0].filepath);
+    ASSERT(is_valid_instance(&instance));
+    SolverParams params = {0};
+    solver_params_append(&params, "HEUR_PRICER_MODE", "true");
+    solver_params_append(&params, "PRICER_NUM_TOURS", "5");
+    Solution solution = solution_create(&instance);
+    SolveStatus status = cptp_solve(&instance, "mip", &params, &solution,
+                                    TIMELIMIT, RANDOMSEED);
+    ASSERT(!BOOL(status & SOLVE_STATUS_ERR));
+
+    const ptrdiff_t len = arrlen(solution.tours);
+    ASSERT(len >= 1 && len <= num_tours);
+    ASSERT(arrlen(solution.tours_cost) == len);
+    for (ptrdiff_t i = 0; i < len; i++) {
+        ASSERT(solution.tours[i].num_comps == 1);
+        ASSERT(is_valid_reduced_cost(solution.tours_cost[i]));
+        ASSERT(feq(solution.tours_cost[i],
+                   tour_eval(&instance, &solution.tours[i]), 1e-3));
+        if (i > 0) {
+            ASSERT(solution.tours_cost[i - 1] <= solution.tours_cost[i]);
+        }
+        for (ptrdiff_t j = 0; j < i; j++) {
+            ASSERT(!tour_same_route(&solution.tours[i], &solution.tours[j]));
+        }
+    }
+
+    instance_destroy(&instance);
+    solution_destroy(&solution);
+    PASS();
+}
+
 #endif
 
 GREATEST_MAIN_DEFS();
@@ -102,7 +756,18 @@ int main(int argc, char **argv) {
     GREATEST_MAIN_BEGIN(); /* command-line arguments, initialization. */
 #if COMPILED_WITH_CPLEX
     RUN_TEST(creation);
+    RUN_TEST(comb_separation);
     RUN_TEST(solve_test_instances);
+    RUN_TEST(solve_param_combinations);
+    RUN_TEST(solve_lp_bound_mode);
+    RUN_TEST(solve_with_portfolio);
+    RUN_TEST(solve_with_multithreaded_warm_start);
+    RUN_TEST(solve_with_budgeted_warm_start);
+    RUN_TEST(session_profit_updates);
+    RUN_TEST(session_sparse_profit_updates);
+    RUN_TEST(session_edge_fixings);
+    RUN_TEST(session_sparse_forced_edge);
+    RUN_TEST(pricer_collects_multiple_tours);
 #endif
     GREATEST_MAIN_END(); /* display results */
 }